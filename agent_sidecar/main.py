@@ -52,6 +52,13 @@ SEARCH_MASTERCLASSES_TOOL = {
                     "description": "Один из: adults, kids, families, teens, corporate, date_couple, hobbyists, professionals - только если пользователь явно про аудиторию.",
                 },
                 "tags": {"type": "string", "description": "Доп. теги через запятую (как в additional_tags в БД). Без городов."},
+                "q": {
+                    "type": "string",
+                    "description": (
+                        'Свободный текст для полнотекстового поиска по названию, описанию, организатору и тегам '
+                        '(например "гончарный круг"), если запрос не ложится на category/tags. Без городов.'
+                    ),
+                },
                 "format": {
                     "type": "string",
                     "description": "Только если пользователь **сам** сказал online или offline. Не спрашивай про формат; иначе опусти.",
@@ -72,11 +79,10 @@ SEARCH_MASTERCLASSES_TOOL = {
                 "min_price": {"type": "number", "description": "Минимальная цена (руб)."},
                 "max_price": {"type": "number", "description": "Максимальная цена (руб)."},
                 "min_rating": {"type": "number", "description": "Минимальный рейтинг."},
-                "exclude_ids": {"type": "string", "description": "ID уже показанных мастер-классов через запятую."},
                 "sort_order": {
                     "type": "string",
-                    "enum": ["date_asc", "date_desc"],
-                    "description": "Сортировка по дате проведения; при фильтре по датам обычно date_asc.",
+                    "enum": ["date_asc", "date_desc", "price_asc", "price_desc", "rating_desc", "popular"],
+                    "description": "Сортировка по дате проведения; при фильтре по датам обычно date_asc. price_asc/price_desc — по цене, rating_desc — сначала с высоким рейтингом, popular — самые популярные (по избранному) ближайшие события.",
                 },
             },
             "required": [],
@@ -147,7 +153,7 @@ SYSTEM_PROMPT = """Ты помощник по подбору мастер-кла
 - Контакты и способ записи выводи **только** если пользователь **отдельно** спросил про запись, телефон, сайт, Telegram, VK (см. блок "Контакты" ниже).
 
 Запрещено в ответе пользователю: теги вроде [search_masterclasses], любой сырой JSON целиком (в том числе массивы с фигурными скобками), пустые служебные фразы на английском в русскоязычном диалоге, а также оформление текста разметкой (см. блок "Текст для пользователя" выше). Список мастер-классов - только связным текстом на русском.
-Если просят "ещё" / "другие" - снова вызови инструмент; sidecar сам добавит в exclude_ids id уже показанных в этом чате вариантов, чтобы не повторять их.
+Если просят "ещё" / "другие" - снова вызови инструмент; sidecar сам исключит уже показанные в этом чате варианты, чтобы не повторять их.
 
 === Контакты и запись (важно) ===
 В каждой записи массива **masterclasses** в JSON ответа инструмента уже есть: **website**, **organizer**, **location**, **contact_tg**, **contact_vk**, **contact_phone** (часть полей может быть пустой строкой - тогда так и скажи по этому полю).
@@ -180,11 +186,22 @@ def _is_blank_query_value(v: Any) -> bool:
     return s.lower() in ("none", "null", "undefined")
 
 
+MCLIST_TIMEOUT_S = 30.0
+
+
 def call_mclist(params: dict[str, Any]) -> dict[str, Any]:
     query = {k: v for k, v in params.items() if not _is_blank_query_value(v)}
+    if "seen_token" in params:
+        # Пустой seen_token - просьба завести новый seen-set.
+        query["seen_token"] = params["seen_token"] or ""
     try:
-        with httpx.Client(timeout=30.0) as client:
-            r = client.get(f"{BACKEND_URL}/mclist", params=query)
+        with httpx.Client(timeout=MCLIST_TIMEOUT_S) as client:
+            # Бэкенд не держит запрос в БД дольше, чем мы готовы ждать.
+            r = client.get(
+                f"{BACKEND_URL}/mclist",
+                params=query,
+                headers={"X-Request-Timeout-Ms": str(int(MCLIST_TIMEOUT_S * 1000))},
+            )
             r.raise_for_status()
             return r.json()
     except httpx.HTTPError as e:
@@ -323,7 +340,7 @@ def _sanitize_search_masterclasses_args(args: dict[str, Any]) -> dict[str, Any]:
             out[key] = val
 
     # Strings.
-    for key in ("category", "audience", "tags", "format", "company", "exclude_ids"):
+    for key in ("category", "audience", "tags", "q", "format", "company", "exclude_ids"):
         val = _to_str(work.get(key))
         if val is not None:
             out[key] = val
@@ -341,7 +358,7 @@ def _sanitize_search_masterclasses_args(args: dict[str, Any]) -> dict[str, Any]:
 
     # Sort order (enum).
     so = _to_str(work.get("sort_order"))
-    if so in ("date_asc", "date_desc"):
+    if so in ("date_asc", "date_desc", "price_asc", "price_desc", "rating_desc", "popular"):
         out["sort_order"] = so
 
     return out
@@ -636,8 +653,21 @@ def _apply_exclude_ids_from_history(
     args: dict[str, Any],
     messages: list[dict],
     client_shown_ids: list[int] | None = None,
+    seen_token: str | None = None,
 ) -> None:
-    """Union exclude_ids: model + ids from tool JSON in this request + client echo (cross-request)."""
+    """Exclude already shown rows via the backend seen-set.
+
+    With a seen_token from an earlier /mclist response only the token is sent: the
+    backend already holds every id it returned under it, so the request does not grow
+    with the chat. Without one (first search, or a client that only echoes
+    shown_masterclass_ids) an empty token asks for a new set, and the ids from history
+    + client echo are sent once in exclude_ids to seed it.
+    """
+    args["seen_token"] = seen_token or ""
+    if seen_token:
+        # Показанное уже в seen-set; ids от модели только раздували бы запрос.
+        args.pop("exclude_ids", None)
+        return
     shown = set(_collect_shown_masterclass_ids(messages))
     if client_shown_ids:
         for x in client_shown_ids:
@@ -663,7 +693,7 @@ def _apply_exclude_ids_from_history(
     merged = existing | shown
     args["exclude_ids"] = ",".join(str(i) for i in sorted(merged))
     logger.info(
-        "exclude_ids: merged %d ids from history+client (total excluded: %d)",
+        "exclude_ids: seeding a new seen-set with %d ids from history+client (total excluded: %d)",
         len(shown),
         len(merged),
     )
@@ -1026,17 +1056,30 @@ _REJECT_FAKE_LISTINGS = (
 )
 
 
+class SeenToken:
+    """seen_token of the conversation: the client echoes it like shown_masterclass_ids,
+    and every search in the chat updates it from the /mclist response."""
+
+    def __init__(self, value: str | None = None) -> None:
+        self.value = value or None
+
+
 def run_chat_with_tools(
     messages: list[dict],
     api_key: str,
     model_uri: str,
     client_shown_ids: list[int] | None = None,
+    seen_token: SeenToken | None = None,
 ) -> tuple[str, list[dict], list[int], list[dict[str, Any]]]:
     """Call Yandex completion API with tools; on tool_calls execute and loop until text reply.
 
     client_shown_ids: ids from previous POST /chat responses (Flutter echoes shown_masterclass_ids);
-    merged into exclude_ids so "ещё" does not repeat rows.
+    they seed the backend seen-set when the chat has no seen_token yet.
+    seen_token: the conversation's /mclist seen_token; updated in place after each search,
+    so "ещё" does not repeat rows without resending them.
     """
+    if seen_token is None:
+        seen_token = SeenToken()
     headers = {"Authorization": f"Api-Key {api_key}", "Content-Type": "application/json"}
     full_messages: list[dict] = [{"role": "system", "content": _system_prompt_with_calendar()}] + list(messages)
     for m in full_messages:
@@ -1144,8 +1187,12 @@ def run_chat_with_tools(
             args = _apply_unanswered_clarification_filters(full_messages, args)
             args = get_mappings().apply_optional_decline_override(last_u, args)
             args = get_mappings().apply_broad_search_override(last_u, args)
-            _apply_exclude_ids_from_history(args, full_messages, client_shown_ids)
+            _apply_exclude_ids_from_history(args, full_messages, client_shown_ids, seen_token.value)
             result_data = call_mclist_with_fallback(args, last_user_message=last_u)
+            # Токен - не для модели: она могла бы вставить его в фильтры.
+            token = result_data.pop("seen_token", None) if isinstance(result_data, dict) else None
+            if isinstance(token, str) and token:
+                seen_token.value = token
             result_data = _reuse_previous_tool_results_if_contact_followup(
                 full_messages, last_u, result_data
             )
@@ -1186,7 +1233,10 @@ def run_chat_with_tools(
 
 
 def run_chat(
-    messages: list[dict], api_key: str, client_shown_ids: list[int] | None = None
+    messages: list[dict],
+    api_key: str,
+    client_shown_ids: list[int] | None = None,
+    seen_token: SeenToken | None = None,
 ) -> tuple[str, list[int], list[dict[str, Any]]]:
     if YANDEX_MODEL_URI:
         model_uri = YANDEX_MODEL_URI
@@ -1199,7 +1249,9 @@ def run_chat(
             list(client_shown_ids or []),
             [],
         )
-    reply, _fm, shown, previews = run_chat_with_tools(messages, api_key, model_uri, client_shown_ids)
+    reply, _fm, shown, previews = run_chat_with_tools(
+        messages, api_key, model_uri, client_shown_ids, seen_token
+    )
     return reply, shown, previews
 
 
@@ -1210,12 +1262,14 @@ class ChatRequest(BaseModel):
     message: str
     messages: list[dict] = Field(default_factory=list)
     shown_masterclass_ids: list[int] = Field(default_factory=list)
+    seen_token: str | None = None
 
 
 class ChatResponse(BaseModel):
     reply: str
     shown_masterclass_ids: list[int] = Field(default_factory=list)
     masterclasses_preview: list[dict[str, Any]] = Field(default_factory=list)
+    seen_token: str | None = None
 
 
 @app.get("/health")
@@ -1234,8 +1288,11 @@ def chat(req: ChatRequest):
         raise HTTPException(status_code=503, detail="YANDEX_AI_API_KEY not set")
     messages = list(req.messages)
     messages.append({"role": "user", "content": req.message})
+    seen_token = SeenToken(req.seen_token)
     try:
-        reply, shown, previews = run_chat(messages, YANDEX_API_KEY, req.shown_masterclass_ids)
+        reply, shown, previews = run_chat(
+            messages, YANDEX_API_KEY, req.shown_masterclass_ids, seen_token
+        )
     except Exception:
         logger.exception("POST /chat failed")
         reply = (
@@ -1246,11 +1303,13 @@ def chat(req: ChatRequest):
             reply=reply,
             shown_masterclass_ids=list(req.shown_masterclass_ids),
             masterclasses_preview=[],
+            seen_token=seen_token.value,
         )
     return ChatResponse(
         reply=reply,
         shown_masterclass_ids=shown,
         masterclasses_preview=previews,
+        seen_token=seen_token.value,
     )
 
 
@@ -2,6 +2,7 @@ import 'package:dio/dio.dart';
 
 import 'api_base_url_stub.dart' if (dart.library.io) 'api_base_url_io.dart'
     as api_base_url;
+import 'session_storage.dart';
 
 /// База API: см. [api_base_url.getApiBaseUrl]; переопределение - `--dart-define=API_HOST` / `API_PORT`.
 const _apiHost = String.fromEnvironment('API_HOST', defaultValue: '');
@@ -24,7 +25,18 @@ class ApiClient {
             'Content-Type': 'application/json',
             'User-Agent': 'MasterclassesApp/1.0',
           },
-        ));
+        )) {
+    // /user/* и /userdelete без токена отвечают 401.
+    dio.interceptors.add(InterceptorsWrapper(
+      onRequest: (options, handler) async {
+        final token = await SessionStorage.getSessionToken();
+        if (token != null) {
+          options.headers['Authorization'] = 'Bearer $token';
+        }
+        handler.next(options);
+      },
+    ));
+  }
 
   static String _resolvedBaseUrl() {
     if (_apiHost.isNotEmpty) {
@@ -6,6 +6,7 @@ class SessionStorage {
   SessionStorage._();
 
   static const String _userIdKey = 'user_id';
+  static const String _sessionTokenKey = 'session_token';
   static const String _savedPhoneKey = 'saved_login_phone';
   static const String _savedPasswordKey = 'saved_login_password';
   static const String _needsPostRegistrationFeedFiltersKey =
@@ -33,9 +34,25 @@ class SessionStorage {
     await prefs.setString(_userIdKey, s);
   }
 
+  /// Токен сессии из /login или /register; уходит в `Authorization: Bearer`.
+  static Future<String?> getSessionToken() async {
+    final prefs = await SharedPreferences.getInstance();
+    final v = prefs.getString(_sessionTokenKey);
+    return v == null || v.isEmpty ? null : v;
+  }
+
+  static Future<void> saveSessionToken(Object? raw) async {
+    if (raw == null) return;
+    final s = raw.toString();
+    if (s.isEmpty) return;
+    final prefs = await SharedPreferences.getInstance();
+    await prefs.setString(_sessionTokenKey, s);
+  }
+
   static Future<void> clear() async {
     final prefs = await SharedPreferences.getInstance();
     await prefs.remove(_userIdKey);
+    await prefs.remove(_sessionTokenKey);
     await prefs.remove(_savedPhoneKey);
     await prefs.remove(_savedPasswordKey);
     await prefs.remove(_needsPostRegistrationFeedFiltersKey);
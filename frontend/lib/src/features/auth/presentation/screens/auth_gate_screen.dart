@@ -2,7 +2,7 @@ import 'package:flutter/material.dart';
 import 'package:go_router/go_router.dart';
 import '../../../../core/session_storage.dart';
 
-/// Старт приложения: без user_id -> /start; иначе при незавершённом пост-регистрационном туториале -> /tutorial, иначе -> /home.
+/// Старт приложения: без user_id или токена сессии (вход старой версией) -> /start; иначе при незавершённом пост-регистрационном туториале -> /tutorial, иначе -> /home.
 class AuthGateScreen extends StatefulWidget {
   const AuthGateScreen({super.key});
 
@@ -19,8 +19,9 @@ class _AuthGateScreenState extends State<AuthGateScreen> {
 
   Future<void> _redirect() async {
     final userId = await SessionStorage.getUserId();
+    final token = await SessionStorage.getSessionToken();
     if (!mounted) return;
-    if (userId != null) {
+    if (userId != null && token != null) {
       if (await SessionStorage.awaitingPostTutorialFeedFilterPrompt()) {
         if (!mounted) return;
         context.go('/tutorial');
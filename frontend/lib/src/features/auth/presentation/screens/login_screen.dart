@@ -74,6 +74,7 @@ class _LoginScreenState extends State<LoginScreen> {
       final userId = response['user_id'];
       if (userId != null) {
         await SessionStorage.saveUserId(userId);
+        await SessionStorage.saveSessionToken(response['token']);
         await SessionStorage.saveLoginCredentials(
           _phoneController.text,
           _passwordController.text,
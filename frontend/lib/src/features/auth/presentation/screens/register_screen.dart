@@ -105,6 +105,7 @@ class _RegisterScreenState extends State<RegisterScreen> {
       final userId = response['user_id'];
       if (userId != null) {
         await SessionStorage.saveUserId(userId);
+        await SessionStorage.saveSessionToken(response['token']);
         await SessionStorage.saveLoginCredentials(
           _phoneController.text,
           pass,
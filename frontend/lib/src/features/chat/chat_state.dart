@@ -23,6 +23,9 @@ class ChatState extends ChangeNotifier {
   /// Эхо exclude_ids для "ещё".
   List<int> shownMasterclassIds = [];
 
+  /// Эхо seen_token: показанное исключает бэкенд, без растущего списка.
+  String? seenToken;
+
   bool loading = false;
 
   /// Загрузить сохранённую переписку для отображения (без восстановления контекста LLM).
@@ -73,6 +76,7 @@ class ChatState extends ChangeNotifier {
   void clearLlmSession() {
     llmMessages.clear();
     shownMasterclassIds = [];
+    seenToken = null;
     notifyListeners();
   }
 
@@ -81,6 +85,7 @@ class ChatState extends ChangeNotifier {
     uiMessages.clear();
     llmMessages.clear();
     shownMasterclassIds = [];
+    seenToken = null;
     loading = false;
     notifyListeners();
     try {
@@ -106,6 +111,7 @@ class ChatState extends ChangeNotifier {
             ? null
             : List<Map<String, String>>.from(llmMessages),
         shownMasterclassIds: shownMasterclassIds,
+        seenToken: seenToken,
       );
       final assistantMsg = <String, String>{
         'role': 'assistant',
@@ -118,6 +124,7 @@ class ChatState extends ChangeNotifier {
       llmMessages.add({'role': 'user', 'content': trimmed});
       llmMessages.add({'role': 'assistant', 'content': result.reply});
       shownMasterclassIds = result.shownMasterclassIds;
+      seenToken = result.seenToken ?? seenToken;
       await _saveUiMessages();
     } catch (e) {
       rethrow;
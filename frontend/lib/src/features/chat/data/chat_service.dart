@@ -21,6 +21,7 @@ class ChatService {
     required String message,
     List<Map<String, String>>? messages,
     List<int> shownMasterclassIds = const [],
+    String? seenToken,
   }) async {
     final response = await _dio.post<Map<String, dynamic>>(
       '/chat',
@@ -29,6 +30,7 @@ class ChatService {
         if (messages != null && messages.isNotEmpty) 'messages': messages,
         if (shownMasterclassIds.isNotEmpty)
           'shown_masterclass_ids': shownMasterclassIds,
+        if (seenToken != null) 'seen_token': seenToken,
       },
     );
     final data = response.data;
@@ -54,10 +56,12 @@ class ChatService {
         }
       }
     }
+    final token = data?['seen_token'];
     return ChatReply(
       reply: reply,
       shownMasterclassIds: shown,
       masterclassesPreview: preview,
+      seenToken: token is String && token.isNotEmpty ? token : null,
     );
   }
 }
@@ -66,10 +70,12 @@ class ChatReply {
   final String reply;
   final List<int> shownMasterclassIds;
   final List<Map<String, dynamic>> masterclassesPreview;
+  final String? seenToken;
 
   const ChatReply({
     required this.reply,
     required this.shownMasterclassIds,
     this.masterclassesPreview = const [],
+    this.seenToken,
   });
 }
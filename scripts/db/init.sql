@@ -1,7 +1,14 @@
+DROP VIEW IF EXISTS masterclasses_with_archive;
+DROP TABLE IF EXISTS user_purge_jobs;
+DROP TABLE IF EXISTS session_revocations;
 DROP TABLE IF EXISTS user_favorites;
 DROP TABLE IF EXISTS users;
+DROP TABLE IF EXISTS masterclasses_archive;
 DROP TABLE IF EXISTS masterclasses;
 
+-- Статистика по запросам (строки, время); нужен shared_preload_libraries.
+CREATE EXTENSION IF NOT EXISTS pg_stat_statements;
+
 CREATE TABLE IF NOT EXISTS masterclasses (
     id BIGINT PRIMARY KEY,
     title TEXT NOT NULL,
@@ -23,9 +30,39 @@ CREATE TABLE IF NOT EXISTS masterclasses (
     contact_phone TEXT,
     audience TEXT,
     additional_tags TEXT,
+    latitude DOUBLE PRECISION CHECK (latitude BETWEEN -90 AND 90),
+    longitude DOUBLE PRECISION CHECK (longitude BETWEEN -180 AND 180),
+    -- Хеш строки data.csv, из которой строка пришла через /mcsync; NULL -
+    -- добавлена через /mcadd, синхронизация её не удаляет.
+    source_hash BIGINT,
     created_at TIMESTAMPTZ NOT NULL DEFAULT NOW()
 );
 
+CREATE INDEX IF NOT EXISTS masterclasses_event_date_idx
+    ON masterclasses (event_date);
+
+-- Прошедшие мастер-классы: event-archiver переносит сюда строки, у которых
+-- event_date уже позади, так что masterclasses держит только предстоящие
+-- и строки без даты.
+CREATE TABLE IF NOT EXISTS masterclasses_archive (
+    LIKE masterclasses INCLUDING DEFAULTS INCLUDING CONSTRAINTS,
+    archived_at TIMESTAMPTZ NOT NULL DEFAULT NOW(),
+    PRIMARY KEY (id)
+);
+
+-- Обе части одним набором для include_past; при archived = FALSE в условии
+-- ветка архива отсекается планировщиком.
+CREATE OR REPLACE VIEW masterclasses_with_archive AS
+SELECT id, title, location, price, website, image_url, format, company, category, min_age, rating,
+       description, event_date, duration, organizer, contact_tg, contact_vk, contact_phone, audience, additional_tags,
+       latitude, longitude, FALSE AS archived
+FROM masterclasses
+UNION ALL
+SELECT id, title, location, price, website, image_url, format, company, category, min_age, rating,
+       description, event_date, duration, organizer, contact_tg, contact_vk, contact_phone, audience, additional_tags,
+       latitude, longitude, TRUE AS archived
+FROM masterclasses_archive;
+
 CREATE TABLE IF NOT EXISTS users (
     id TEXT PRIMARY KEY,
     phone TEXT NOT NULL UNIQUE,
@@ -35,9 +72,41 @@ CREATE TABLE IF NOT EXISTS users (
     created_at TIMESTAMPTZ NOT NULL DEFAULT NOW()
 );
 
+-- /login и /register ищут по цифрам телефона, выражение - ровно как в
+-- select_user_by_phone и exists_user_by_phone; без индекса каждый вход
+-- читает всю таблицу users.
+CREATE INDEX IF NOT EXISTS users_phone_digits_idx
+    ON users ((regexp_replace(phone, '[^0-9]', '', 'g')));
+
 CREATE TABLE IF NOT EXISTS user_favorites (
     user_id TEXT NOT NULL REFERENCES users(id) ON DELETE CASCADE,
-    masterclass_id BIGINT NOT NULL REFERENCES masterclasses(id) ON DELETE CASCADE,
+    -- Без внешнего ключа на masterclasses: избранное переживает перенос
+    -- строки в архив, а удаление мастер-класса чистит его само.
+    masterclass_id BIGINT NOT NULL,
     created_at TIMESTAMPTZ NOT NULL DEFAULT NOW(),
     PRIMARY KEY (user_id, masterclass_id)
 );
+
+CREATE TABLE IF NOT EXISTS session_revocations (
+    user_id TEXT PRIMARY KEY,
+    revoked_before TIMESTAMPTZ NOT NULL
+);
+
+-- Очередь удаления аккаунтов (/userdelete): user-purge удаляет избранное
+-- пакетами и последней - строку users. Без внешнего ключа на users:
+-- задача переживает удаление пользователя, по ней отвечает статус.
+CREATE TABLE IF NOT EXISTS user_purge_jobs (
+    id BIGSERIAL PRIMARY KEY,
+    user_id TEXT NOT NULL,
+    status TEXT NOT NULL DEFAULT 'pending'
+        CHECK (status IN ('pending', 'running', 'done', 'failed')),
+    favorites_deleted BIGINT NOT NULL DEFAULT 0,
+    attempts INT NOT NULL DEFAULT 0,
+    last_error TEXT,
+    created_at TIMESTAMPTZ NOT NULL DEFAULT NOW(),
+    updated_at TIMESTAMPTZ NOT NULL DEFAULT NOW(),
+    finished_at TIMESTAMPTZ
+);
+
+CREATE UNIQUE INDEX IF NOT EXISTS user_purge_jobs_active_idx
+    ON user_purge_jobs (user_id) WHERE status IN ('pending', 'running');
@@ -7,9 +7,18 @@ POSTGRES_PORT="${POSTGRES_PORT:-5432}"
 POSTGRES_USER="${POSTGRES_USER:-postgres}"
 POSTGRES_PASSWORD="${POSTGRES_PASSWORD:-postgres}"
 POSTGRES_DB="${POSTGRES_DB:-app}"
+# Без SESSION_KEY ключ случайный: после перезапуска старые токены недействительны.
+SESSION_KEY_ID="${SESSION_KEY_ID:-k1}"
+SESSION_KEY="${SESSION_KEY:-$(head -c 32 /dev/urandom | base64)}"
 
 cat > /app/configs/secdist.json <<EOF
 {
+  "session_keys": {
+    "current": "${SESSION_KEY_ID}",
+    "keys": {
+      "${SESSION_KEY_ID}": "${SESSION_KEY}"
+    }
+  },
   "postgresql_settings": {
     "databases": {
       "app-db": [
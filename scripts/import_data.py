@@ -1,6 +1,7 @@
 import csv
 import os
 import re
+import sys
 from datetime import datetime
 
 import requests
@@ -9,6 +10,7 @@ _ROOT = os.path.abspath(os.path.join(os.path.dirname(__file__), ".."))
 _CSV = os.environ.get("CSV_PATH", os.path.join(_ROOT, "data.csv"))
 _API_BASE = os.environ.get("API_BASE_URL", "http://127.0.0.1:80").rstrip("/")
 API_URL = f"{_API_BASE}/mcadd"
+SYNC_URL = f"{_API_BASE}/mcsync"
 
 def parse_price(price_str):
     if not price_str:
@@ -23,17 +25,21 @@ def parse_date(date_str):
         dt = datetime.strptime(date_str, "%d.%m.%Y")
         return dt.strftime("%Y-%m-%d")
     except:
-        return "1970-01-01"
+        return ""
 
 def import_data(csv_file):
     with open(csv_file, 'r', encoding='utf-8') as f:
         reader = csv.reader(f)
         header = next(reader)
-        count = 1
         for row in reader:
             if not row: continue
             
             try:
+                # id берётся из файла, как и в /mcsync: по номеру строки он
+                # сдвигался бы от любой вставки в середину файла.
+                masterclass_id = int(row[0])
+                if masterclass_id <= 0:
+                    raise ValueError(f"id must be positive, got {row[0]!r}")
                 title = row[1]
                 description = row[2]
                 price = parse_price(row[3])
@@ -53,7 +59,7 @@ def import_data(csv_file):
                 contact_phone = row[14] if len(row) > 14 else ""
 
                 payload = {
-                    "id": count,
+                    "id": masterclass_id,
                     "title": title,
                     "description": description,
                     "price": price,
@@ -79,11 +85,31 @@ def import_data(csv_file):
                 resp = requests.post(API_URL, json=payload)
                 if resp.status_code != 201:
                     print(f"Failed to import {title}: {resp.status_code} {resp.text}")
-                
-                count += 1
             except Exception as e:
                 print(f"Error processing row: {e}")
 
+def sync_data(csv_file, dry_run=False, allow_mass_delete=False):
+    """Отдаёт файл целиком в /mcsync: сервис сам разбирает его и применяет
+    только изменившиеся строки. allow_mass_delete снимает защиту от
+    удаления большей части каталога."""
+    params = {}
+    if dry_run:
+        params["dry_run"] = "1"
+    if allow_mass_delete:
+        params["allow_mass_delete"] = "1"
+    with open(csv_file, 'rb') as f:
+        resp = requests.post(
+            SYNC_URL,
+            params=params or None,
+            data=f,
+            headers={"Content-Type": "text/csv"},
+        )
+    print(resp.status_code, resp.text)
+
 if __name__ == "__main__":
-    import_data(_CSV)
+    if "--sync" in sys.argv:
+        sync_data(_CSV, dry_run="--dry-run" in sys.argv,
+                  allow_mass_delete="--allow-mass-delete" in sys.argv)
+    else:
+        import_data(_CSV)
 
@@ -0,0 +1,48 @@
+#include "catalog/change_log.hpp"
+
+#include <algorithm>
+#include <utility>
+
+namespace masterclasses::catalog {
+
+void ChangeLog::Record(std::uint64_t version,
+                       std::vector<std::int64_t> touched) {
+    if (version <= version_) {
+        // Старый журнал к новым версиям не относится.
+        entries_.clear();
+    } else if (!touched.empty()) {
+        entries_.push_back(Entry{version, std::move(touched)});
+        while (entries_.size() > max_entries_) {
+            entries_.pop_front();
+        }
+    }
+    version_ = version;
+}
+
+ChangeLog::Changes ChangeLog::Since(std::uint64_t since) const {
+    Changes changes;
+    changes.version = version_;
+    if (since == version_) {
+        return changes;
+    }
+    // Журнал покрывает версии (front.version - 1, version_].
+    if (since > version_ || entries_.empty() ||
+        since + 1 < entries_.front().version) {
+        changes.resync = true;
+        return changes;
+    }
+    for (const auto& entry : entries_) {
+        if (entry.version > since) {
+            changes.touched.insert(changes.touched.end(),
+                                   entry.touched.begin(),
+                                   entry.touched.end());
+        }
+    }
+    std::sort(changes.touched.begin(), changes.touched.end());
+    changes.touched.erase(
+        std::unique(changes.touched.begin(), changes.touched.end()),
+        changes.touched.end());
+    return changes;
+}
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,45 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <vector>
+
+namespace masterclasses::catalog {
+
+/// Ограниченный журнал версий каталога для /mclist/changes: по каждой
+/// версии - id строк, которые она затронула. Синхронизацию обеспечивает
+/// владелец.
+class ChangeLog {
+  public:
+    struct Changes {
+        /// Журнал не покрывает since - клиенту нужна полная перезагрузка.
+        bool resync{false};
+        std::uint64_t version{0};
+        /// id, затронутые после since, по возрастанию, без повторов.
+        std::vector<std::int64_t> touched;
+    };
+
+    /// Хранит не больше `max_entries` последних версий с изменениями.
+    explicit ChangeLog(std::size_t max_entries) : max_entries_(max_entries) {}
+
+    /// Опубликована версия `version`. Версия не больше текущей значит, что
+    /// снимок собран заново и версии пошли с начала: журнал очищается.
+    void Record(std::uint64_t version, std::vector<std::int64_t> touched);
+
+    Changes Since(std::uint64_t since) const;
+
+    std::uint64_t Version() const { return version_; }
+
+  private:
+    struct Entry {
+        std::uint64_t version;
+        std::vector<std::int64_t> touched;
+    };
+
+    std::size_t max_entries_;
+    std::deque<Entry> entries_;
+    std::uint64_t version_{0};
+};
+
+}  // namespace masterclasses::catalog
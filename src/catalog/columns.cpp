@@ -0,0 +1,270 @@
+#include "catalog/columns.hpp"
+
+#include <cmath>
+#include <limits>
+
+#include "catalog/event_date.hpp"
+
+namespace masterclasses::catalog {
+
+namespace {
+
+char AsciiLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+std::uint64_t Fnv1a(std::string_view value) {
+    std::uint64_t hash = 14695981039346656037ULL;
+    for (const char c : value) {
+        hash ^= static_cast<unsigned char>(c);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+template <typename T>
+std::size_t VectorBytes(const std::vector<T>& values) {
+    return values.capacity() * sizeof(T);
+}
+
+const std::string& Field(const models::Masterclass& masterclass,
+                         ColumnStore::Column column) {
+    switch (column) {
+        case ColumnStore::Column::kFormat:
+            return masterclass.format;
+        case ColumnStore::Column::kCompany:
+            return masterclass.company;
+        case ColumnStore::Column::kCategory:
+            return masterclass.category;
+        case ColumnStore::Column::kAudience:
+            return masterclass.audience;
+        case ColumnStore::Column::kOrganizer:
+            return masterclass.organizer;
+        case ColumnStore::Column::kLocation:
+            break;
+    }
+    return masterclass.location;
+}
+
+}  // namespace
+
+StringDictionary::Code StringDictionary::Intern(std::string_view value) {
+    if (const auto code = Find(value)) {
+        return *code;
+    }
+    const auto code = static_cast<Code>(Size());
+    arena_.append(value);
+    offsets_.push_back(static_cast<std::uint32_t>(arena_.size()));
+    // Заполненность не выше половины - цепочки проб короткие.
+    if (Size() * 2 > slots_.size()) {
+        Rehash();
+    } else {
+        slots_[SlotOf(value)] = code;
+    }
+    return code;
+}
+
+std::optional<StringDictionary::Code> StringDictionary::Find(
+    std::string_view value) const {
+    if (slots_.empty()) {
+        return std::nullopt;
+    }
+    const auto code = slots_[SlotOf(value)];
+    if (code == kEmptySlot) {
+        return std::nullopt;
+    }
+    return code;
+}
+
+std::string_view StringDictionary::Get(Code code) const {
+    return std::string_view{arena_}.substr(
+        offsets_[code], offsets_[code + 1] - offsets_[code]);
+}
+
+std::size_t StringDictionary::MemoryBytes() const {
+    return arena_.capacity() + VectorBytes(offsets_) + VectorBytes(slots_);
+}
+
+/// Слот со значением `value` либо первый пустой на его цепочке.
+std::size_t StringDictionary::SlotOf(std::string_view value) const {
+    const auto mask = slots_.size() - 1;
+    for (auto slot = static_cast<std::size_t>(Fnv1a(value)) & mask;;
+         slot = (slot + 1) & mask) {
+        if (slots_[slot] == kEmptySlot || Get(slots_[slot]) == value) {
+            return slot;
+        }
+    }
+}
+
+void StringDictionary::Rehash() {
+    std::size_t capacity = 16;
+    while (capacity < Size() * 2) {
+        capacity *= 2;
+    }
+    slots_.assign(capacity, kEmptySlot);
+    for (Code code = 0; code < Size(); ++code) {
+        slots_[SlotOf(Get(code))] = code;
+    }
+}
+
+std::string_view ColumnStore::ColumnName(Column column) {
+    switch (column) {
+        case Column::kFormat:
+            return "format";
+        case Column::kCompany:
+            return "company";
+        case Column::kCategory:
+            return "category";
+        case Column::kAudience:
+            return "audience";
+        case Column::kOrganizer:
+            return "organizer";
+        case Column::kLocation:
+            break;
+    }
+    return "location";
+}
+
+ColumnStore::ColumnStore() {
+    for (std::size_t i = 0; i < kColumns; ++i) {
+        dictionaries_[i] = std::make_shared<StringDictionary>();
+        owns_dictionary_[i] = true;
+    }
+}
+
+ColumnStore ColumnStore::EmptyLike() const {
+    ColumnStore store;
+    store.dictionaries_ = dictionaries_;
+    store.owns_dictionary_ = {};
+    store.removed_since_compaction_ = removed_since_compaction_;
+    return store;
+}
+
+void ColumnStore::Append(const models::Masterclass& masterclass) {
+    for (std::size_t i = 0; i < kColumns; ++i) {
+        const auto& value = Field(masterclass, static_cast<Column>(i));
+        auto code = dictionaries_[i]->Find(value);
+        if (!code.has_value()) {
+            // Предыдущую версию читают запросы - пишем в свою копию.
+            if (!owns_dictionary_[i]) {
+                dictionaries_[i] =
+                    std::make_shared<StringDictionary>(*dictionaries_[i]);
+                owns_dictionary_[i] = true;
+            }
+            code = dictionaries_[i]->Intern(value);
+        }
+        codes_[i].push_back(*code);
+    }
+    for (const char c : masterclass.additional_tags) {
+        tags_arena_.push_back(AsciiLower(c));
+    }
+    tags_offsets_.push_back(static_cast<std::uint32_t>(tags_arena_.size()));
+    price_.push_back(masterclass.price);
+    rating_.push_back(masterclass.rating);
+    min_age_.push_back(masterclass.min_age);
+    day_.push_back(ParseEventDay(masterclass.event_date).value_or(kNoDay));
+    const bool located =
+        masterclass.latitude.has_value() && masterclass.longitude.has_value();
+    latitude_.push_back(located ? *masterclass.latitude
+                                : std::numeric_limits<double>::quiet_NaN());
+    longitude_.push_back(located ? *masterclass.longitude
+                                 : std::numeric_limits<double>::quiet_NaN());
+}
+
+void ColumnStore::AppendFrom(const ColumnStore& other, std::size_t row) {
+    for (std::size_t i = 0; i < kColumns; ++i) {
+        codes_[i].push_back(other.codes_[i][row]);
+    }
+    tags_arena_.append(other.TagsAt(row));
+    tags_offsets_.push_back(static_cast<std::uint32_t>(tags_arena_.size()));
+    price_.push_back(other.price_[row]);
+    rating_.push_back(other.rating_[row]);
+    min_age_.push_back(other.min_age_[row]);
+    day_.push_back(other.day_[row]);
+    latitude_.push_back(other.latitude_[row]);
+    longitude_.push_back(other.longitude_[row]);
+}
+
+void ColumnStore::Reserve(std::size_t rows) {
+    for (auto& codes : codes_) {
+        codes.reserve(rows);
+    }
+    tags_offsets_.reserve(rows + 1);
+    price_.reserve(rows);
+    rating_.reserve(rows);
+    min_age_.reserve(rows);
+    day_.reserve(rows);
+    latitude_.reserve(rows);
+    longitude_.reserve(rows);
+}
+
+bool ColumnStore::NeedsCompaction() {
+    if (removed_since_compaction_ < Size()) {
+        return false;
+    }
+    removed_since_compaction_ = 0;
+    for (std::size_t i = 0; i < kColumns; ++i) {
+        std::vector<bool> used(dictionaries_[i]->Size());
+        std::size_t live = 0;
+        for (const auto code : codes_[i]) {
+            if (!used[code]) {
+                used[code] = true;
+                ++live;
+            }
+        }
+        if (live * 2 < used.size()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ColumnStore ColumnStore::Compact() const {
+    ColumnStore store;
+    store.Reserve(Size());
+    for (std::size_t row = 0; row < Size(); ++row) {
+        for (std::size_t i = 0; i < kColumns; ++i) {
+            store.codes_[i].push_back(store.dictionaries_[i]->Intern(
+                dictionaries_[i]->Get(codes_[i][row])));
+        }
+    }
+    store.tags_arena_ = tags_arena_;
+    store.tags_offsets_ = tags_offsets_;
+    store.price_ = price_;
+    store.rating_ = rating_;
+    store.min_age_ = min_age_;
+    store.day_ = day_;
+    store.latitude_ = latitude_;
+    store.longitude_ = longitude_;
+    return store;
+}
+
+std::optional<GeoPoint> ColumnStore::LocationAt(std::size_t row) const {
+    if (std::isnan(latitude_[row])) {
+        return std::nullopt;
+    }
+    return GeoPoint{latitude_[row], longitude_[row]};
+}
+
+std::string_view ColumnStore::TagsAt(std::size_t row) const {
+    return std::string_view{tags_arena_}.substr(
+        tags_offsets_[row], tags_offsets_[row + 1] - tags_offsets_[row]);
+}
+
+ColumnStore::Stats ColumnStore::GetStats() const {
+    Stats stats;
+    stats.rows = Size();
+    stats.tags_bytes = tags_arena_.capacity();
+    stats.bytes = stats.tags_bytes + VectorBytes(tags_offsets_) +
+                  VectorBytes(price_) + VectorBytes(rating_) +
+                  VectorBytes(min_age_) + VectorBytes(day_) +
+                  VectorBytes(latitude_) + VectorBytes(longitude_);
+    for (std::size_t i = 0; i < kColumns; ++i) {
+        stats.dictionary_sizes[i] = dictionaries_[i]->Size();
+        stats.bytes +=
+            dictionaries_[i]->MemoryBytes() + VectorBytes(codes_[i]);
+    }
+    return stats;
+}
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,139 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <memory>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catalog/geo_index.hpp"
+#include "models/masterclass.hpp"
+
+namespace masterclasses::catalog {
+
+/// Интернированные значения одного столбца: строки лежат подряд в арене,
+/// строка каталога хранит только код. Коды стабильны - словарь только
+/// растёт, так что копия словаря продолжает понимать коды оригинала.
+class StringDictionary {
+  public:
+    using Code = std::uint32_t;
+
+    Code Intern(std::string_view value);
+    std::optional<Code> Find(std::string_view value) const;
+    std::string_view Get(Code code) const;
+
+    std::size_t Size() const { return offsets_.size() - 1; }
+    std::size_t MemoryBytes() const;
+
+  private:
+    static constexpr Code kEmptySlot = ~Code{0};
+
+    std::size_t SlotOf(std::string_view value) const;
+    void Rehash();
+
+    std::string arena_;
+    std::vector<std::uint32_t> offsets_{0};
+    std::vector<Code> slots_;  // открытая адресация, размер - степень двойки
+};
+
+/// Столбцовое представление снимка для фильтрации, строка i соответствует
+/// CatalogSnapshot::rows[i]. Низкокардинальные строковые поля хранятся
+/// кодами словарей, теги - в нижнем регистре в одной сплошной арене,
+/// числа, дата и координаты - плоскими массивами. Выдача API по-прежнему
+/// строится из rows; столбцы нужны, чтобы перебор строк не ходил по куче,
+/// и занимают память сверх rows (метрика catalog.total-bytes).
+///
+/// Словари разделяются между версиями снимка и копируются только при
+/// первом новом значении столбца в Apply, а проверка на сжатие считает
+/// удалённые строки и перебирает коды, лишь когда их набралось столько же,
+/// сколько живых, - обновление строки не стоит O(N).
+class ColumnStore {
+  public:
+    enum class Column : std::size_t {
+        kFormat,
+        kCompany,
+        kCategory,
+        kAudience,
+        kOrganizer,
+        kLocation,
+    };
+    static constexpr std::size_t kColumns = 6;
+    static constexpr std::int32_t kNoDay =
+        std::numeric_limits<std::int32_t>::min();
+
+    struct Stats {
+        std::size_t rows{0};
+        std::size_t bytes{0};
+        std::array<std::size_t, kColumns> dictionary_sizes{};
+        std::size_t tags_bytes{0};
+    };
+
+    ColumnStore();
+    // Копия делила бы словари, считая их своими.
+    ColumnStore(const ColumnStore&) = delete;
+    ColumnStore& operator=(const ColumnStore&) = delete;
+    ColumnStore(ColumnStore&&) = default;
+    ColumnStore& operator=(ColumnStore&&) = default;
+
+    static std::string_view ColumnName(Column column);
+
+    /// Пустое хранилище с теми же (разделяемыми) словарями: строки,
+    /// перенесённые AppendFrom, сохраняют свои коды.
+    ColumnStore EmptyLike() const;
+
+    void Append(const models::Masterclass& masterclass);
+    /// Переносит строку из предыдущей версии без повторного интернирования;
+    /// `other` должен быть источником EmptyLike().
+    void AppendFrom(const ColumnStore& other, std::size_t row);
+    void Reserve(std::size_t rows);
+    /// Учитывает строки предыдущей версии, удалённые или заменённые в Apply.
+    void NoteRemoved(std::size_t rows) { removed_since_compaction_ += rows; }
+
+    /// Словари только растут, и после многих Apply в них копятся значения
+    /// удалённых строк. true, если неиспользуемых больше половины; коды
+    /// перебираются, только когда удалённых строк набралось не меньше
+    /// Size(), так что проверка в среднем O(1) на удалённую строку.
+    bool NeedsCompaction();
+    /// Копия с перекодированными строками и словарями без мусора.
+    ColumnStore Compact() const;
+
+    std::size_t Size() const { return price_.size(); }
+    Stats GetStats() const;
+
+    const StringDictionary& Dictionary(Column column) const {
+        return *dictionaries_[static_cast<std::size_t>(column)];
+    }
+    StringDictionary::Code CodeAt(Column column, std::size_t row) const {
+        return codes_[static_cast<std::size_t>(column)][row];
+    }
+    /// Теги строки в нижнем регистре (ASCII).
+    std::string_view TagsAt(std::size_t row) const;
+
+    double PriceAt(std::size_t row) const { return price_[row]; }
+    double RatingAt(std::size_t row) const { return rating_[row]; }
+    int MinAgeAt(std::size_t row) const { return min_age_[row]; }
+    /// Дни от эпохи или kNoDay.
+    std::int32_t DayAt(std::size_t row) const { return day_[row]; }
+    std::optional<GeoPoint> LocationAt(std::size_t row) const;
+
+  private:
+    std::array<std::shared_ptr<StringDictionary>, kColumns> dictionaries_;
+    /// false - словарь разделён с предыдущей версией и только читается.
+    std::array<bool, kColumns> owns_dictionary_{};
+    std::size_t removed_since_compaction_{0};
+    std::array<std::vector<StringDictionary::Code>, kColumns> codes_;
+    std::string tags_arena_;
+    std::vector<std::uint32_t> tags_offsets_{0};
+    std::vector<double> price_;
+    std::vector<double> rating_;
+    std::vector<int> min_age_;
+    std::vector<std::int32_t> day_;
+    std::vector<double> latitude_;  // NaN - координат нет
+    std::vector<double> longitude_;
+};
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,62 @@
+#include "catalog/event_date.hpp"
+
+namespace masterclasses::catalog {
+
+std::optional<std::int32_t> ParseEventDay(std::string_view date) {
+    if (date.size() < 10 || date[4] != '-' || date[7] != '-') {
+        return std::nullopt;
+    }
+    const auto number = [&date](std::size_t pos, std::size_t len) {
+        int value = 0;
+        for (std::size_t i = pos; i < pos + len; ++i) {
+            if (date[i] < '0' || date[i] > '9') {
+                return -1;
+            }
+            value = value * 10 + (date[i] - '0');
+        }
+        return value;
+    };
+    int y = number(0, 4);
+    const int m = number(5, 2);
+    const int d = number(8, 2);
+    if (y < 0 || m < 1 || m > 12 || d < 1 || d > 31) {
+        return std::nullopt;
+    }
+
+    // days_from_civil (H. Hinnant).
+    y -= m <= 2 ? 1 : 0;
+    const int era = y / 400;
+    const int yoe = y - era * 400;
+    const int doy = (153 * (m + (m > 2 ? -3 : 9)) + 2) / 5 + d - 1;
+    const int doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+    return era * 146097 + doe - 719468;
+}
+
+std::string FormatEventDay(std::int32_t day) {
+    // civil_from_days (H. Hinnant).
+    const int z = day + 719468;
+    const int era = (z >= 0 ? z : z - 146096) / 146097;
+    const int doe = z - era * 146097;
+    const int yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+    const int doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+    const int mp = (5 * doy + 2) / 153;
+    const int d = doy - (153 * mp + 2) / 5 + 1;
+    const int m = mp + (mp < 10 ? 3 : -9);
+    const int y = yoe + era * 400 + (m <= 2 ? 1 : 0);
+
+    std::string date(10, '0');
+    const auto put = [&date](std::size_t pos, std::size_t len, int value) {
+        for (std::size_t i = pos + len; i-- > pos;) {
+            date[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+    };
+    put(0, 4, y);
+    date[4] = '-';
+    put(5, 2, m);
+    date[7] = '-';
+    put(8, 2, d);
+    return date;
+}
+
+}  // namespace masterclasses::catalog
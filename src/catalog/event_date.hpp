@@ -0,0 +1,17 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+namespace masterclasses::catalog {
+
+/// "YYYY-MM-DD..." -> номер дня от 1970-01-01; nullopt, если дата пустая
+/// или не в ISO-формате.
+std::optional<std::int32_t> ParseEventDay(std::string_view date);
+
+/// Обратное к ParseEventDay: номер дня -> "YYYY-MM-DD".
+std::string FormatEventDay(std::int32_t day);
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,263 @@
+#include "catalog/filter.hpp"
+
+#include "catalog/event_date.hpp"
+
+namespace masterclasses::catalog {
+
+namespace {
+
+char AsciiLower(char c) {
+    return (c >= 'A' && c <= 'Z') ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+std::vector<std::string> SplitLowerTokens(
+    const std::optional<std::string>& raw) {
+    std::vector<std::string> tokens;
+    if (!raw.has_value()) {
+        return tokens;
+    }
+    std::string current;
+    for (const char c : *raw) {
+        if (c == ',') {
+            tokens.push_back(std::move(current));
+            current.clear();
+        } else {
+            current.push_back(AsciiLower(c));
+        }
+    }
+    tokens.push_back(std::move(current));
+    return tokens;
+}
+
+bool ContainsIgnoreCase(std::string_view haystack, std::string_view lower) {
+    if (lower.empty()) {
+        return true;
+    }
+    if (haystack.size() < lower.size()) {
+        return false;
+    }
+    for (std::size_t pos = 0; pos + lower.size() <= haystack.size(); ++pos) {
+        if (AsciiLower(haystack[pos]) != lower[0]) {
+            continue;
+        }
+        std::size_t i = 1;
+        while (i < lower.size() && AsciiLower(haystack[pos + i]) == lower[i]) {
+            ++i;
+        }
+        if (i == lower.size()) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool MatchesAnyToken(std::string_view value,
+                     const std::vector<std::string>& tokens) {
+    for (const auto& token : tokens) {
+        if (ContainsIgnoreCase(value, token)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+/// Коды словаря, значения которых подходят под токены; пусто, если
+/// фильтра нет.
+std::vector<bool> MatchDictionary(const std::optional<std::string>& raw,
+                                  const StringDictionary& dictionary,
+                                  bool& empty) {
+    std::vector<bool> codes;
+    if (!raw.has_value()) {
+        return codes;
+    }
+    const auto tokens = SplitLowerTokens(raw);
+    codes.resize(dictionary.Size());
+    bool any = false;
+    for (StringDictionary::Code code = 0; code < dictionary.Size(); ++code) {
+        if (MatchesAnyToken(dictionary.Get(code), tokens)) {
+            codes[code] = true;
+            any = true;
+        }
+    }
+    empty = empty || !any;
+    return codes;
+}
+
+/// Код точного значения; отсутствие в словаре значит, что не подходит
+/// ни одна строка.
+std::optional<StringDictionary::Code> FindCode(
+    const std::optional<std::string>& raw, const StringDictionary& dictionary,
+    bool& empty) {
+    if (!raw.has_value()) {
+        return std::nullopt;
+    }
+    const auto code = dictionary.Find(*raw);
+    empty = empty || !code.has_value();
+    return code;
+}
+
+std::optional<std::int32_t> FilterDay(const std::optional<std::string>& raw,
+                                      bool& empty) {
+    if (!raw.has_value()) {
+        return std::nullopt;
+    }
+    const auto day = ParseEventDay(*raw);
+    empty = empty || !day.has_value();
+    return day;
+}
+
+bool WithinGeoFilter(const std::optional<GeoPoint>& point,
+                     const GeoFilter& near) {
+    return point.has_value() &&
+           (!near.radius_km ||
+            DistanceKm(near.center, *point) <= *near.radius_km);
+}
+
+}  // namespace
+
+FilterMatcher::FilterMatcher(const Filter& filter)
+    : filter_(filter),
+      category_tokens_(SplitLowerTokens(filter.category)),
+      audience_tokens_(SplitLowerTokens(filter.audience)),
+      tags_tokens_(SplitLowerTokens(filter.tags)) {}
+
+bool FilterMatcher::operator()(const models::Masterclass& mc) const {
+    if (filter_.category && !MatchesAnyToken(mc.category, category_tokens_)) {
+        return false;
+    }
+    if (filter_.audience && !MatchesAnyToken(mc.audience, audience_tokens_)) {
+        return false;
+    }
+    if (filter_.tags && !MatchesAnyToken(mc.additional_tags, tags_tokens_)) {
+        return false;
+    }
+    if (filter_.format && mc.format != *filter_.format) {
+        return false;
+    }
+    if (filter_.company && mc.company != *filter_.company) {
+        return false;
+    }
+    if (filter_.min_age && mc.min_age > *filter_.min_age) {
+        return false;
+    }
+    if (filter_.max_price && mc.price > *filter_.max_price) {
+        return false;
+    }
+    if (filter_.min_price && mc.price < *filter_.min_price) {
+        return false;
+    }
+    if (filter_.min_rating && mc.rating < *filter_.min_rating) {
+        return false;
+    }
+    if (filter_.event_date_from &&
+        (mc.event_date.empty() || mc.event_date < *filter_.event_date_from)) {
+        return false;
+    }
+    if (filter_.event_date_to &&
+        (mc.event_date.empty() || mc.event_date > *filter_.event_date_to)) {
+        return false;
+    }
+    if (filter_.upcoming_from && !mc.event_date.empty() &&
+        mc.event_date < *filter_.upcoming_from) {
+        return false;
+    }
+    if (filter_.near) {
+        std::optional<GeoPoint> point;
+        if (mc.latitude && mc.longitude) {
+            point = GeoPoint{*mc.latitude, *mc.longitude};
+        }
+        if (!WithinGeoFilter(point, *filter_.near)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ColumnFilter::ColumnFilter(const Filter& filter, const ColumnStore& columns)
+    : filter_(filter),
+      columns_(columns),
+      category_codes_(MatchDictionary(
+          filter.category,
+          columns.Dictionary(ColumnStore::Column::kCategory), empty_)),
+      audience_codes_(MatchDictionary(
+          filter.audience,
+          columns.Dictionary(ColumnStore::Column::kAudience), empty_)),
+      tags_tokens_(SplitLowerTokens(filter.tags)),
+      format_code_(FindCode(filter.format,
+                            columns.Dictionary(ColumnStore::Column::kFormat),
+                            empty_)),
+      company_code_(FindCode(
+          filter.company, columns.Dictionary(ColumnStore::Column::kCompany),
+          empty_)),
+      day_from_(FilterDay(filter.event_date_from, empty_)),
+      day_to_(FilterDay(filter.event_date_to, empty_)),
+      upcoming_day_(FilterDay(filter.upcoming_from, empty_)) {}
+
+bool ColumnFilter::operator()(std::size_t row) const {
+    using Column = ColumnStore::Column;
+    if (empty_) {
+        return false;
+    }
+    if (!category_codes_.empty() &&
+        !category_codes_[columns_.CodeAt(Column::kCategory, row)]) {
+        return false;
+    }
+    if (!audience_codes_.empty() &&
+        !audience_codes_[columns_.CodeAt(Column::kAudience, row)]) {
+        return false;
+    }
+    if (format_code_ &&
+        columns_.CodeAt(Column::kFormat, row) != *format_code_) {
+        return false;
+    }
+    if (company_code_ &&
+        columns_.CodeAt(Column::kCompany, row) != *company_code_) {
+        return false;
+    }
+    if (filter_.min_age && columns_.MinAgeAt(row) > *filter_.min_age) {
+        return false;
+    }
+    if (filter_.max_price && columns_.PriceAt(row) > *filter_.max_price) {
+        return false;
+    }
+    if (filter_.min_price && columns_.PriceAt(row) < *filter_.min_price) {
+        return false;
+    }
+    if (filter_.min_rating && columns_.RatingAt(row) < *filter_.min_rating) {
+        return false;
+    }
+    if (day_from_ || day_to_) {
+        const auto day = columns_.DayAt(row);
+        if (day == ColumnStore::kNoDay || (day_from_ && day < *day_from_) ||
+            (day_to_ && day > *day_to_)) {
+            return false;
+        }
+    }
+    if (upcoming_day_) {
+        const auto day = columns_.DayAt(row);
+        if (day != ColumnStore::kNoDay && day < *upcoming_day_) {
+            return false;
+        }
+    }
+    if (filter_.tags) {
+        // Теги в арене уже в нижнем регистре - хватает обычного поиска.
+        const auto tags = columns_.TagsAt(row);
+        bool found = false;
+        for (const auto& token : tags_tokens_) {
+            if (tags.find(token) != std::string_view::npos) {
+                found = true;
+                break;
+            }
+        }
+        if (!found) {
+            return false;
+        }
+    }
+    if (filter_.near &&
+        !WithinGeoFilter(columns_.LocationAt(row), *filter_.near)) {
+        return false;
+    }
+    return true;
+}
+
+}  // namespace masterclasses::catalog
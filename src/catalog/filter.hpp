@@ -0,0 +1,83 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catalog/columns.hpp"
+#include "models/masterclass.hpp"
+
+namespace masterclasses::catalog {
+
+/// Круг поиска рядом с точкой; без радиуса - все строки с координатами.
+struct GeoFilter {
+    GeoPoint center;
+    std::optional<double> radius_km;
+};
+
+/// Фильтры /mclist; поля совпадают с параметрами select_masterclasses_*.sql.
+struct Filter {
+    std::optional<std::string> category;
+    std::optional<std::string> audience;
+    std::optional<std::string> tags;
+    std::optional<std::string> format;
+    std::optional<std::string> company;
+    std::optional<int> min_age;
+    std::optional<double> max_price;
+    std::optional<double> min_price;
+    std::optional<double> min_rating;
+    std::optional<std::string> event_date_from;
+    std::optional<std::string> event_date_to;
+    /// Только предстоящие: строки с датой не раньше этой (YYYY-MM-DD) и
+    /// строки без даты; пусто - вместе с прошедшими (include_past).
+    std::optional<std::string> upcoming_from;
+    /// Полнотекстовый запрос (q=); отвечается только по TextIndex каталога.
+    std::optional<std::string> text;
+    /// lat/lon/radius_km; отвечается только по каталогу.
+    std::optional<GeoFilter> near;
+};
+
+/// Проверка строки каталога в памяти с той же семантикой, что и SQL:
+/// category/audience/tags - регистронезависимое вхождение любого токена
+/// из списка через запятую, даты сравниваются как YYYY-MM-DD.
+class FilterMatcher {
+  public:
+    explicit FilterMatcher(const Filter& filter);
+
+    bool operator()(const models::Masterclass& masterclass) const;
+
+  private:
+    const Filter& filter_;
+    std::vector<std::string> category_tokens_;
+    std::vector<std::string> audience_tokens_;
+    std::vector<std::string> tags_tokens_;
+};
+
+/// То же, что FilterMatcher, но по столбцам снимка: строковые фильтры
+/// один раз сопоставляются со словарями, и проверка строки сводится к
+/// сравнению кодов и чисел. Проверяет позицию строки в ColumnStore.
+class ColumnFilter {
+  public:
+    ColumnFilter(const Filter& filter, const ColumnStore& columns);
+
+    bool operator()(std::size_t row) const;
+
+  private:
+    using Code = StringDictionary::Code;
+
+    const Filter& filter_;
+    const ColumnStore& columns_;
+    /// Фильтр задан, но ни одно значение словаря ему не подходит.
+    bool empty_{false};
+    std::vector<bool> category_codes_;  // пусто - фильтра нет
+    std::vector<bool> audience_codes_;
+    std::vector<std::string> tags_tokens_;
+    std::optional<Code> format_code_;
+    std::optional<Code> company_code_;
+    std::optional<std::int32_t> day_from_;
+    std::optional<std::int32_t> day_to_;
+    std::optional<std::int32_t> upcoming_day_;
+};
+
+}  // namespace masterclasses::catalog
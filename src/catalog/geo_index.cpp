@@ -0,0 +1,102 @@
+#include "catalog/geo_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numbers>
+
+#include "catalog/columns.hpp"
+
+namespace masterclasses::catalog {
+
+namespace {
+
+constexpr double kEarthRadiusKm = 6371.0088;
+constexpr double kKmPerDegree = kEarthRadiusKm * std::numbers::pi / 180.0;
+constexpr auto kGridRows =
+    static_cast<std::uint32_t>(180.0 / GeoGrid::kCellDegrees);
+constexpr auto kGridColumns =
+    static_cast<std::uint32_t>(360.0 / GeoGrid::kCellDegrees);
+
+std::uint32_t CellIndex(double degrees, double origin, std::uint32_t cells) {
+    const auto index =
+        std::floor((degrees - origin) / GeoGrid::kCellDegrees);
+    return static_cast<std::uint32_t>(
+        std::clamp(index, 0.0, static_cast<double>(cells - 1)));
+}
+
+std::uint32_t RowOf(double latitude) {
+    return CellIndex(latitude, -90.0, kGridRows);
+}
+
+std::uint32_t ColumnOf(double longitude) {
+    return CellIndex(longitude, -180.0, kGridColumns);
+}
+
+double Radians(double degrees) { return degrees * std::numbers::pi / 180.0; }
+
+}  // namespace
+
+double DistanceKm(const GeoPoint& a, const GeoPoint& b) {
+    const auto dlat = Radians(b.latitude - a.latitude);
+    const auto dlon = Radians(b.longitude - a.longitude);
+    const auto h = std::sin(dlat / 2) * std::sin(dlat / 2) +
+                   std::cos(Radians(a.latitude)) *
+                       std::cos(Radians(b.latitude)) * std::sin(dlon / 2) *
+                       std::sin(dlon / 2);
+    return 2.0 * kEarthRadiusKm * std::asin(std::min(1.0, std::sqrt(h)));
+}
+
+GeoGrid GeoGrid::Build(const ColumnStore& columns) {
+    GeoGrid grid;
+    for (std::uint32_t row = 0; row < columns.Size(); ++row) {
+        if (const auto point = columns.LocationAt(row)) {
+            grid.cells_.emplace_back(
+                RowOf(point->latitude) * kGridColumns +
+                    ColumnOf(point->longitude),
+                row);
+        }
+    }
+    std::sort(grid.cells_.begin(), grid.cells_.end());
+    return grid;
+}
+
+std::pmr::vector<std::uint32_t> GeoGrid::Within(
+    const ColumnStore& columns, const GeoPoint& center, double radius_km,
+    std::pmr::memory_resource* resource) const {
+    std::pmr::vector<std::uint32_t> result(resource);
+
+    // Прямоугольник ячеек, покрывающий круг. Долгота берётся по самой
+    // дальней от экватора широте круга; переход через 180-й меридиан
+    // не поддерживается - прямоугольник обрезается.
+    const auto lat_delta = radius_km / kKmPerDegree;
+    const auto row_lo = RowOf(center.latitude - lat_delta);
+    const auto row_hi = RowOf(center.latitude + lat_delta);
+    const auto max_latitude = std::abs(center.latitude) + lat_delta;
+    std::uint32_t column_lo = 0;
+    std::uint32_t column_hi = kGridColumns - 1;
+    if (max_latitude < 90.0) {
+        const auto lon_delta =
+            radius_km / (kKmPerDegree * std::cos(Radians(max_latitude)));
+        if (lon_delta < 180.0) {
+            column_lo = ColumnOf(center.longitude - lon_delta);
+            column_hi = ColumnOf(center.longitude + lon_delta);
+        }
+    }
+
+    for (auto row = row_lo; row <= row_hi; ++row) {
+        const auto first = row * kGridColumns + column_lo;
+        const auto last = row * kGridColumns + column_hi;
+        for (auto it = std::lower_bound(cells_.begin(), cells_.end(),
+                                        std::pair{first, std::uint32_t{0}});
+             it != cells_.end() && it->first <= last; ++it) {
+            const auto point = columns.LocationAt(it->second);
+            if (DistanceKm(center, *point) <= radius_km) {
+                result.push_back(it->second);
+            }
+        }
+    }
+    std::sort(result.begin(), result.end());
+    return result;
+}
+
+}  // namespace masterclasses::catalog
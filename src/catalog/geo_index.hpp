@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace masterclasses::catalog {
+
+class ColumnStore;
+
+struct GeoPoint {
+    double latitude{0.0};
+    double longitude{0.0};
+};
+
+/// Расстояние по большому кругу, км.
+double DistanceKm(const GeoPoint& a, const GeoPoint& b);
+
+/// Сетка по координатам строк снимка: ячейки kCellDegrees x kCellDegrees,
+/// пары (ячейка, позиция строки) лежат одним отсортированным массивом,
+/// так что строка сетки - непрерывный диапазон, и запрос по кругу - по
+/// двоичному поиску на строку сетки плюс проверка расстояния.
+class GeoGrid {
+  public:
+    static constexpr double kCellDegrees = 0.05;
+
+    static GeoGrid Build(const ColumnStore& columns);
+
+    /// Позиции строк не дальше `radius_km` от `center`, по возрастанию;
+    /// `columns` - те же, по которым строилась сетка.
+    std::pmr::vector<std::uint32_t> Within(
+        const ColumnStore& columns, const GeoPoint& center, double radius_km,
+        std::pmr::memory_resource* resource) const;
+
+    /// Число строк с координатами.
+    std::size_t Size() const { return cells_.size(); }
+
+  private:
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> cells_;
+};
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,54 @@
+#include "catalog/popularity.hpp"
+#include "catalog/event_date.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+namespace masterclasses::catalog {
+
+double PopularityRanking::ScoreOf(std::int64_t id) const {
+    const auto it = scores.find(id);
+    return it == scores.end() ? 0.0 : it->second;
+}
+
+std::shared_ptr<const PopularityRanking> PopularityRanking::Build(
+    const CatalogSnapshot& snapshot,
+    const std::unordered_map<std::int64_t, std::int64_t>& counts,
+    std::int32_t today, double decay_half_life_days) {
+    auto ranking = std::make_shared<PopularityRanking>();
+    ranking->ranked.reserve(counts.size());
+    for (const auto& [id, count] : counts) {
+        if (count <= 0) {
+            continue;
+        }
+        const auto* row = snapshot.FindById(id);
+        if (row == nullptr) {
+            continue;
+        }
+        auto score = static_cast<double>(count);
+        if (decay_half_life_days > 0.0) {
+            if (const auto day = ParseEventDay(row->event_date)) {
+                const auto distance = std::abs(*day - today);
+                score *= std::exp2(-distance / decay_half_life_days);
+            }
+        }
+        ranking->ranked.push_back(Entry{id, score});
+    }
+
+    std::sort(ranking->ranked.begin(), ranking->ranked.end(),
+              [](const Entry& a, const Entry& b) {
+                  if (a.score != b.score) {
+                      return a.score > b.score;
+                  }
+                  return a.id < b.id;
+              });
+    ranking->scores.reserve(ranking->ranked.size());
+    for (const auto& entry : ranking->ranked) {
+        ranking->ranked_ids.Add(entry.id);
+        ranking->scores.emplace(entry.id, entry.score);
+    }
+    return ranking;
+}
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+#include "catalog/snapshot.hpp"
+#include "utils/id_set.hpp"
+
+namespace masterclasses::catalog {
+
+/// Готовый порядок для sort_order=popular: мастер-классы с ненулевым числом
+/// добавлений в избранное по убыванию очков, при равенстве по id. Строится
+/// в фоне из счётчиков, запрос только идёт по нему.
+struct PopularityRanking {
+    struct Entry {
+        std::int64_t id{0};
+        double score{0.0};
+    };
+
+    std::vector<Entry> ranked;
+    utils::IdSet ranked_ids;
+    std::unordered_map<std::int64_t, double> scores;
+
+    double ScoreOf(std::int64_t id) const;
+
+    /// Очки - число добавлений в избранное. Если `decay_half_life_days` > 0,
+    /// они ещё и вдвое падают на каждые decay_half_life_days между
+    /// event_date и `today` (номер дня, как в ParseEventDay): ближайшие
+    /// события поднимаются, давно прошедшие уходят вниз.
+    static std::shared_ptr<const PopularityRanking> Build(
+        const CatalogSnapshot& snapshot,
+        const std::unordered_map<std::int64_t, std::int64_t>& counts,
+        std::int32_t today, double decay_half_life_days);
+};
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,278 @@
+#include "catalog/select.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <string>
+
+namespace masterclasses::catalog {
+
+namespace {
+
+struct Candidate {
+    const models::Masterclass* row;
+    double score;
+};
+
+/// score DESC, id ASC
+bool ScoreLess(const Candidate& a, const Candidate& b) {
+    if (a.score != b.score) {
+        return a.score > b.score;
+    }
+    return a.row->id < b.row->id;
+}
+
+bool IdLess(const Candidate& a, const Candidate& b) {
+    return a.row->id < b.row->id;
+}
+
+/// lower_bound с галопом от `from`: попадания обычно идут плотно, и
+/// следующий id чаще всего совсем рядом.
+std::vector<std::int64_t>::const_iterator GallopTo(
+    std::vector<std::int64_t>::const_iterator from,
+    std::vector<std::int64_t>::const_iterator end, std::int64_t id) {
+    std::ptrdiff_t step = 1;
+    auto lo = from;
+    while (end - lo > step && *(lo + step) < id) {
+        lo += step;
+        step *= 2;
+    }
+    const auto hi = end - lo > step ? lo + step + 1 : end;
+    return std::lower_bound(lo, hi, id);
+}
+
+/// Вызывает `visit(position, hit)` для попаданий, которые есть в снимке.
+/// Попадания и snapshot.ids отсортированы по id - идём слиянием.
+template <typename Visitor>
+void ForEachHit(const CatalogSnapshot& snapshot,
+                const std::vector<TextIndex::Hit>& hits, Visitor visit) {
+    auto pos = snapshot.ids.cbegin();
+    for (const auto& hit : hits) {
+        pos = GallopTo(pos, snapshot.ids.end(), hit.id);
+        if (pos == snapshot.ids.end()) {
+            break;
+        }
+        if (*pos == hit.id) {
+            visit(static_cast<std::size_t>(pos - snapshot.ids.begin()), hit);
+        }
+    }
+}
+
+/// Битовая карта позиций строк, попавших в текстовый запрос.
+std::pmr::vector<bool> TextHits(const CatalogSnapshot& snapshot,
+                                const std::string& text,
+                                std::pmr::memory_resource* resource) {
+    std::pmr::vector<bool> selected(snapshot.rows.size(), false, resource);
+    ForEachHit(snapshot, snapshot.text_index->Search(text),
+               [&selected](std::size_t position, const auto&) {
+                   selected[position] = true;
+               });
+    return selected;
+}
+
+/// Лучшие offset + limit кандидатов по `less`, страница - с offset.
+Page TakeBest(std::pmr::vector<Candidate>& matched, std::int64_t limit,
+              std::int64_t offset,
+              bool (*less)(const Candidate&, const Candidate&),
+              std::pmr::memory_resource* resource) {
+    Page result(resource);
+    if (offset >= static_cast<std::int64_t>(matched.size())) {
+        return result;
+    }
+    const auto end = static_cast<std::size_t>(
+        std::min<std::int64_t>(matched.size(), offset + limit));
+    std::partial_sort(matched.begin(), matched.begin() + end, matched.end(),
+                      less);
+
+    result.reserve(end - offset);
+    for (auto i = static_cast<std::size_t>(offset); i < end; ++i) {
+        result.push_back(matched[i].row);
+    }
+    return result;
+}
+
+/// Набирает страницу из строк в порядке обхода: пропускает offset
+/// подходящих и сообщает, когда страница заполнена.
+class PageBuilder {
+  public:
+    PageBuilder(std::int64_t limit, std::int64_t offset,
+                std::pmr::memory_resource* resource)
+        : limit_(limit), offset_(offset), page_(resource) {}
+
+    bool Full() const {
+        return static_cast<std::int64_t>(page_.size()) >= limit_;
+    }
+
+    void Take(const models::Masterclass& row) {
+        if (skipped_ < offset_) {
+            ++skipped_;
+            return;
+        }
+        page_.push_back(&row);
+    }
+
+    Page Extract() { return std::move(page_); }
+
+  private:
+    std::int64_t limit_;
+    std::int64_t offset_;
+    std::int64_t skipped_{0};
+    Page page_;
+};
+
+}  // namespace
+
+Page Select(const CatalogSnapshot& snapshot, const Filter& filter,
+            const utils::IdSet* excluded, SortOrder order, std::int64_t limit,
+            std::int64_t offset, const PopularityRanking* popularity,
+            std::pmr::memory_resource* resource) {
+    // Фильтр проверяет столбцы по позиции строки, сама строка нужна только
+    // для страницы.
+    const ColumnFilter matches(filter, *snapshot.columns);
+    const auto accept = [&](std::size_t position) {
+        return (excluded == nullptr ||
+                !excluded->Contains(snapshot.ids[position])) &&
+               matches(position);
+    };
+
+    if ((order == SortOrder::kPopular && popularity == nullptr) ||
+        (order == SortOrder::kDistance && !filter.near.has_value())) {
+        order = SortOrder::kId;
+    }
+
+    // Круг с радиусом - сразу позиции из сетки (по возрастанию), вместо
+    // проверки расстояния для каждой строки.
+    std::optional<std::pmr::vector<std::uint32_t>> in_radius;
+    if (filter.near.has_value() && filter.near->radius_km.has_value()) {
+        in_radius = snapshot.geo->Within(*snapshot.columns,
+                                         filter.near->center,
+                                         *filter.near->radius_km, resource);
+    }
+
+    if (order == SortOrder::kDistance) {
+        // Ближайшие сначала: очко - минус расстояние, дальше как у
+        // релевантности.
+        std::pmr::vector<bool> text_hits(resource);
+        if (filter.text.has_value()) {
+            text_hits = TextHits(snapshot, *filter.text, resource);
+        }
+        std::pmr::vector<Candidate> matched(resource);
+        const auto consider = [&](std::size_t position) {
+            if ((!text_hits.empty() && !text_hits[position]) ||
+                !accept(position)) {
+                return;
+            }
+            matched.push_back(Candidate{
+                snapshot.rows[position].get(),
+                -DistanceKm(filter.near->center,
+                            *snapshot.columns->LocationAt(position))});
+        };
+        if (in_radius.has_value()) {
+            for (const auto position : *in_radius) {
+                consider(position);
+            }
+        } else {
+            for (std::size_t i = 0; i < snapshot.rows.size(); ++i) {
+                consider(i);
+            }
+        }
+        return TakeBest(matched, limit, offset, ScoreLess, resource);
+    }
+
+    PageBuilder page(limit, offset, resource);
+    if (const auto key = FindSortKey(order)) {
+        // Готовая перестановка: идём по ней и останавливаемся на limit.
+        // Текстовый запрос и круг превращаются в битовые карты позиций.
+        std::pmr::vector<bool> selected(resource);
+        if (filter.text.has_value()) {
+            selected = TextHits(snapshot, *filter.text, resource);
+        }
+        std::pmr::vector<bool> in_circle(resource);
+        if (in_radius.has_value()) {
+            in_circle.assign(snapshot.rows.size(), false);
+            for (const auto position : *in_radius) {
+                in_circle[position] = true;
+            }
+        }
+        for (const auto position : snapshot.permutations->Get(*key)) {
+            if (page.Full()) {
+                break;
+            }
+            if ((!selected.empty() && !selected[position]) ||
+                (!in_circle.empty() && !in_circle[position])) {
+                continue;
+            }
+            if (accept(position)) {
+                page.Take(*snapshot.rows[position]);
+            }
+        }
+        return page.Extract();
+    }
+
+    if (!filter.text.has_value() && order == SortOrder::kPopular) {
+        // Сначала готовый рейтинг, за ним строки без избранного по id;
+        // в обоих случаях останавливаемся, как только набрали страницу.
+        for (const auto& entry : popularity->ranked) {
+            if (page.Full()) {
+                return page.Extract();
+            }
+            const auto position = snapshot.IndexOf(entry.id);
+            if (position >= 0 && accept(static_cast<std::size_t>(position))) {
+                page.Take(*snapshot.rows[static_cast<std::size_t>(position)]);
+            }
+        }
+        for (std::size_t i = 0; i < snapshot.rows.size(); ++i) {
+            if (page.Full()) {
+                break;
+            }
+            if (!popularity->ranked_ids.Contains(snapshot.ids[i]) &&
+                accept(i)) {
+                page.Take(*snapshot.rows[i]);
+            }
+        }
+        return page.Extract();
+    }
+
+    if (!filter.text.has_value() && in_radius.has_value()) {
+        // Позиции из сетки уже по возрастанию, то есть по id.
+        for (const auto position : *in_radius) {
+            if (page.Full()) {
+                break;
+            }
+            if (accept(position)) {
+                page.Take(*snapshot.rows[position]);
+            }
+        }
+        return page.Extract();
+    }
+
+    if (!filter.text.has_value()) {
+        // Строки уже упорядочены по id - достаточно остановиться на limit.
+        for (std::size_t i = 0; i < snapshot.rows.size(); ++i) {
+            if (page.Full()) {
+                break;
+            }
+            if (accept(i)) {
+                page.Take(*snapshot.rows[i]);
+            }
+        }
+        return page.Extract();
+    }
+
+    // Остались порядки по очкам попаданий: релевантность или популярность.
+    std::pmr::vector<Candidate> matched(resource);
+    ForEachHit(snapshot, snapshot.text_index->Search(*filter.text),
+               [&](std::size_t position, const TextIndex::Hit& hit) {
+                   if (!accept(position)) {
+                       return;
+                   }
+                   const auto* row = snapshot.rows[position].get();
+                   matched.push_back(Candidate{
+                       row, order == SortOrder::kPopular
+                                ? popularity->ScoreOf(row->id)
+                                : hit.score});
+               });
+    return TakeBest(matched, limit, offset,
+                    order == SortOrder::kId ? IdLess : ScoreLess, resource);
+}
+
+}  // namespace masterclasses::catalog
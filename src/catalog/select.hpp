@@ -0,0 +1,29 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <vector>
+
+#include "catalog/filter.hpp"
+#include "catalog/popularity.hpp"
+#include "catalog/snapshot.hpp"
+#include "catalog/sort_keys.hpp"
+#include "models/masterclass.hpp"
+#include "utils/id_set.hpp"
+
+namespace masterclasses::catalog {
+
+/// Страница строк снимка; указатели живут, пока жив снимок.
+using Page = std::pmr::vector<const models::Masterclass*>;
+
+/// Страница /mclist из снимка каталога. Порядки из kSortKeys идут по
+/// готовой перестановке и останавливаются на limit, без сортировки на
+/// запрос. `excluded` и `popularity` могут быть nullptr. Страница и
+/// временные структуры выборки берутся из `resource` (арена запроса).
+Page Select(const CatalogSnapshot& snapshot, const Filter& filter,
+            const utils::IdSet* excluded, SortOrder order, std::int64_t limit,
+            std::int64_t offset, const PopularityRanking* popularity = nullptr,
+            std::pmr::memory_resource* resource =
+                std::pmr::get_default_resource());
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,200 @@
+#include "catalog/similarity.hpp"
+#include "catalog/event_date.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string_view>
+
+namespace masterclasses::catalog {
+
+namespace {
+
+constexpr std::int32_t kNoDate = std::numeric_limits<std::int32_t>::min();
+
+constexpr float kCategoryWeight = 1.0F;
+constexpr float kTagWeight = 0.8F;
+constexpr float kAudienceWeight = 0.7F;
+constexpr float kFormatWeight = 0.4F;
+constexpr float kCompanyWeight = 0.3F;
+constexpr float kPriceWeight = 0.5F;
+
+/// Вклад близости дат: полный для одного дня, вдвое меньше через ~3 недели.
+constexpr float kDateWeight = 0.25F;
+constexpr float kDateScaleDays = 30.0F;
+
+constexpr double kPriceBuckets[] = {0.0, 1000.0, 2500.0, 5000.0, 10000.0};
+
+char AsciiLower(char c) {
+    return c >= 'A' && c <= 'Z' ? static_cast<char>(c - 'A' + 'a') : c;
+}
+
+std::uint64_t Fnv1a(std::string_view prefix, std::string_view value) {
+    std::uint64_t hash = 1469598103934665603ULL;
+    const auto mix = [&hash](std::string_view s) {
+        for (const auto c : s) {
+            hash ^= static_cast<unsigned char>(AsciiLower(c));
+            hash *= 1099511628211ULL;
+        }
+    };
+    mix(prefix);
+    mix(value);
+    return hash;
+}
+
+std::string_view Trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+        s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+        s.remove_suffix(1);
+    return s;
+}
+
+/// Хеширование признаков со знаком: коллизии в среднем гасят друг друга.
+template <typename Vector>
+void AddFeature(Vector& vector, std::string_view prefix,
+                std::string_view value, float weight) {
+    value = Trim(value);
+    if (value.empty()) {
+        return;
+    }
+    const auto hash = Fnv1a(prefix, value);
+    const auto dimension = hash % vector.size();
+    vector[dimension] += (hash >> 63) != 0 ? -weight : weight;
+}
+
+template <typename Vector>
+void AddList(Vector& vector, std::string_view prefix, std::string_view list,
+             float weight) {
+    while (!list.empty()) {
+        const auto comma = list.find(',');
+        AddFeature(vector, prefix, list.substr(0, comma), weight);
+        if (comma == std::string_view::npos) {
+            break;
+        }
+        list.remove_prefix(comma + 1);
+    }
+}
+
+int PriceBucket(double price) {
+    int bucket = 0;
+    for (const auto bound : kPriceBuckets) {
+        if (price > bound) {
+            ++bucket;
+        }
+    }
+    return bucket;
+}
+
+}  // namespace
+
+FeatureMatrix::Vector FeatureMatrix::Featurize(
+    const models::Masterclass& masterclass) {
+    Vector vector{};
+    AddList(vector, "c:", masterclass.category, kCategoryWeight);
+    AddList(vector, "t:", masterclass.additional_tags, kTagWeight);
+    AddList(vector, "a:", masterclass.audience, kAudienceWeight);
+    AddFeature(vector, "f:", masterclass.format, kFormatWeight);
+    AddFeature(vector, "s:", masterclass.company, kCompanyWeight);
+
+    // Соседние корзины цены получают половину веса: 900 и 1100 рублей
+    // похожи больше, чем 900 и 9000.
+    const auto bucket = PriceBucket(masterclass.price);
+    for (int b = bucket - 1; b <= bucket + 1; ++b) {
+        const char name[] = {static_cast<char>('0' + b + 1), '\0'};
+        AddFeature(vector, "p:", name,
+                   b == bucket ? kPriceWeight : kPriceWeight / 2);
+    }
+
+    float norm = 0.0F;
+    for (const auto value : vector) {
+        norm += value * value;
+    }
+    if (norm > 0.0F) {
+        const auto scale = 1.0F / std::sqrt(norm);
+        for (auto& value : vector) {
+            value *= scale;
+        }
+    }
+    return vector;
+}
+
+void FeatureMatrix::Reserve(std::size_t rows) {
+    for (auto& column : columns_) {
+        column.reserve(rows);
+    }
+    days_.reserve(rows);
+}
+
+void FeatureMatrix::Append(const models::Masterclass& masterclass) {
+    const auto vector = Featurize(masterclass);
+    for (std::size_t d = 0; d < kDimensions; ++d) {
+        columns_[d].push_back(vector[d]);
+    }
+    days_.push_back(
+        ParseEventDay(masterclass.event_date).value_or(kNoDate));
+}
+
+void FeatureMatrix::AppendFrom(const FeatureMatrix& other, std::size_t row) {
+    for (std::size_t d = 0; d < kDimensions; ++d) {
+        columns_[d].push_back(other.columns_[d][row]);
+    }
+    days_.push_back(other.days_[row]);
+}
+
+std::vector<FeatureMatrix::Neighbor> FeatureMatrix::Nearest(
+    std::size_t row, std::size_t k) const {
+    std::vector<Neighbor> result;
+    const auto size = Size();
+    if (row >= size || k == 0) {
+        return result;
+    }
+
+    std::vector<float> scores(size, 0.0F);
+    for (std::size_t d = 0; d < kDimensions; ++d) {
+        const auto weight = columns_[d][row];
+        if (weight == 0.0F) {
+            continue;
+        }
+        const float* column = columns_[d].data();
+        float* out = scores.data();
+        for (std::size_t i = 0; i < size; ++i) {
+            out[i] += weight * column[i];
+        }
+    }
+
+    const auto query_days = days_[row];
+    if (query_days != kNoDate) {
+        for (std::size_t i = 0; i < size; ++i) {
+            if (days_[i] != kNoDate) {
+                const auto distance =
+                    static_cast<float>(std::abs(query_days - days_[i]));
+                scores[i] += kDateWeight / (1.0F + distance / kDateScaleDays);
+            }
+        }
+    }
+
+    // Min-куча из k лучших: корень - худший из оставленных.
+    const auto worse = [](const Neighbor& a, const Neighbor& b) {
+        return a.score > b.score;
+    };
+    result.reserve(k);
+    for (std::size_t i = 0; i < size; ++i) {
+        if (i == row) {
+            continue;
+        }
+        if (result.size() < k) {
+            result.push_back(Neighbor{i, scores[i]});
+            std::push_heap(result.begin(), result.end(), worse);
+        } else if (scores[i] > result.front().score) {
+            std::pop_heap(result.begin(), result.end(), worse);
+            result.back() = Neighbor{i, scores[i]};
+            std::push_heap(result.begin(), result.end(), worse);
+        }
+    }
+
+    std::sort_heap(result.begin(), result.end(), worse);
+    return result;
+}
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,46 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "models/masterclass.hpp"
+
+namespace masterclasses::catalog {
+
+/// Векторы признаков мастер-классов для /mc/similar, строка i соответствует
+/// CatalogSnapshot::rows[i]. Категории, аудитория, теги, формат, компания и
+/// корзина цены хешируются в вектор фиксированной ширины и нормируются, так
+/// что похожесть - скалярное произведение; близость дат добавляется при
+/// запросе. Хранение сплошное, поэтому перебор всех строк векторизуется.
+class FeatureMatrix {
+  public:
+    static constexpr std::size_t kDimensions = 128;
+
+    struct Neighbor {
+        std::size_t row{0};
+        float score{0.0F};
+    };
+
+    void Append(const models::Masterclass& masterclass);
+    /// Переносит уже посчитанную строку из предыдущей версии матрицы.
+    void AppendFrom(const FeatureMatrix& other, std::size_t row);
+    void Reserve(std::size_t rows);
+
+    std::size_t Size() const { return days_.size(); }
+
+    /// До `k` строк, наиболее похожих на `row`, по убыванию похожести;
+    /// сама `row` в выдачу не попадает.
+    std::vector<Neighbor> Nearest(std::size_t row, std::size_t k) const;
+
+  private:
+    using Vector = std::array<float, kDimensions>;
+
+    static Vector Featurize(const models::Masterclass& masterclass);
+
+    std::array<std::vector<float>, kDimensions> columns_;
+    std::vector<std::int32_t> days_;  // дни от эпохи, kNoDate без даты
+};
+
+}  // namespace masterclasses::catalog
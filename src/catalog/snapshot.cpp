@@ -0,0 +1,154 @@
+#include "catalog/snapshot.hpp"
+
+#include <algorithm>
+
+namespace masterclasses::catalog {
+
+std::shared_ptr<const CatalogSnapshot> CatalogSnapshot::Build(
+    std::vector<MasterclassPtr> rows) {
+    std::sort(rows.begin(), rows.end(),
+              [](const MasterclassPtr& a, const MasterclassPtr& b) {
+                  return a->id < b->id;
+              });
+
+    auto snapshot = std::make_shared<CatalogSnapshot>();
+    auto text_index = std::make_shared<TextIndex>();
+    auto features = std::make_shared<FeatureMatrix>();
+    auto columns = std::make_shared<ColumnStore>();
+    snapshot->ids.reserve(rows.size());
+    features->Reserve(rows.size());
+    columns->Reserve(rows.size());
+    for (const auto& row : rows) {
+        snapshot->ids.push_back(row->id);
+        text_index->Add(*row);
+        features->Append(*row);
+        columns->Append(*row);
+    }
+    snapshot->rows = std::move(rows);
+    snapshot->text_index = std::move(text_index);
+    snapshot->features = std::move(features);
+    snapshot->geo = std::make_shared<const GeoGrid>(GeoGrid::Build(*columns));
+    snapshot->columns = std::move(columns);
+    snapshot->permutations = std::make_shared<const SortPermutations>(
+        SortPermutations::Build(snapshot->rows));
+    return snapshot;
+}
+
+std::shared_ptr<const CatalogSnapshot> CatalogSnapshot::Apply(
+    std::vector<MasterclassPtr> upserts,
+    std::vector<std::int64_t> erased) const {
+    const auto by_id = [](const MasterclassPtr& a, const MasterclassPtr& b) {
+        return a->id < b->id;
+    };
+    std::sort(upserts.begin(), upserts.end(), by_id);
+    std::sort(erased.begin(), erased.end());
+
+    auto next = std::make_shared<CatalogSnapshot>();
+    next->version = version + 1;
+    auto index = std::make_shared<TextIndex>(*text_index);
+    // Векторы признаков неизменённых строк копируются, пересчитываются
+    // только upserts.
+    auto next_features = std::make_shared<FeatureMatrix>();
+    // Словари столбцов переходят в новую версию (разделяются, пока не
+    // появится новое значение), чтобы коды неизменённых строк оставались
+    // верными.
+    auto next_columns = std::make_shared<ColumnStore>(columns->EmptyLike());
+    next->rows.reserve(rows.size() + upserts.size());
+    next_features->Reserve(rows.size() + upserts.size());
+    next_columns->Reserve(rows.size() + upserts.size());
+
+    // Для слияния перестановок: куда переехала каждая старая строка и где
+    // лежат добавленные.
+    std::vector<std::int64_t> remap(rows.size(), -1);
+    std::vector<std::uint32_t> added;
+    added.reserve(upserts.size());
+
+    const auto add = [&](MasterclassPtr row) {
+        added.push_back(static_cast<std::uint32_t>(next->rows.size()));
+        index->Add(*row);
+        next_features->Append(*row);
+        next_columns->Append(*row);
+        next->rows.push_back(std::move(row));
+    };
+
+    std::size_t u = 0;
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const auto& row = rows[i];
+        while (u < upserts.size() && upserts[u]->id < row->id) {
+            add(std::move(upserts[u++]));
+        }
+        if (u < upserts.size() && upserts[u]->id == row->id) {
+            index->Remove(*row);
+            next_columns->NoteRemoved(1);
+            add(std::move(upserts[u++]));
+            continue;
+        }
+        if (std::binary_search(erased.begin(), erased.end(), row->id)) {
+            index->Remove(*row);
+            next_columns->NoteRemoved(1);
+            continue;
+        }
+        next_features->AppendFrom(*features, i);
+        next_columns->AppendFrom(*columns, i);
+        remap[i] = static_cast<std::int64_t>(next->rows.size());
+        next->rows.push_back(row);
+    }
+    for (; u < upserts.size(); ++u) {
+        add(std::move(upserts[u]));
+    }
+
+    next->ids.reserve(next->rows.size());
+    for (const auto& row : next->rows) {
+        next->ids.push_back(row->id);
+    }
+    next->text_index = std::move(index);
+    next->features = std::move(next_features);
+    if (next_columns->NeedsCompaction()) {
+        next->columns =
+            std::make_shared<const ColumnStore>(next_columns->Compact());
+    } else {
+        next->columns = std::move(next_columns);
+    }
+    // Сетка - один проход с сортировкой по строкам с координатами, дешевле
+    // остальной работы Apply, поэтому строится заново.
+    next->geo = std::make_shared<const GeoGrid>(GeoGrid::Build(*next->columns));
+    next->permutations = std::make_shared<const SortPermutations>(
+        permutations->Merge(next->rows, remap, std::move(added)));
+    return next;
+}
+
+void CatalogSnapshot::Diff(const std::vector<MasterclassPtr>& fresh,
+                           std::vector<MasterclassPtr>& upserts,
+                           std::vector<std::int64_t>& erased) const {
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while (i < rows.size() || j < fresh.size()) {
+        if (j == fresh.size() ||
+            (i < rows.size() && rows[i]->id < fresh[j]->id)) {
+            erased.push_back(rows[i++]->id);
+        } else if (i == rows.size() || fresh[j]->id < rows[i]->id) {
+            upserts.push_back(fresh[j++]);
+        } else {
+            if (!(*rows[i] == *fresh[j])) {
+                upserts.push_back(fresh[j]);
+            }
+            ++i;
+            ++j;
+        }
+    }
+}
+
+const models::Masterclass* CatalogSnapshot::FindById(std::int64_t id) const {
+    const auto index = IndexOf(id);
+    return index < 0 ? nullptr : rows[static_cast<std::size_t>(index)].get();
+}
+
+std::ptrdiff_t CatalogSnapshot::IndexOf(std::int64_t id) const {
+    const auto it = std::lower_bound(ids.begin(), ids.end(), id);
+    if (it == ids.end() || *it != id) {
+        return -1;
+    }
+    return it - ids.begin();
+}
+
+}  // namespace masterclasses::catalog
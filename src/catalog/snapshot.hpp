@@ -0,0 +1,51 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "catalog/columns.hpp"
+#include "catalog/geo_index.hpp"
+#include "catalog/similarity.hpp"
+#include "catalog/sort_keys.hpp"
+#include "catalog/text_index.hpp"
+#include "models/masterclass.hpp"
+
+namespace masterclasses::catalog {
+
+using MasterclassPtr = std::shared_ptr<const models::Masterclass>;
+
+/// Неизменяемый снимок таблицы masterclasses вместе с индексами над ним.
+/// Изменения каталога публикуют новый снимок, старый живёт, пока его читают.
+struct CatalogSnapshot {
+    std::vector<MasterclassPtr> rows;  // отсортированы по id
+    std::vector<std::int64_t> ids;     // id строк rows, для поиска без разыменования
+    std::shared_ptr<const TextIndex> text_index;
+    std::shared_ptr<const FeatureMatrix> features;  // параллельно rows
+    std::shared_ptr<const ColumnStore> columns;     // параллельно rows
+    std::shared_ptr<const GeoGrid> geo;             // по columns
+    std::shared_ptr<const SortPermutations> permutations;
+    /// Растёт с каждым Apply: производные индексы (подсказки и т.п.)
+    /// по нему понимают, что их пора перестроить.
+    std::uint64_t version{1};
+
+    static std::shared_ptr<const CatalogSnapshot> Build(
+        std::vector<MasterclassPtr> rows);
+
+    /// Копия снимка с применёнными изменениями; индексы обновляются
+    /// инкрементально, только по затронутым строкам.
+    std::shared_ptr<const CatalogSnapshot> Apply(
+        std::vector<MasterclassPtr> upserts,
+        std::vector<std::int64_t> erased) const;
+
+    /// Изменения, превращающие этот снимок в `fresh` (строки по id).
+    void Diff(const std::vector<MasterclassPtr>& fresh,
+              std::vector<MasterclassPtr>& upserts,
+              std::vector<std::int64_t>& erased) const;
+
+    const models::Masterclass* FindById(std::int64_t id) const;
+    /// Позиция строки в rows или -1.
+    std::ptrdiff_t IndexOf(std::int64_t id) const;
+};
+
+}  // namespace masterclasses::catalog
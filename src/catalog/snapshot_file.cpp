@@ -0,0 +1,341 @@
+#include "catalog/snapshot_file.hpp"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <cmath>
+#include <filesystem>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+namespace masterclasses::catalog {
+
+namespace {
+
+constexpr std::array<char, 8> kMagic{'M', 'C', 'S', 'N', 'A', 'P', '\0', '\0'};
+constexpr std::uint32_t kFormatVersion = 1;
+constexpr std::size_t kAlignment = 8;
+
+struct FileHeader {
+    std::array<char, 8> magic;
+    std::uint32_t format_version;
+    std::uint32_t reserved;
+    std::uint64_t layout;  // отпечаток полей Masterclass
+    std::uint64_t row_count;
+    std::uint64_t arena_size;
+    std::uint64_t body_size;
+    std::uint64_t checksum;  // FNV-1a тела
+};
+
+static_assert(sizeof(FileHeader) % kAlignment == 0);
+
+struct StringRef {
+    std::uint32_t offset;
+    std::uint32_t size;
+};
+
+template <typename Member>
+struct FieldOf;
+
+template <typename T>
+struct FieldOf<T models::Masterclass::*> {
+    using Type = T;
+};
+
+template <typename Member>
+using FieldType = typename FieldOf<Member>::Type;
+
+template <typename T>
+constexpr bool kIsString = std::is_same_v<T, std::string>;
+
+/// Необязательные числа хранятся как double, NaN - отсутствие значения.
+template <typename T>
+constexpr bool kIsOptional = std::is_same_v<T, std::optional<double>>;
+
+template <typename T>
+constexpr std::size_t kCellSize = kIsString<T>     ? sizeof(StringRef)
+                                  : kIsOptional<T> ? sizeof(double)
+                                                   : sizeof(T);
+
+constexpr std::uint64_t kFnvOffset = 14695981039346656037ULL;
+constexpr std::uint64_t kFnvPrime = 1099511628211ULL;
+
+std::uint64_t Fnv1a(std::string_view data, std::uint64_t hash = kFnvOffset) {
+    for (const auto c : data) {
+        hash = (hash ^ static_cast<unsigned char>(c)) * kFnvPrime;
+    }
+    return hash;
+}
+
+std::size_t Padded(std::size_t size) {
+    return (size + kAlignment - 1) / kAlignment * kAlignment;
+}
+
+/// Меняется при любом изменении имён, порядка или типов полей.
+std::uint64_t LayoutFingerprint() {
+    std::uint64_t hash = kFnvOffset;
+    models::VisitMasterclassFields([&hash](std::string_view name, auto member) {
+        using T = FieldType<decltype(member)>;
+        hash = Fnv1a(name, hash);
+        const char kind = kIsString<T>                ? 's'
+                          : kIsOptional<T>              ? 'o'
+                          : std::is_floating_point_v<T> ? 'f'
+                                                        : 'i';
+        hash = Fnv1a(std::string_view{&kind, 1}, hash);
+        hash = Fnv1a(std::to_string(kCellSize<T>), hash);
+    });
+    return hash;
+}
+
+std::size_t ColumnsSize(std::size_t row_count) {
+    std::size_t size = 0;
+    models::VisitMasterclassFields([&](std::string_view, auto member) {
+        size += Padded(row_count * kCellSize<FieldType<decltype(member)>>);
+    });
+    return size;
+}
+
+template <typename T>
+void AppendRaw(std::string& out, const T& value) {
+    out.append(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+template <typename T>
+T ReadRaw(const char* data) {
+    T value;
+    std::memcpy(&value, data, sizeof(value));
+    return value;
+}
+
+/// Файл, отображённый в память только для чтения.
+class MappedFile {
+  public:
+    explicit MappedFile(const std::string& path) {
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "open " + path);
+        }
+        struct stat st {};
+        if (::fstat(fd, &st) != 0) {
+            const int error = errno;
+            ::close(fd);
+            throw std::system_error(error, std::generic_category(),
+                                    "stat " + path);
+        }
+        size_ = static_cast<std::size_t>(st.st_size);
+        if (size_ > 0) {
+            data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+        }
+        const int error = errno;
+        ::close(fd);
+        if (data_ == MAP_FAILED) {
+            throw std::system_error(error, std::generic_category(),
+                                    "mmap " + path);
+        }
+    }
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    ~MappedFile() {
+        if (data_ != nullptr) {
+            ::munmap(data_, size_);
+        }
+    }
+
+    std::string_view View() const {
+        return data_ == nullptr
+                   ? std::string_view{}
+                   : std::string_view{static_cast<const char*>(data_), size_};
+    }
+
+  private:
+    void* data_{nullptr};
+    std::size_t size_{0};
+};
+
+/// Дескриптор, закрываемый деструктором.
+class FileDescriptor {
+  public:
+    FileDescriptor(const std::string& path, int flags, mode_t mode = 0)
+        : fd_(::open(path.c_str(), flags | O_CLOEXEC, mode)) {
+        if (fd_ < 0) {
+            throw std::system_error(errno, std::generic_category(),
+                                    "open " + path);
+        }
+    }
+
+    FileDescriptor(const FileDescriptor&) = delete;
+    FileDescriptor& operator=(const FileDescriptor&) = delete;
+
+    ~FileDescriptor() { ::close(fd_); }
+
+    int Get() const { return fd_; }
+
+  private:
+    int fd_;
+};
+
+void WriteAll(int fd, std::string_view data, const std::string& path) {
+    while (!data.empty()) {
+        const auto written = ::write(fd, data.data(), data.size());
+        if (written < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            throw std::system_error(errno, std::generic_category(),
+                                    "write " + path);
+        }
+        data.remove_prefix(static_cast<std::size_t>(written));
+    }
+}
+
+void Sync(int fd, const std::string& path) {
+    if (::fsync(fd) != 0) {
+        throw std::system_error(errno, std::generic_category(),
+                                "fsync " + path);
+    }
+}
+
+}  // namespace
+
+void WriteSnapshotFile(const CatalogSnapshot& snapshot,
+                       const std::string& path) {
+    const auto& rows = snapshot.rows;
+
+    std::string body;
+    body.reserve(ColumnsSize(rows.size()));
+    std::string arena;
+    models::VisitMasterclassFields([&](std::string_view, auto member) {
+        using T = FieldType<decltype(member)>;
+        for (const auto& row : rows) {
+            const auto& value = (*row).*member;
+            if constexpr (kIsString<T>) {
+                if (arena.size() + value.size() >
+                    std::numeric_limits<std::uint32_t>::max()) {
+                    throw std::runtime_error(
+                        "catalog snapshot string arena exceeds 4 GiB");
+                }
+                AppendRaw(body,
+                          StringRef{static_cast<std::uint32_t>(arena.size()),
+                                    static_cast<std::uint32_t>(value.size())});
+                arena.append(value);
+            } else if constexpr (kIsOptional<T>) {
+                AppendRaw(body,
+                          value.value_or(
+                              std::numeric_limits<double>::quiet_NaN()));
+            } else {
+                AppendRaw(body, value);
+            }
+        }
+        body.resize(Padded(body.size()), '\0');
+    });
+    body.append(arena);
+
+    FileHeader header{};
+    header.magic = kMagic;
+    header.format_version = kFormatVersion;
+    header.layout = LayoutFingerprint();
+    header.row_count = rows.size();
+    header.arena_size = arena.size();
+    header.body_size = body.size();
+    header.checksum = Fnv1a(body);
+
+    // fsync временного файла до rename и каталога после: иначе после
+    // сбоя питания под старым именем может оказаться пустой файл, а
+    // сам rename - потеряться.
+    const auto tmp_path = path + ".tmp";
+    {
+        const FileDescriptor out(tmp_path, O_WRONLY | O_CREAT | O_TRUNC,
+                                 0644);
+        WriteAll(out.Get(),
+                 std::string_view{reinterpret_cast<const char*>(&header),
+                                  sizeof(header)},
+                 tmp_path);
+        WriteAll(out.Get(), body, tmp_path);
+        Sync(out.Get(), tmp_path);
+    }
+    std::filesystem::rename(tmp_path, path);
+
+    auto directory = std::filesystem::path{path}.parent_path().string();
+    if (directory.empty()) {
+        directory = ".";
+    }
+    const FileDescriptor dir(directory, O_RDONLY | O_DIRECTORY);
+    Sync(dir.Get(), directory);
+}
+
+std::vector<MasterclassPtr> ReadSnapshotFile(const std::string& path) {
+    const MappedFile file(path);
+    const auto data = file.View();
+
+    if (data.size() < sizeof(FileHeader)) {
+        throw std::runtime_error(path + ": truncated header");
+    }
+    const auto header = ReadRaw<FileHeader>(data.data());
+    if (header.magic != kMagic || header.format_version != kFormatVersion) {
+        throw std::runtime_error(path + ": not a catalog snapshot file");
+    }
+    if (header.layout != LayoutFingerprint()) {
+        throw std::runtime_error(path + ": written for another Masterclass "
+                                        "layout");
+    }
+    const auto body = data.substr(sizeof(FileHeader));
+    const auto columns_size = ColumnsSize(header.row_count);
+    if (body.size() != header.body_size ||
+        header.arena_size > header.body_size ||
+        header.body_size - header.arena_size != columns_size) {
+        throw std::runtime_error(path + ": size mismatch");
+    }
+    if (Fnv1a(body) != header.checksum) {
+        throw std::runtime_error(path + ": checksum mismatch");
+    }
+
+    const auto row_count = static_cast<std::size_t>(header.row_count);
+    const auto arena = body.substr(columns_size);
+    std::vector<models::Masterclass> rows(row_count);
+    std::size_t column = 0;
+    models::VisitMasterclassFields([&](std::string_view, auto member) {
+        using T = FieldType<decltype(member)>;
+        const char* cells = body.data() + column;
+        for (std::size_t i = 0; i < row_count; ++i) {
+            const char* cell = cells + i * kCellSize<T>;
+            if constexpr (kIsString<T>) {
+                const auto ref = ReadRaw<StringRef>(cell);
+                if (std::size_t{ref.offset} + ref.size > arena.size()) {
+                    throw std::runtime_error(path + ": string out of arena");
+                }
+                rows[i].*member = arena.substr(ref.offset, ref.size);
+            } else if constexpr (kIsOptional<T>) {
+                const auto value = ReadRaw<double>(cell);
+                if (!std::isnan(value)) {
+                    rows[i].*member = value;
+                }
+            } else {
+                rows[i].*member = ReadRaw<T>(cell);
+            }
+        }
+        column += Padded(row_count * kCellSize<T>);
+    });
+
+    std::vector<MasterclassPtr> result;
+    result.reserve(row_count);
+    for (auto& row : rows) {
+        result.push_back(
+            std::make_shared<const models::Masterclass>(std::move(row)));
+    }
+    return result;
+}
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "catalog/snapshot.hpp"
+
+namespace masterclasses::catalog {
+
+/// Двоичный файл снимка каталога для холодного старта без Postgres.
+///
+/// Заголовок, затем колонки в порядке VisitMasterclassFields: числовые -
+/// массивы фиксированной ширины, строковые - пары (смещение, длина) в
+/// общую арену строк в конце файла. Каждая колонка выровнена на 8 байт.
+/// Заголовок хранит отпечаток набора полей Masterclass и контрольную сумму
+/// тела, так что файл от другой схемы или недописанный файл отвергается.
+/// Порядок байт родной: это кеш конкретной сборки, а не формат обмена.
+
+/// Пишет rows снимка в `path` атомарно и надёжно: временный файл, fsync,
+/// rename, fsync каталога. Бросает std::runtime_error (std::system_error)
+/// при ошибке записи.
+void WriteSnapshotFile(const CatalogSnapshot& snapshot,
+                       const std::string& path);
+
+/// Отображает файл в память, проверяет заголовок и контрольную сумму и
+/// восстанавливает строки. Это O(N) по строкам и байтам арены: каталогу
+/// нужны собственные Masterclass (он их меняет через Apply), поэтому
+/// колонки копируются, а отображение закрывается сразу после чтения.
+/// Выигрыш по сравнению с Postgres - отсутствие сети, разбора протокола и
+/// запроса, а не чтение без копирования. Бросает std::runtime_error, если
+/// файла нет или он не подходит.
+std::vector<MasterclassPtr> ReadSnapshotFile(const std::string& path);
+
+}  // namespace masterclasses::catalog
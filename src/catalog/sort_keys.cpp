@@ -0,0 +1,140 @@
+#include "catalog/sort_keys.hpp"
+
+#include <algorithm>
+
+namespace masterclasses::catalog {
+
+namespace {
+
+using models::Masterclass;
+
+// Даты - как ORDER BY в select_masterclasses_filtered_date_*.sql.
+
+/// event_date ASC NULLS LAST, id ASC
+bool DateAscLess(const Masterclass& x, const Masterclass& y) {
+    if (x.event_date.empty() != y.event_date.empty()) {
+        return y.event_date.empty();
+    }
+    if (x.event_date != y.event_date) {
+        return x.event_date < y.event_date;
+    }
+    return x.id < y.id;
+}
+
+/// event_date DESC NULLS FIRST, id ASC
+bool DateDescLess(const Masterclass& x, const Masterclass& y) {
+    if (x.event_date.empty() != y.event_date.empty()) {
+        return x.event_date.empty();
+    }
+    if (x.event_date != y.event_date) {
+        return x.event_date > y.event_date;
+    }
+    return x.id < y.id;
+}
+
+bool PriceAscLess(const Masterclass& x, const Masterclass& y) {
+    if (x.price != y.price) {
+        return x.price < y.price;
+    }
+    return x.id < y.id;
+}
+
+bool PriceDescLess(const Masterclass& x, const Masterclass& y) {
+    if (x.price != y.price) {
+        return x.price > y.price;
+    }
+    return x.id < y.id;
+}
+
+bool RatingDescLess(const Masterclass& x, const Masterclass& y) {
+    if (x.rating != y.rating) {
+        return x.rating > y.rating;
+    }
+    return x.id < y.id;
+}
+
+}  // namespace
+
+const std::array<SortKey, kSortKeyCount> kSortKeys = {{
+    {SortOrder::kDateAsc, "date_asc", DateAscLess},
+    {SortOrder::kDateDesc, "date_desc", DateDescLess},
+    {SortOrder::kPriceAsc, "price_asc", PriceAscLess},
+    {SortOrder::kPriceDesc, "price_desc", PriceDescLess},
+    {SortOrder::kRatingDesc, "rating_desc", RatingDescLess},
+}};
+
+std::optional<std::size_t> FindSortKey(SortOrder order) {
+    for (std::size_t i = 0; i < kSortKeys.size(); ++i) {
+        if (kSortKeys[i].order == order) {
+            return i;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<SortOrder> ParseSortOrder(std::string_view name) {
+    if (name == "popular") {
+        return SortOrder::kPopular;
+    }
+    if (name == "distance") {
+        return SortOrder::kDistance;
+    }
+    for (const auto& key : kSortKeys) {
+        if (key.name == name) {
+            return key.order;
+        }
+    }
+    return std::nullopt;
+}
+
+SortPermutations SortPermutations::Build(
+    const std::vector<MasterclassPtr>& rows) {
+    SortPermutations permutations;
+    for (std::size_t k = 0; k < kSortKeys.size(); ++k) {
+        auto& order = permutations.orders_[k];
+        order.resize(rows.size());
+        for (std::size_t i = 0; i < rows.size(); ++i) {
+            order[i] = static_cast<std::uint32_t>(i);
+        }
+        const auto less = kSortKeys[k].less;
+        std::sort(order.begin(), order.end(),
+                  [&rows, less](std::uint32_t a, std::uint32_t b) {
+                      return less(*rows[a], *rows[b]);
+                  });
+    }
+    return permutations;
+}
+
+SortPermutations SortPermutations::Merge(
+    const std::vector<MasterclassPtr>& rows,
+    const std::vector<std::int64_t>& remap,
+    std::vector<std::uint32_t> added) const {
+    SortPermutations permutations;
+    std::vector<std::uint32_t> kept;
+    for (std::size_t k = 0; k < kSortKeys.size(); ++k) {
+        const auto less = kSortKeys[k].less;
+        const auto row_less = [&rows, less](std::uint32_t a, std::uint32_t b) {
+            return less(*rows[a], *rows[b]);
+        };
+
+        // Оставшиеся строки сохраняют взаимный порядок - достаточно
+        // перенумеровать их и слить с отсортированными добавленными.
+        kept.clear();
+        kept.reserve(orders_[k].size());
+        for (const auto old_position : orders_[k]) {
+            const auto position = remap[old_position];
+            if (position >= 0) {
+                kept.push_back(static_cast<std::uint32_t>(position));
+            }
+        }
+        std::sort(added.begin(), added.end(), row_less);
+
+        auto& order = permutations.orders_[k];
+        order.resize(kept.size() + added.size());
+        std::merge(kept.begin(), kept.end(), added.begin(), added.end(),
+                   order.begin(), row_less);
+    }
+    return permutations;
+}
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+#include "models/masterclass.hpp"
+
+namespace masterclasses::catalog {
+
+enum class SortOrder {
+    kId,
+    kRelevance,  ///< BM25 по filter.text, без текста - как kId
+    kPopular,    ///< по PopularityRanking, без рейтинга - как kId
+    kDateAsc,
+    kDateDesc,
+    kPriceAsc,
+    kPriceDesc,
+    kRatingDesc,
+    kDistance,  ///< от filter.near, без точки - как kId
+};
+
+/// Порядок, для которого каталог держит готовую перестановку строк.
+/// Новый порядок - значение SortOrder и строка в kSortKeys.
+struct SortKey {
+    SortOrder order;
+    std::string_view name;  ///< значение параметра sort_order
+    /// Строгий порядок; при равенстве ключа обязан сравнивать id.
+    bool (*less)(const models::Masterclass&, const models::Masterclass&);
+};
+
+inline constexpr std::size_t kSortKeyCount = 5;
+extern const std::array<SortKey, kSortKeyCount> kSortKeys;
+
+/// Позиция в kSortKeys или nullopt для порядков без перестановки.
+std::optional<std::size_t> FindSortKey(SortOrder order);
+
+/// sort_order -> SortOrder: имена из kSortKeys, "popular" и "distance".
+std::optional<SortOrder> ParseSortOrder(std::string_view name);
+
+/// Перестановки snapshot.rows по каждому ключу из kSortKeys: позиции строк
+/// в порядке сортировки.
+class SortPermutations {
+  public:
+    using MasterclassPtr = std::shared_ptr<const models::Masterclass>;
+
+    static SortPermutations Build(const std::vector<MasterclassPtr>& rows);
+
+    /// Перестановки для новой версии rows без полной сортировки. `remap[i]` -
+    /// новая позиция старой строки i или -1, если строка удалена или
+    /// заменена; `added` - позиции новых и заменённых строк в `rows`.
+    SortPermutations Merge(const std::vector<MasterclassPtr>& rows,
+                           const std::vector<std::int64_t>& remap,
+                           std::vector<std::uint32_t> added) const;
+
+    const std::vector<std::uint32_t>& Get(std::size_t key) const {
+        return orders_[key];
+    }
+
+  private:
+    std::array<std::vector<std::uint32_t>, kSortKeyCount> orders_;
+};
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,300 @@
+#include "catalog/suggest_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <queue>
+#include <tuple>
+#include <unordered_set>
+
+#include "catalog/text_normalizer.hpp"
+
+namespace masterclasses::catalog {
+
+namespace {
+
+/// Глубже ключи не индексируются: автодополнение длинных строк не нужно,
+/// а арена остаётся компактной.
+constexpr std::size_t kMaxKeyLength = 48;
+constexpr std::size_t kMinWordLength = 3;
+
+struct Aggregate {
+    std::string text;
+    std::uint32_t weight{0};
+};
+
+std::string_view Trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+        s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+        s.remove_suffix(1);
+    return s;
+}
+
+}  // namespace
+
+std::string_view SuggestIndex::KindName(Kind kind) {
+    switch (kind) {
+        case Kind::kTitle:
+            return "title";
+        case Kind::kOrganizer:
+            return "organizer";
+        case Kind::kCategory:
+            return "category";
+        case Kind::kTag:
+            return "tag";
+        case Kind::kWord:
+            return "word";
+    }
+    return "unknown";
+}
+
+SuggestIndex SuggestIndex::Build(const CatalogSnapshot& snapshot,
+                                 const PopularityRanking* popularity) {
+    std::map<std::pair<std::u16string, Kind>, Aggregate> aggregated;
+    // Вклад текущей строки: сама строка плюс её очки популярности.
+    std::uint32_t row_weight = 1;
+    const auto add = [&aggregated, &row_weight](std::string_view text,
+                                                Kind kind) {
+        text = Trim(text);
+        auto key = NormalizePhrase(text);
+        if (key.empty()) {
+            return;
+        }
+        if (key.size() > kMaxKeyLength) {
+            key.resize(kMaxKeyLength);
+        }
+        auto& slot = aggregated[{std::move(key), kind}];
+        if (slot.weight == 0) {
+            slot.text = std::string{text};
+        }
+        slot.weight += row_weight;
+    };
+    const auto add_list = [&add](std::string_view list, Kind kind) {
+        while (!list.empty()) {
+            const auto comma = list.find(',');
+            add(list.substr(0, comma), kind);
+            if (comma == std::string_view::npos) {
+                break;
+            }
+            list.remove_prefix(comma + 1);
+        }
+    };
+
+    for (const auto& row : snapshot.rows) {
+        row_weight = 1;
+        if (popularity != nullptr) {
+            row_weight += static_cast<std::uint32_t>(
+                std::lround(popularity->ScoreOf(row->id)));
+        }
+        add(row->title, Kind::kTitle);
+        add(row->organizer, Kind::kOrganizer);
+        add_list(row->category, Kind::kCategory);
+        add_list(row->additional_tags, Kind::kTag);
+
+        // Отдельные слова названия: "круг" находит "Гончарный круг".
+        const auto title_key = NormalizePhrase(row->title);
+        std::unordered_set<std::u16string> seen_words;
+        std::size_t start = 0;
+        while (start < title_key.size()) {
+            auto end = title_key.find(u' ', start);
+            if (end == std::u16string::npos) {
+                end = title_key.size();
+            }
+            auto word = title_key.substr(start, end - start);
+            if (start > 0 && word.size() >= kMinWordLength &&
+                seen_words.insert(word).second) {
+                auto& slot = aggregated[{std::move(word), Kind::kWord}];
+                slot.weight += row_weight;
+            }
+            start = end + 1;
+        }
+    }
+
+    SuggestIndex index;
+    index.entries_.reserve(aggregated.size());
+    for (auto& [key, aggregate] : aggregated) {
+        Entry entry;
+        entry.key_offset = static_cast<std::uint32_t>(index.key_arena_.size());
+        entry.key_length = static_cast<std::uint32_t>(key.first.size());
+        entry.kind = key.second;
+        entry.weight = aggregate.weight;
+        entry.text_index = static_cast<std::uint32_t>(index.texts_.size());
+        index.key_arena_ += key.first;
+        if (aggregate.text.empty()) {
+            // Слово названия показываем в нормализованном виде.
+            std::string text;
+            for (const auto c : key.first) {
+                if (c < 0x80) {
+                    text.push_back(static_cast<char>(c));
+                } else {
+                    text.push_back(static_cast<char>(0xC0 | (c >> 6)));
+                    text.push_back(static_cast<char>(0x80 | (c & 0x3F)));
+                }
+            }
+            aggregate.text = std::move(text);
+        }
+        index.texts_.push_back(std::move(aggregate.text));
+        index.entries_.push_back(entry);
+    }
+    // std::map уже отсортирован по (ключ, kind) - порядок ключей сохранён.
+
+    const auto n = index.entries_.size();
+    index.max_tree_.assign(2 * n, 0);
+    for (std::size_t i = 0; i < n; ++i) {
+        index.max_tree_[n + i] = static_cast<std::uint32_t>(i);
+    }
+    for (std::size_t i = n; i-- > 1;) {
+        const auto left = index.max_tree_[2 * i];
+        const auto right = index.max_tree_[2 * i + 1];
+        index.max_tree_[i] =
+            index.entries_[left].weight >= index.entries_[right].weight ? left
+                                                                        : right;
+    }
+    return index;
+}
+
+std::u16string_view SuggestIndex::KeyOf(std::uint32_t entry) const {
+    const auto& e = entries_[entry];
+    return std::u16string_view{key_arena_}.substr(e.key_offset, e.key_length);
+}
+
+char16_t SuggestIndex::CharAt(std::uint32_t entry, std::size_t depth) const {
+    return key_arena_[entries_[entry].key_offset + depth];
+}
+
+std::uint32_t SuggestIndex::ArgMax(std::uint32_t begin,
+                                   std::uint32_t end) const {
+    const auto n = static_cast<std::uint32_t>(entries_.size());
+    std::uint32_t best = begin;
+    for (auto l = begin + n, r = end + n; l < r; l >>= 1, r >>= 1) {
+        if (l & 1) {
+            const auto candidate = max_tree_[l++];
+            if (entries_[candidate].weight > entries_[best].weight) {
+                best = candidate;
+            }
+        }
+        if (r & 1) {
+            const auto candidate = max_tree_[--r];
+            if (entries_[candidate].weight > entries_[best].weight) {
+                best = candidate;
+            }
+        }
+    }
+    return best;
+}
+
+void SuggestIndex::TopK(const Range& range, std::size_t limit,
+                        std::vector<std::uint32_t>& out) const {
+    // (вес, запись, начало, конец): достаём максимум и делим диапазон.
+    using Item =
+        std::tuple<std::uint32_t, std::uint32_t, std::uint32_t, std::uint32_t>;
+    std::priority_queue<Item> queue;
+    const auto push = [&](std::uint32_t begin, std::uint32_t end) {
+        if (begin < end) {
+            const auto best = ArgMax(begin, end);
+            queue.emplace(entries_[best].weight, best, begin, end);
+        }
+    };
+    push(range.begin, range.end);
+    for (std::size_t taken = 0; taken < limit && !queue.empty(); ++taken) {
+        const auto [weight, best, begin, end] = queue.top();
+        queue.pop();
+        out.push_back(best);
+        push(begin, best);
+        push(best + 1, end);
+    }
+}
+
+void SuggestIndex::Walk(std::uint32_t begin, std::uint32_t end,
+                        std::size_t depth, std::u16string_view prefix,
+                        const std::vector<std::uint32_t>& row,
+                        std::uint32_t max_edits,
+                        std::vector<Range>& matches) const {
+    // Ключи длины depth в диапазоне стоят первыми - у них нет продолжения.
+    auto child = begin;
+    while (child < end && entries_[child].key_length <= depth) {
+        ++child;
+    }
+
+    std::vector<std::uint32_t> next(row.size());
+    while (child < end) {
+        const auto c = CharAt(child, depth);
+        auto first = entries_.begin() + child;
+        const auto child_end = static_cast<std::uint32_t>(
+            std::partition_point(first, entries_.begin() + end,
+                                 [&](const Entry& e) {
+                                     return key_arena_[e.key_offset + depth] ==
+                                            c;
+                                 }) -
+            entries_.begin());
+
+        next[0] = row[0] + 1;
+        auto row_min = next[0];
+        for (std::size_t i = 1; i < row.size(); ++i) {
+            const auto substitution = row[i - 1] + (prefix[i - 1] != c ? 1 : 0);
+            next[i] = std::min({row[i] + 1, next[i - 1] + 1, substitution});
+            row_min = std::min(row_min, next[i]);
+        }
+
+        if (next.back() <= max_edits) {
+            matches.push_back(Range{child, child_end, next.back()});
+        }
+        // Глубже может найтись совпадение с меньшим числом правок.
+        if (row_min <= max_edits && row_min < next.back()) {
+            Walk(child, child_end, depth + 1, prefix, next, max_edits,
+                 matches);
+        }
+        child = child_end;
+    }
+}
+
+std::vector<SuggestIndex::Suggestion> SuggestIndex::Lookup(
+    std::string_view prefix, std::size_t limit, std::uint32_t max_edits) const {
+    std::vector<Suggestion> result;
+    const auto key = NormalizePhrase(prefix);
+    if (key.empty() || entries_.empty() || limit == 0) {
+        return result;
+    }
+
+    std::vector<std::uint32_t> row(key.size() + 1);
+    for (std::size_t i = 0; i < row.size(); ++i) {
+        row[i] = static_cast<std::uint32_t>(i);
+    }
+    std::vector<Range> matches;
+    Walk(0, static_cast<std::uint32_t>(entries_.size()), 0, key, row,
+         max_edits, matches);
+
+    std::vector<std::pair<std::uint32_t, std::uint32_t>> candidates;
+    std::vector<std::uint32_t> top;
+    for (const auto& range : matches) {
+        top.clear();
+        TopK(range, limit, top);
+        for (const auto entry : top) {
+            candidates.emplace_back(range.edits, entry);
+        }
+    }
+    std::sort(candidates.begin(), candidates.end(),
+              [this](const auto& a, const auto& b) {
+                  if (a.first != b.first) {
+                      return a.first < b.first;
+                  }
+                  return entries_[a.second].weight > entries_[b.second].weight;
+              });
+
+    std::unordered_set<std::string_view> seen_texts;
+    for (const auto& [edits, entry] : candidates) {
+        if (result.size() >= limit) {
+            break;
+        }
+        const auto& e = entries_[entry];
+        const auto& text = texts_[e.text_index];
+        if (!seen_texts.insert(text).second) {
+            continue;
+        }
+        result.push_back(Suggestion{text, e.kind, e.weight, edits});
+    }
+    return result;
+}
+
+}  // namespace masterclasses::catalog
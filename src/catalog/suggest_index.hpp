@@ -0,0 +1,84 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "catalog/popularity.hpp"
+#include "catalog/snapshot.hpp"
+
+namespace masterclasses::catalog {
+
+/// Префиксный индекс для автодополнения по title, organizer, category,
+/// additional_tags и словам названий. Ключи лежат отсортированными в одной
+/// UTF-16 арене и образуют неявный trie: узел - диапазон ключей с общим
+/// префиксом. Поверх весов построено дерево отрезков, поэтому top-k по
+/// популярности в диапазоне стоит O(k log n) без хранения списков в узлах.
+/// Вес значения - сумма по мастер-классам, где оно встречается, единицы и
+/// очков популярности (добавления в избранное, PopularityRanking).
+class SuggestIndex {
+  public:
+    enum class Kind : std::uint8_t {
+        kTitle,
+        kOrganizer,
+        kCategory,
+        kTag,
+        kWord,
+    };
+
+    struct Suggestion {
+        std::string text;
+        Kind kind{Kind::kTitle};
+        std::uint32_t weight{0};
+        std::uint32_t edits{0};
+    };
+
+    /// `popularity` может быть nullptr - тогда вес равен числу
+    /// мастер-классов со значением.
+    static SuggestIndex Build(const CatalogSnapshot& snapshot,
+                              const PopularityRanking* popularity);
+
+    /// До `limit` подсказок, начинающихся с `prefix` с точностью до
+    /// `max_edits` правок (Левенштейн); сначала меньше правок, затем вес.
+    std::vector<Suggestion> Lookup(std::string_view prefix, std::size_t limit,
+                                   std::uint32_t max_edits) const;
+
+    std::size_t EntryCount() const { return entries_.size(); }
+
+    static std::string_view KindName(Kind kind);
+
+  private:
+    struct Entry {
+        std::uint32_t key_offset{0};
+        std::uint32_t key_length{0};
+        std::uint32_t text_index{0};
+        std::uint32_t weight{0};
+        Kind kind{Kind::kTitle};
+    };
+
+    struct Range {
+        std::uint32_t begin{0};
+        std::uint32_t end{0};
+        std::uint32_t edits{0};
+    };
+
+    std::u16string_view KeyOf(std::uint32_t entry) const;
+    char16_t CharAt(std::uint32_t entry, std::size_t depth) const;
+
+    void Walk(std::uint32_t begin, std::uint32_t end, std::size_t depth,
+              std::u16string_view prefix, const std::vector<std::uint32_t>& row,
+              std::uint32_t max_edits, std::vector<Range>& matches) const;
+
+    /// Индекс записи с максимальным весом в [begin, end).
+    std::uint32_t ArgMax(std::uint32_t begin, std::uint32_t end) const;
+    void TopK(const Range& range, std::size_t limit,
+              std::vector<std::uint32_t>& out) const;
+
+    std::u16string key_arena_;
+    std::vector<Entry> entries_;  // отсортированы по ключу
+    std::vector<std::string> texts_;
+    std::vector<std::uint32_t> max_tree_;  // дерево отрезков argmax по весу
+};
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,160 @@
+#include "catalog/text_index.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <map>
+
+#include "catalog/text_normalizer.hpp"
+
+namespace masterclasses::catalog {
+
+namespace {
+
+constexpr double kK1 = 1.2;
+constexpr double kB = 0.75;
+
+/// Вес поля - сколько раз терм поля засчитывается в term frequency.
+constexpr std::uint32_t kTitleWeight = 3;
+constexpr std::uint32_t kTagsWeight = 2;
+constexpr std::uint32_t kOrganizerWeight = 2;
+constexpr std::uint32_t kDescriptionWeight = 1;
+
+struct DocumentTerms {
+    std::map<std::string, std::uint32_t> frequencies;
+    std::uint32_t length{0};
+};
+
+DocumentTerms CollectTerms(const models::Masterclass& mc) {
+    DocumentTerms doc;
+    const auto add_field = [&doc](std::string_view text, std::uint32_t weight) {
+        for (auto& term : NormalizeText(text)) {
+            doc.frequencies[std::move(term)] += weight;
+            doc.length += weight;
+        }
+    };
+    add_field(mc.title, kTitleWeight);
+    add_field(mc.additional_tags, kTagsWeight);
+    add_field(mc.organizer, kOrganizerWeight);
+    add_field(mc.description, kDescriptionWeight);
+    return doc;
+}
+
+}  // namespace
+
+TextIndex::PostingList& TextIndex::MutableList(
+    std::shared_ptr<PostingList>& list) {
+    if (!list) {
+        list = std::make_shared<PostingList>();
+    } else if (list.use_count() > 1) {
+        list = std::make_shared<PostingList>(*list);
+    }
+    return *list;
+}
+
+void TextIndex::Add(const models::Masterclass& masterclass) {
+    const auto doc = CollectTerms(masterclass);
+    for (const auto& [term, frequency] : doc.frequencies) {
+        auto& list = MutableList(postings_[term]);
+        const Posting posting{masterclass.id, frequency, doc.length};
+        if (list.empty() || list.back().id < masterclass.id) {
+            list.push_back(posting);
+            continue;
+        }
+        auto it = std::lower_bound(
+            list.begin(), list.end(), masterclass.id,
+            [](const Posting& p, std::int64_t id) { return p.id < id; });
+        list.insert(it, posting);
+    }
+    ++document_count_;
+    total_length_ += doc.length;
+}
+
+void TextIndex::Remove(const models::Masterclass& masterclass) {
+    const auto doc = CollectTerms(masterclass);
+    for (const auto& [term, frequency] : doc.frequencies) {
+        auto slot = postings_.find(term);
+        if (slot == postings_.end()) {
+            continue;
+        }
+        const auto& shared = *slot->second;
+        auto found = std::lower_bound(
+            shared.begin(), shared.end(), masterclass.id,
+            [](const Posting& p, std::int64_t id) { return p.id < id; });
+        if (found == shared.end() || found->id != masterclass.id) {
+            continue;
+        }
+        const auto offset = found - shared.begin();
+        auto& list = MutableList(slot->second);
+        list.erase(list.begin() + offset);
+        if (list.empty()) {
+            postings_.erase(slot);
+        }
+    }
+    --document_count_;
+    total_length_ -= doc.length;
+}
+
+std::vector<TextIndex::Hit> TextIndex::Search(std::string_view query) const {
+    std::vector<Hit> hits;
+    if (document_count_ == 0) {
+        return hits;
+    }
+
+    auto terms = NormalizeText(query);
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+
+    struct Cursor {
+        const PostingList* list;
+        std::size_t pos;
+        double idf;
+    };
+    std::vector<Cursor> cursors;
+    for (const auto& term : terms) {
+        auto it = postings_.find(term);
+        if (it == postings_.end()) {
+            continue;
+        }
+        const auto df = static_cast<double>(it->second->size());
+        const auto n = static_cast<double>(document_count_);
+        const double idf = std::log(1.0 + (n - df + 0.5) / (df + 0.5));
+        cursors.push_back(Cursor{it->second.get(), 0, idf});
+    }
+
+    const double avg_length =
+        static_cast<double>(total_length_) / document_count_;
+
+    // Слияние отсортированных по id списков: термов в запросе единицы,
+    // поэтому линейный выбор минимума дешевле кучи.
+    while (true) {
+        auto min_id = std::numeric_limits<std::int64_t>::max();
+        for (const auto& cursor : cursors) {
+            if (cursor.pos < cursor.list->size()) {
+                min_id = std::min(min_id, (*cursor.list)[cursor.pos].id);
+            }
+        }
+        if (min_id == std::numeric_limits<std::int64_t>::max()) {
+            break;
+        }
+        double score = 0.0;
+        for (auto& cursor : cursors) {
+            if (cursor.pos >= cursor.list->size()) {
+                continue;
+            }
+            const auto& posting = (*cursor.list)[cursor.pos];
+            if (posting.id != min_id) {
+                continue;
+            }
+            const double tf = posting.term_frequency;
+            const double norm =
+                kK1 * (1.0 - kB + kB * posting.document_length / avg_length);
+            score += cursor.idf * tf * (kK1 + 1.0) / (tf + norm);
+            ++cursor.pos;
+        }
+        hits.push_back(Hit{min_id, score});
+    }
+    return hits;
+}
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+#include "models/masterclass.hpp"
+
+namespace masterclasses::catalog {
+
+/// Инвертированный индекс по title, description, organizer и
+/// additional_tags с ранжированием BM25. Списки словопозиций разделяются
+/// между копиями индекса: Add/Remove клонирует список, только если на него
+/// ещё кто-то ссылается, так что копия + правка одного документа стоит
+/// копирования затронутых списков, а не всего индекса.
+class TextIndex {
+  public:
+    struct Hit {
+        std::int64_t id{0};
+        double score{0.0};
+    };
+
+    void Add(const models::Masterclass& masterclass);
+    /// `masterclass` - ровно та версия строки, что была добавлена.
+    void Remove(const models::Masterclass& masterclass);
+
+    /// Документы, содержащие хотя бы один терм запроса, по возрастанию id.
+    std::vector<Hit> Search(std::string_view query) const;
+
+    std::size_t TermCount() const { return postings_.size(); }
+    std::size_t DocumentCount() const { return document_count_; }
+
+  private:
+    struct Posting {
+        std::int64_t id{0};
+        std::uint32_t term_frequency{0};
+        std::uint32_t document_length{0};
+    };
+    using PostingList = std::vector<Posting>;
+
+    /// Список под use_count() == 1 принадлежит только этому индексу.
+    PostingList& MutableList(std::shared_ptr<PostingList>& list);
+
+    std::unordered_map<std::string, std::shared_ptr<PostingList>> postings_;
+    std::size_t document_count_{0};
+    std::uint64_t total_length_{0};
+};
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,173 @@
+#include "catalog/text_normalizer.hpp"
+
+#include <algorithm>
+#include <iterator>
+
+namespace masterclasses::catalog {
+
+namespace {
+
+constexpr std::size_t kMinTokenLength = 2;
+constexpr std::size_t kMinStemLength = 3;
+
+/// Окончания прилагательных, существительных и глаголов; порядок -
+/// от длинных к коротким, срезается первое совпавшее.
+constexpr std::u32string_view kEndings[] = {
+    U"ейшими", U"ейшего", U"иями", U"ться", U"ами", U"ями", U"ией", U"иям",
+    U"ием", U"иях", U"ого", U"его", U"ому", U"ему", U"ыми", U"ими", U"ешь",
+    U"ете", U"тся", U"ать", U"ять", U"ить", U"еть", U"ая", U"яя", U"ое",
+    U"ее", U"ые", U"ие", U"ый", U"ий", U"ой", U"ей", U"ых", U"их", U"ую",
+    U"юю", U"ом", U"ем", U"ах", U"ях", U"ам", U"ям", U"ов", U"ев", U"ию",
+    U"ия", U"ью", U"ья", U"ы", U"и", U"а", U"я", U"о", U"е", U"у", U"ю",
+    U"ь", U"й",
+};
+
+constexpr std::u32string_view kStopWords[] = {
+    U"в",   U"во",  U"на",  U"с",   U"со",  U"по",  U"для", U"к",  U"ко",
+    U"о",   U"об",  U"от",  U"из",  U"у",   U"за",  U"и",   U"а",  U"но",
+    U"или", U"не",  U"the", U"and", U"of",  U"for", U"to",  U"in",
+};
+
+/// Декодирует один символ UTF-8; на битых байтах возвращает U+FFFD.
+char32_t DecodeUtf8(std::string_view text, std::size_t& pos) {
+    const auto lead = static_cast<unsigned char>(text[pos++]);
+    if (lead < 0x80) {
+        return lead;
+    }
+    int extra = 0;
+    char32_t cp = 0;
+    if ((lead & 0xE0) == 0xC0) {
+        extra = 1;
+        cp = lead & 0x1F;
+    } else if ((lead & 0xF0) == 0xE0) {
+        extra = 2;
+        cp = lead & 0x0F;
+    } else if ((lead & 0xF8) == 0xF0) {
+        extra = 3;
+        cp = lead & 0x07;
+    } else {
+        return 0xFFFD;
+    }
+    for (int i = 0; i < extra; ++i) {
+        if (pos >= text.size() ||
+            (static_cast<unsigned char>(text[pos]) & 0xC0) != 0x80) {
+            return 0xFFFD;
+        }
+        cp = (cp << 6) | (static_cast<unsigned char>(text[pos++]) & 0x3F);
+    }
+    return cp;
+}
+
+void AppendUtf8(std::string& out, char32_t cp) {
+    if (cp < 0x80) {
+        out.push_back(static_cast<char>(cp));
+    } else if (cp < 0x800) {
+        out.push_back(static_cast<char>(0xC0 | (cp >> 6)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else if (cp < 0x10000) {
+        out.push_back(static_cast<char>(0xE0 | (cp >> 12)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    } else {
+        out.push_back(static_cast<char>(0xF0 | (cp >> 18)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 12) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | ((cp >> 6) & 0x3F)));
+        out.push_back(static_cast<char>(0x80 | (cp & 0x3F)));
+    }
+}
+
+bool IsCyrillic(char32_t cp) { return cp >= 0x0430 && cp <= 0x044F; }
+
+/// Приводит символ к нижнему регистру; 0 - символ не входит в слово.
+char32_t FoldChar(char32_t cp) {
+    if (cp >= U'a' && cp <= U'z') {
+        return cp;
+    }
+    if (cp >= U'0' && cp <= U'9') {
+        return cp;
+    }
+    if (cp >= U'A' && cp <= U'Z') {
+        return cp + (U'a' - U'A');
+    }
+    if (cp >= 0x0410 && cp <= 0x042F) {
+        return cp + 0x20;
+    }
+    if (cp >= 0x0430 && cp <= 0x044F) {
+        return cp;
+    }
+    if (cp == 0x0401 || cp == 0x0451) {
+        return U'е';
+    }
+    return 0;
+}
+
+bool EndsWith(std::u32string_view word, std::u32string_view ending) {
+    return word.size() >= ending.size() &&
+           word.substr(word.size() - ending.size()) == ending;
+}
+
+void Stem(std::u32string& word) {
+    if (word.empty() || !IsCyrillic(word.back())) {
+        return;
+    }
+    for (const auto ending : kEndings) {
+        if (EndsWith(word, ending) &&
+            word.size() - ending.size() >= kMinStemLength) {
+            word.resize(word.size() - ending.size());
+            return;
+        }
+    }
+}
+
+void Flush(std::u32string& word, std::vector<std::string>& terms) {
+    if (word.size() >= kMinTokenLength &&
+        std::find(std::begin(kStopWords), std::end(kStopWords), word) ==
+            std::end(kStopWords)) {
+        Stem(word);
+        std::string term;
+        term.reserve(word.size() * 2);
+        for (const auto cp : word) {
+            AppendUtf8(term, cp);
+        }
+        terms.push_back(std::move(term));
+    }
+    word.clear();
+}
+
+}  // namespace
+
+std::vector<std::string> NormalizeText(std::string_view text) {
+    std::vector<std::string> terms;
+    std::u32string word;
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        const auto folded = FoldChar(DecodeUtf8(text, pos));
+        if (folded == 0) {
+            Flush(word, terms);
+        } else {
+            word.push_back(folded);
+        }
+    }
+    Flush(word, terms);
+    return terms;
+}
+
+std::u16string NormalizePhrase(std::string_view text) {
+    std::u16string phrase;
+    phrase.reserve(text.size());
+    std::size_t pos = 0;
+    while (pos < text.size()) {
+        const auto folded = FoldChar(DecodeUtf8(text, pos));
+        if (folded != 0) {
+            phrase.push_back(static_cast<char16_t>(folded));
+        } else if (!phrase.empty() && phrase.back() != u' ') {
+            phrase.push_back(u' ');
+        }
+    }
+    if (!phrase.empty() && phrase.back() == u' ') {
+        phrase.pop_back();
+    }
+    return phrase;
+}
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace masterclasses::catalog {
+
+/// Разбивает текст на термы для полнотекстового поиска: нижний регистр
+/// (кириллица и латиница), ё -> е, лёгкий стемминг русских окончаний,
+/// без коротких токенов и служебных слов. Термы - UTF-8.
+std::vector<std::string> NormalizeText(std::string_view text);
+
+/// Ключ для префиксного поиска: нижний регистр, ё -> е, всё, что не буква
+/// и не цифра, схлопывается в один пробел. Без стемминга и стоп-слов.
+std::u16string NormalizePhrase(std::string_view text);
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,341 @@
+#include "components/admission_control.hpp"
+#include "components/request_traces.hpp"
+
+#include <algorithm>
+#include <mutex>
+#include <optional>
+#include <utility>
+
+#include <userver/components/statistics_storage.hpp>
+#include <userver/engine/deadline.hpp>
+#include <userver/formats/json/inline.hpp>
+#include <userver/formats/json/serialize.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/server/http/http_status.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace masterclasses::components {
+
+namespace {
+
+constexpr std::chrono::milliseconds kDefaultLatencyTarget{100};
+constexpr std::chrono::seconds kDefaultAdjustPeriod{1};
+constexpr std::chrono::seconds kDefaultRetryAfter{1};
+constexpr double kDefaultMinLimit = 4;
+constexpr double kDefaultMaxLimit = 64;
+constexpr std::int64_t kDefaultMaxQueue = 32;
+constexpr std::chrono::milliseconds kDefaultQueueTimeout{500};
+
+/// Уменьшение лимита при превышении цели и шаг роста, пока укладываемся.
+constexpr double kDecreaseFactor = 0.9;
+constexpr double kIncreaseStep = 1.0;
+
+constexpr std::array<std::string_view, 3> kPriorityNames{
+    "critical", "normal", "background"};
+
+AdmissionControl::Priority ParsePriority(const std::string& name) {
+    if (name == "critical") {
+        return AdmissionControl::Priority::kCritical;
+    }
+    if (name == "background") {
+        return AdmissionControl::Priority::kBackground;
+    }
+    return AdmissionControl::Priority::kNormal;
+}
+
+}  // namespace
+
+AdmissionControl::Ticket::Ticket(AdmissionControl* owner, HandlerState* state,
+                                 Rejection rejection)
+    : owner_(owner),
+      state_(state),
+      rejection_(rejection) {
+    if (auto* trace = RequestTraces::Trace::Current()) {
+        trace->Mark("admission");
+    }
+}
+
+AdmissionControl::Ticket::Ticket(Ticket&& other) noexcept
+    : owner_(std::exchange(other.owner_, nullptr)),
+      state_(other.state_),
+      rejection_(other.rejection_) {}
+
+AdmissionControl::Ticket::~Ticket() {
+    if (owner_ != nullptr && Admitted()) {
+        owner_->Release(*state_);
+    }
+}
+
+AdmissionControl::AdmissionControl(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : ComponentBase(config, context),
+      latency_target_(config["latency-target"].As<std::chrono::milliseconds>(
+          kDefaultLatencyTarget)),
+      min_limit_(config["min-limit"].As<double>(kDefaultMinLimit)),
+      max_limit_(config["max-limit"].As<double>(kDefaultMaxLimit)),
+      retry_after_(
+          config["retry-after"].As<std::chrono::seconds>(kDefaultRetryAfter)),
+      shares_{config["class-shares"]["critical"].As<double>(1.0),
+              config["class-shares"]["normal"].As<double>(0.8),
+              config["class-shares"]["background"].As<double>(0.5)},
+      limit_(max_limit_) {
+    const auto& handlers = config["handlers"];
+    for (auto it = handlers.begin(); it != handlers.end(); ++it) {
+        auto& state = handlers_[it.GetName()];
+        const auto& handler = *it;
+        state.priority =
+            ParsePriority(handler["class"].As<std::string>("normal"));
+        state.max_concurrency = handler["max-concurrency"].As<std::int64_t>(0);
+        state.max_queue =
+            handler["max-queue"].As<std::int64_t>(kDefaultMaxQueue);
+        state.queue_timeout =
+            handler["queue-timeout"].As<std::chrono::milliseconds>(
+                kDefaultQueueTimeout);
+        state.feeds_limit = handler["feeds-limit"].As<bool>(true);
+    }
+    default_state_.max_queue = kDefaultMaxQueue;
+    default_state_.queue_timeout = kDefaultQueueTimeout;
+
+    const auto period = config["adjust-period"].As<std::chrono::milliseconds>(
+        kDefaultAdjustPeriod);
+    adjust_task_.Start("admission-control-adjust",
+                       userver::utils::PeriodicTask::Settings{period},
+                       [this] { AdjustLimit(); });
+
+    statistics_holder_ =
+        context.FindComponent<userver::components::StatisticsStorage>()
+            .GetStorage()
+            .RegisterWriter(
+                "masterclasses.admission",
+                [this](userver::utils::statistics::Writer& writer) {
+                    writer["limit"] = limit_.load();
+                    for (std::size_t i = 0; i < kPriorities; ++i) {
+                        writer["db-latency-us"].ValueWithLabels(
+                            db_latency_[i].last_average_us.load(),
+                            {"class", kPriorityNames[i]});
+                    }
+                    for (const auto& [name, state] : handlers_) {
+                        const userver::utils::statistics::LabelView label{
+                            "handler", name};
+                        writer["admitted"].ValueWithLabels(
+                            state.admitted.load(), label);
+                        writer["queued"].ValueWithLabels(state.waited.load(),
+                                                         label);
+                        writer["shed-queue-full"].ValueWithLabels(
+                            state.shed_queue_full.load(), label);
+                        writer["shed-timeout"].ValueWithLabels(
+                            state.shed_timeout.load(), label);
+                    }
+                });
+}
+
+AdmissionControl::~AdmissionControl() {
+    statistics_holder_.Unregister();
+    adjust_task_.Stop();
+}
+
+AdmissionControl::HandlerState& AdmissionControl::StateFor(
+    std::string_view handler_name) {
+    const auto it = handlers_.find(handler_name);
+    return it == handlers_.end() ? default_state_ : it->second;
+}
+
+std::int64_t AdmissionControl::LimitFor(Priority priority) const {
+    const auto share = shares_[static_cast<std::size_t>(priority)];
+    return std::max<std::int64_t>(
+        1, static_cast<std::int64_t>(limit_.load() * share));
+}
+
+AdmissionControl::Ticket AdmissionControl::Admit(
+    std::string_view handler_name) {
+    auto& state = StateFor(handler_name);
+    const auto can_run = [&] {
+        return total_in_flight_ < LimitFor(state.priority) &&
+               (state.max_concurrency == 0 ||
+                state.in_flight < state.max_concurrency);
+    };
+
+    std::unique_lock lock(mutex_);
+    if (!can_run()) {
+        // Классам пониже достаётся меньшая доля лимита: под нагрузкой
+        // они встают в очередь раньше и освобождают место важным запросам.
+        if (state.queued >= state.max_queue) {
+            ++state.shed_queue_full;
+            return Ticket{this, &state, Rejection::kQueueFull};
+        }
+        ++state.queued;
+        ++state.waited;
+        const auto admitted = released_.WaitUntil(
+            lock, userver::engine::Deadline::FromDuration(state.queue_timeout),
+            can_run);
+        --state.queued;
+        if (!admitted) {
+            ++state.shed_timeout;
+            return Ticket{this, &state, Rejection::kTimeout};
+        }
+    }
+    ++state.in_flight;
+    ++total_in_flight_;
+    ++state.admitted;
+    return Ticket{this, &state, Rejection::kNone};
+}
+
+void AdmissionControl::ObserveDbLatency(
+    std::string_view handler_name,
+    std::chrono::steady_clock::duration latency) noexcept {
+    const auto& state = StateFor(handler_name);
+    if (!state.feeds_limit) {
+        return;
+    }
+    auto& latency_class =
+        db_latency_[static_cast<std::size_t>(state.priority)];
+    latency_class.sum_us += static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(latency)
+            .count());
+    ++latency_class.count;
+}
+
+void AdmissionControl::Release(HandlerState& state) {
+    {
+        std::lock_guard lock(mutex_);
+        --state.in_flight;
+        --total_in_flight_;
+    }
+    released_.NotifyAll();
+}
+
+void AdmissionControl::AdjustLimit() {
+    // Худший из классов: медленные чтения ленты не должны прятаться за
+    // быстрыми точечными запросами входа.
+    std::optional<std::chrono::microseconds> worst;
+    for (auto& latency_class : db_latency_) {
+        const auto count = latency_class.count.exchange(0);
+        const auto sum = latency_class.sum_us.exchange(0);
+        if (count == 0) {
+            continue;
+        }
+        const std::chrono::microseconds average{sum / count};
+        latency_class.last_average_us =
+            static_cast<std::uint64_t>(average.count());
+        worst = std::max(worst.value_or(average), average);
+    }
+    if (!worst.has_value()) {
+        return;
+    }
+    const auto average = *worst;
+    const auto current = limit_.load();
+    const auto next =
+        average > latency_target_
+            ? std::max(min_limit_, current * kDecreaseFactor)
+            : std::min(max_limit_, current + kIncreaseStep);
+    if (next != current) {
+        LOG_DEBUG() << "admission limit " << current << " -> " << next
+                    << ", worst class DB latency " << average.count() << "us";
+    }
+    limit_ = next;
+    // Лимит мог вырасти - ожидающим стоит перепроверить.
+    released_.NotifyAll();
+}
+
+std::string AdmissionControl::RenderRejection(
+    const userver::server::http::HttpRequest& request,
+    const Ticket& ticket) const {
+    auto& response = request.GetHttpResponse();
+    response.SetContentType(userver::http::content_type::kApplicationJson);
+    response.SetHeader(std::string{"Retry-After"},
+                       std::to_string(retry_after_.count()));
+    // 429 - очередь хэндлера полна прямо сейчас, 503 - место не нашлось за
+    // queue-timeout.
+    request.SetResponseStatus(
+        ticket.GetRejection() == Rejection::kQueueFull
+            ? userver::server::http::HttpStatus::kTooManyRequests
+            : userver::server::http::HttpStatus::kServiceUnavailable);
+    return userver::formats::json::ToString(userver::formats::json::MakeObject(
+        "status", "error", "message", "server is overloaded, retry later"));
+}
+
+userver::yaml_config::Schema AdmissionControl::GetStaticConfigSchema() {
+    return userver::yaml_config::MergeSchemas<
+        userver::components::ComponentBase>(R"(
+type: object
+description: допуск запросов и сброс нагрузки по хэндлерам
+additionalProperties: false
+properties:
+    latency-target:
+        type: string
+        description: |
+            целевое среднее время обращения к БД в любом классе; выше -
+            лимит снижается
+        defaultDescription: 100ms
+    min-limit:
+        type: number
+        description: нижняя граница общего лимита одновременных запросов
+        defaultDescription: 4
+    max-limit:
+        type: number
+        description: верхняя граница и начальное значение общего лимита
+        defaultDescription: 64
+    adjust-period:
+        type: string
+        description: как часто пересчитывать лимит
+        defaultDescription: 1s
+    retry-after:
+        type: string
+        description: значение Retry-After в отказах
+        defaultDescription: 1s
+    class-shares:
+        type: object
+        description: доля общего лимита, доступная классу приоритета
+        additionalProperties: false
+        properties:
+            critical:
+                type: number
+                description: вход, регистрация, избранное
+                defaultDescription: 1.0
+            normal:
+                type: number
+                description: обычные запросы
+                defaultDescription: 0.8
+            background:
+                type: number
+                description: поиск агента и прочее отложенное
+                defaultDescription: 0.5
+    handlers:
+        type: object
+        description: настройки по имени компонента хэндлера
+        properties: {}
+        additionalProperties:
+            type: object
+            description: настройки одного хэндлера
+            additionalProperties: false
+            properties:
+                class:
+                    type: string
+                    description: critical / normal / background
+                    enum: [critical, normal, background]
+                    defaultDescription: normal
+                max-concurrency:
+                    type: integer
+                    description: собственный предел хэндлера, 0 - без него
+                    defaultDescription: 0
+                max-queue:
+                    type: integer
+                    description: сколько запросов может ждать места
+                    defaultDescription: 32
+                queue-timeout:
+                    type: string
+                    description: сколько запрос ждёт места до отказа 503
+                    defaultDescription: 500ms
+                feeds-limit:
+                    type: boolean
+                    description: |
+                        учитывать ли задержку обращений хэндлера к БД при
+                        подстройке лимита; false - для выгрузок и пакетной
+                        записи, чьи запросы долгие по природе
+                    defaultDescription: true
+)");
+}
+
+}  // namespace masterclasses::components
@@ -0,0 +1,145 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <functional>
+#include <map>
+
+#include <userver/components/component_base.hpp>
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/engine/condition_variable.hpp>
+#include <userver/engine/mutex.hpp>
+#include <userver/server/http/http_request.hpp>
+#include <userver/utils/periodic_task.hpp>
+#include <userver/utils/statistics/entry.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+namespace masterclasses::components {
+
+/// Допуск запросов к работе с БД. Хэндлеры берут Ticket в начале запроса;
+/// общий лимит одновременных запросов подстраивается под задержку
+/// обращений к БД (AIMD к latency-target): время каждого запроса в Postgres
+/// приходит из RequestBudgets::Budget::Db и усредняется по классу
+/// приоритета, лимит снижается, если хоть один класс выше цели. Время
+/// вне БД (scrypt, рендеринг, стриминг) на лимит не влияет, а хэндлеры с
+/// feeds-limit: false (выгрузка, синхронизация) в среднее не попадают.
+/// Классы приоритета получают разную долю лимита, у каждого хэндлера свой
+/// предел и очередь с таймаутом. Не дождавшиеся места получают 429
+/// (очередь полна) или 503 (таймаут) с Retry-After.
+class AdmissionControl final : public userver::components::ComponentBase {
+  public:
+    static constexpr std::string_view kName = "admission-control";
+
+    enum class Priority : std::uint8_t {
+        kCritical,    ///< вход, регистрация, избранное
+        kNormal,      ///< остальные пользовательские запросы
+        kBackground,  ///< поиск агента и прочее, что можно отложить
+    };
+
+    enum class Rejection : std::uint8_t {
+        kNone,
+        kQueueFull,
+        kTimeout,
+    };
+
+  private:
+    struct HandlerState {
+        Priority priority{Priority::kNormal};
+        std::int64_t max_concurrency{0};  // 0 - без своего предела
+        std::int64_t max_queue{0};
+        std::chrono::milliseconds queue_timeout{0};
+        bool feeds_limit{true};
+
+        std::int64_t in_flight{0};  // под mutex_
+        std::int64_t queued{0};     // под mutex_
+
+        std::atomic<std::uint64_t> admitted{0};
+        std::atomic<std::uint64_t> waited{0};
+        std::atomic<std::uint64_t> shed_queue_full{0};
+        std::atomic<std::uint64_t> shed_timeout{0};
+    };
+
+  public:
+    /// Место под запрос; освобождается деструктором.
+    class Ticket {
+      public:
+        Ticket(Ticket&& other) noexcept;
+        Ticket& operator=(Ticket&&) = delete;
+        ~Ticket();
+
+        bool Admitted() const { return rejection_ == Rejection::kNone; }
+        Rejection GetRejection() const { return rejection_; }
+
+      private:
+        friend class AdmissionControl;
+        Ticket(AdmissionControl* owner, HandlerState* state,
+               Rejection rejection);
+
+        AdmissionControl* owner_;
+        HandlerState* state_;
+        Rejection rejection_;
+    };
+
+    AdmissionControl(const userver::components::ComponentConfig& config,
+                     const userver::components::ComponentContext& context);
+    ~AdmissionControl() override;
+
+    static userver::yaml_config::Schema GetStaticConfigSchema();
+
+    /// Ждёт места не дольше queue-timeout хэндлера.
+    Ticket Admit(std::string_view handler_name);
+
+    /// Время одного обращения хэндлера к БД.
+    void ObserveDbLatency(
+        std::string_view handler_name,
+        std::chrono::steady_clock::duration latency) noexcept;
+
+    /// Выставляет 429/503 и Retry-After, возвращает тело ответа.
+    std::string RenderRejection(
+        const userver::server::http::HttpRequest& request,
+        const Ticket& ticket) const;
+
+  private:
+    static constexpr std::size_t kPriorities = 3;
+
+    struct ClassLatency {
+        std::atomic<std::uint64_t> sum_us{0};
+        std::atomic<std::uint64_t> count{0};
+        std::atomic<std::uint64_t> last_average_us{0};  // для метрик
+    };
+
+    HandlerState& StateFor(std::string_view handler_name);
+    std::int64_t LimitFor(Priority priority) const;
+    void Release(HandlerState& state);
+    void AdjustLimit();
+
+    std::chrono::microseconds latency_target_;
+    double min_limit_;
+    double max_limit_;
+    std::chrono::seconds retry_after_;
+    std::array<double, kPriorities> shares_;
+
+    std::map<std::string, HandlerState, std::less<>> handlers_;
+    HandlerState default_state_;
+
+    userver::engine::Mutex mutex_;
+    userver::engine::ConditionVariable released_;
+    std::int64_t total_in_flight_{0};  // под mutex_
+    std::atomic<double> limit_;
+
+    std::array<ClassLatency, kPriorities> db_latency_;
+
+    userver::utils::PeriodicTask adjust_task_;
+    userver::utils::statistics::Entry statistics_holder_;
+};
+
+}  // namespace masterclasses::components
+
+template <>
+inline constexpr bool userver::components::kHasValidate<
+    masterclasses::components::AdmissionControl> = true;
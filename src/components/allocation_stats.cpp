@@ -0,0 +1,89 @@
+#include "components/allocation_stats.hpp"
+
+#include <array>
+#include <mutex>
+#include <string>
+#include <tuple>
+
+#include <userver/components/statistics_storage.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace masterclasses::components {
+
+namespace {
+
+/// Верхние границы корзин гистограммы байт на запрос; первая - меньше
+/// буфера арены, дальше - сколько пришлось добрать из кучи.
+constexpr std::array<double, 8> kBytesBuckets{
+    1024, 4096, 8192, 16384, 32768, 65536, 262144, 1048576};
+
+}  // namespace
+
+AllocationStats::HandlerStats::HandlerStats()
+    : bytes_per_request_(kBytesBuckets) {}
+
+AllocationStats::Scope::~Scope() {
+    ++stats_.requests_;
+    stats_.allocations_ += arena_.Allocations();
+    stats_.bytes_ += arena_.Bytes();
+    stats_.heap_blocks_ += arena_.HeapBlocks();
+    stats_.bytes_per_request_.Account(static_cast<double>(arena_.Bytes()));
+}
+
+AllocationStats::AllocationStats(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : ComponentBase(config, context) {
+    statistics_holder_ =
+        context.FindComponent<userver::components::StatisticsStorage>()
+            .GetStorage()
+            .RegisterWriter(
+                "masterclasses.allocations",
+                [this](userver::utils::statistics::Writer& writer) {
+                    std::lock_guard lock(mutex_);
+                    for (const auto& [name, stats] : handlers_) {
+                        const userver::utils::statistics::LabelView label{
+                            "handler", name};
+                        writer["requests"].ValueWithLabels(
+                            stats.requests_.load(), label);
+                        writer["arena-allocations"].ValueWithLabels(
+                            stats.allocations_.load(), label);
+                        writer["arena-bytes"].ValueWithLabels(
+                            stats.bytes_.load(), label);
+                        writer["heap-blocks"].ValueWithLabels(
+                            stats.heap_blocks_.load(), label);
+                        writer["bytes-per-request"].ValueWithLabels(
+                            stats.bytes_per_request_.GetView(), label);
+                    }
+                });
+}
+
+AllocationStats::~AllocationStats() { statistics_holder_.Unregister(); }
+
+AllocationStats::HandlerStats& AllocationStats::ForHandler(
+    std::string_view handler_name) {
+    // Хэндлеры создаются параллельно, поэтому под мьютексом; узлы map
+    // не переезжают, и ссылка остаётся верной.
+    std::lock_guard lock(mutex_);
+    const auto it = handlers_.find(handler_name);
+    if (it != handlers_.end()) {
+        return it->second;
+    }
+    return handlers_
+        .emplace(std::piecewise_construct,
+                 std::forward_as_tuple(handler_name), std::forward_as_tuple())
+        .first->second;
+}
+
+userver::yaml_config::Schema AllocationStats::GetStaticConfigSchema() {
+    return userver::yaml_config::MergeSchemas<
+        userver::components::ComponentBase>(R"(
+type: object
+description: метрики арен запросов по хэндлерам
+additionalProperties: false
+properties: {}
+)");
+}
+
+}  // namespace masterclasses::components
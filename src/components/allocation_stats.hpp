@@ -0,0 +1,81 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <string>
+#include <string_view>
+
+#include <userver/components/component_base.hpp>
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/engine/mutex.hpp>
+#include <userver/utils/statistics/entry.hpp>
+#include <userver/utils/statistics/histogram.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+#include "utils/request_arena.hpp"
+
+namespace masterclasses::components {
+
+/// Метрики арен запросов (utils::RequestArena) по хэндлерам: сколько
+/// выдач и байт запросы берут из арены, сколько раз арене не хватило
+/// буфера, и гистограмма байт на запрос. Считается только то, что идёт
+/// через арену: строки ответа, JSON, строки из Postgres и прочие
+/// аллокации хэндлера и userver берутся из кучи мимо неё, так что это
+/// не полный трафик кучи запроса, а показатель, что временные структуры
+/// хэндлера укладываются в буфер.
+class AllocationStats final : public userver::components::ComponentBase {
+  public:
+    static constexpr std::string_view kName = "allocation-stats";
+
+    class HandlerStats {
+      public:
+        HandlerStats();
+
+      private:
+        friend class AllocationStats;
+
+        std::atomic<std::uint64_t> requests_{0};
+        std::atomic<std::uint64_t> allocations_{0};
+        std::atomic<std::uint64_t> bytes_{0};
+        std::atomic<std::uint64_t> heap_blocks_{0};
+        userver::utils::statistics::Histogram bytes_per_request_;
+    };
+
+    /// Относит арену к хэндлеру при выходе из запроса, в том числе по
+    /// исключению.
+    class Scope {
+      public:
+        Scope(HandlerStats& stats, const utils::RequestArena& arena)
+            : stats_(stats), arena_(arena) {}
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+        ~Scope();
+
+      private:
+        HandlerStats& stats_;
+        const utils::RequestArena& arena_;
+    };
+
+    AllocationStats(const userver::components::ComponentConfig& config,
+                    const userver::components::ComponentContext& context);
+    ~AllocationStats() override;
+
+    static userver::yaml_config::Schema GetStaticConfigSchema();
+
+    /// Счётчики хэндлера; ссылка живёт, пока жив компонент.
+    HandlerStats& ForHandler(std::string_view handler_name);
+
+  private:
+    userver::engine::Mutex mutex_;
+    std::map<std::string, HandlerStats, std::less<>> handlers_;  // под mutex_
+    userver::utils::statistics::Entry statistics_holder_;
+};
+
+}  // namespace masterclasses::components
+
+template <>
+inline constexpr bool userver::components::kHasValidate<
+    masterclasses::components::AllocationStats> = true;
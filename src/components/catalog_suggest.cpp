@@ -0,0 +1,91 @@
+#include "components/catalog_suggest.hpp"
+
+#include <chrono>
+
+#include <userver/logging/log.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace masterclasses::components {
+
+namespace {
+
+constexpr std::chrono::seconds kDefaultRebuildPeriod{5};
+constexpr std::chrono::minutes kDefaultPopularityRefreshPeriod{1};
+
+}  // namespace
+
+CatalogSuggest::CatalogSuggest(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : ComponentBase(config, context),
+      catalog_(context.FindComponent<MasterclassCatalog>()),
+      favorite_counters_(context.FindComponent<FavoriteCounters>()),
+      popularity_refresh_period_(
+          config["popularity-refresh-period"].As<std::chrono::milliseconds>(
+              kDefaultPopularityRefreshPeriod)) {
+    Rebuild();
+
+    const auto period = config["rebuild-period"].As<std::chrono::milliseconds>(
+        kDefaultRebuildPeriod);
+    rebuild_task_.Start("catalog-suggest-rebuild",
+                        userver::utils::PeriodicTask::Settings{period},
+                        [this] { Rebuild(); });
+}
+
+CatalogSuggest::~CatalogSuggest() { rebuild_task_.Stop(); }
+
+std::shared_ptr<const catalog::SuggestIndex> CatalogSuggest::GetIndex() const {
+    return *index_.Read();
+}
+
+void CatalogSuggest::Rebuild() {
+    const auto snapshot = catalog_.GetSnapshot();
+    if (!snapshot) {
+        return;
+    }
+    auto ranking = favorite_counters_.GetRanking();
+    const auto started = std::chrono::steady_clock::now();
+    if (snapshot->version == built_version_) {
+        // Рейтинг публикуется часто, а перестройка стоит O(N log N):
+        // свежая популярность подождёт popularity-refresh-period.
+        if (ranking == built_ranking_ ||
+            started - built_at_ < popularity_refresh_period_) {
+            return;
+        }
+    }
+
+    auto index = std::make_shared<const catalog::SuggestIndex>(
+        catalog::SuggestIndex::Build(*snapshot, ranking.get()));
+    LOG_INFO() << "suggest index rebuilt: " << index->EntryCount()
+               << " entries in "
+               << std::chrono::duration_cast<std::chrono::milliseconds>(
+                      std::chrono::steady_clock::now() - started)
+                      .count()
+               << "ms";
+
+    index_.Assign(std::move(index));
+    built_version_ = snapshot->version;
+    built_ranking_ = std::move(ranking);
+    built_at_ = started;
+}
+
+userver::yaml_config::Schema CatalogSuggest::GetStaticConfigSchema() {
+    return userver::yaml_config::MergeSchemas<
+        userver::components::ComponentBase>(R"(
+type: object
+description: индекс подсказок по каталогу мастер-классов
+additionalProperties: false
+properties:
+    rebuild-period:
+        type: string
+        description: как часто проверять, не изменился ли каталог
+        defaultDescription: 5s
+    popularity-refresh-period:
+        type: string
+        description: |
+            как часто учитывать новый рейтинг избранного в весах подсказок
+        defaultDescription: 1m
+)");
+}
+
+}  // namespace masterclasses::components
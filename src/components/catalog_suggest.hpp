@@ -0,0 +1,55 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+
+#include <userver/components/component_base.hpp>
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/rcu/rcu.hpp>
+#include <userver/utils/periodic_task.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+#include "catalog/suggest_index.hpp"
+#include "components/favorite_counters.hpp"
+#include "components/masterclass_catalog.hpp"
+
+namespace masterclasses::components {
+
+/// Индекс подсказок /suggest поверх снимка каталога. Перестраивается в
+/// фоне, когда меняется версия снимка, и не чаще popularity-refresh-period
+/// - когда меняется рейтинг избранного; запросы читают готовый индекс.
+class CatalogSuggest final : public userver::components::ComponentBase {
+  public:
+    static constexpr std::string_view kName = "catalog-suggest";
+
+    CatalogSuggest(const userver::components::ComponentConfig& config,
+                   const userver::components::ComponentContext& context);
+    ~CatalogSuggest() override;
+
+    static userver::yaml_config::Schema GetStaticConfigSchema();
+
+    /// nullptr, пока каталог не загружен.
+    std::shared_ptr<const catalog::SuggestIndex> GetIndex() const;
+
+  private:
+    void Rebuild();
+
+    const MasterclassCatalog& catalog_;
+    const FavoriteCounters& favorite_counters_;
+    const std::chrono::milliseconds popularity_refresh_period_;
+    std::uint64_t built_version_{0};
+    std::shared_ptr<const catalog::PopularityRanking> built_ranking_;
+    std::chrono::steady_clock::time_point built_at_;
+    userver::rcu::Variable<std::shared_ptr<const catalog::SuggestIndex>>
+        index_;
+    userver::utils::PeriodicTask rebuild_task_;
+};
+
+}  // namespace masterclasses::components
+
+template <>
+inline constexpr bool userver::components::kHasValidate<
+    masterclasses::components::CatalogSuggest> = true;
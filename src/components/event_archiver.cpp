@@ -0,0 +1,105 @@
+#include "components/event_archiver.hpp"
+#include "sql/queries.hpp"
+#include "utils/filter_args.hpp"
+
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <userver/components/statistics_storage.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/storages/postgres/component.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace masterclasses::components {
+
+namespace {
+
+using ClusterHostType = userver::storages::postgres::ClusterHostType;
+
+constexpr std::chrono::hours kDefaultArchivePeriod{1};
+constexpr std::int64_t kDefaultBatchSize = 1000;
+
+}  // namespace
+
+EventArchiver::EventArchiver(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : ComponentBase(config, context),
+      catalog_(context.FindComponent<MasterclassCatalog>()),
+      db_cluster_(context.FindComponent<userver::components::Postgres>("app-db")
+                      .GetCluster()),
+      batch_size_(config["batch-size"].As<std::int64_t>(kDefaultBatchSize)) {
+    // Первый проход - сразу: после простоя в таблице мог накопиться хвост.
+    userver::utils::PeriodicTask::Settings settings{
+        config["period"].As<std::chrono::milliseconds>(
+            kDefaultArchivePeriod)};
+    settings.flags = userver::utils::PeriodicTask::Flags::kNow;
+    archive_task_.Start("event-archiver", settings, [this] { Archive(); });
+
+    statistics_holder_ =
+        context.FindComponent<userver::components::StatisticsStorage>()
+            .GetStorage()
+            .RegisterWriter(
+                "masterclasses.archive",
+                [this](userver::utils::statistics::Writer& writer) {
+                    writer["runs"] = runs_.load();
+                    writer["archived"] = archived_.load();
+                    writer["failures"] = failures_.load();
+                });
+}
+
+EventArchiver::~EventArchiver() {
+    statistics_holder_.Unregister();
+    archive_task_.Stop();
+}
+
+void EventArchiver::Archive() {
+    ++runs_;
+    const auto upcoming_from = utils::UpcomingFrom();
+    try {
+        // Пакетами, чтобы не держать блокировки на весь хвост разом;
+        // неполный пакет - прошедших больше нет.
+        while (true) {
+            const auto result = db_cluster_->Execute(
+                ClusterHostType::kMaster, sql::kArchivePastMasterclasses,
+                upcoming_from, batch_size_);
+            std::vector<std::int64_t> ids;
+            ids.reserve(result.Size());
+            for (const auto& row : result) {
+                ids.push_back(row[0].As<std::int64_t>());
+            }
+            const auto moved = ids.size();
+            archived_ += moved;
+            catalog_.Erase(std::move(ids));
+            if (moved < static_cast<std::size_t>(batch_size_)) {
+                break;
+            }
+        }
+    } catch (const std::exception& ex) {
+        ++failures_;
+        LOG_WARNING() << "archiving past masterclasses failed: " << ex.what();
+    }
+}
+
+userver::yaml_config::Schema EventArchiver::GetStaticConfigSchema() {
+    return userver::yaml_config::MergeSchemas<
+        userver::components::ComponentBase>(R"(
+type: object
+description: перенос прошедших мастер-классов в masterclasses_archive
+additionalProperties: false
+properties:
+    period:
+        type: string
+        description: как часто искать прошедшие мастер-классы
+        defaultDescription: 1h
+    batch-size:
+        type: integer
+        description: сколько строк переносить одним запросом
+        defaultDescription: 1000
+        minimum: 1
+)");
+}
+
+}  // namespace masterclasses::components
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string_view>
+
+#include <userver/components/component_base.hpp>
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/storages/postgres/cluster.hpp>
+#include <userver/utils/periodic_task.hpp>
+#include <userver/utils/statistics/entry.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+#include "components/masterclass_catalog.hpp"
+
+namespace masterclasses::components {
+
+/// Переносит прошедшие мастер-классы (event_date раньше
+/// utils::UpcomingFrom()) из masterclasses в masterclasses_archive
+/// пакетами по batch-size и сразу убирает их из каталога этого инстанса;
+/// остальные инстансы увидят удаление при следующей перезагрузке. Так
+/// рабочий набор таблицы и каталога ограничен предстоящими событиями.
+class EventArchiver final : public userver::components::ComponentBase {
+  public:
+    static constexpr std::string_view kName = "event-archiver";
+
+    EventArchiver(const userver::components::ComponentConfig& config,
+                  const userver::components::ComponentContext& context);
+    ~EventArchiver() override;
+
+    static userver::yaml_config::Schema GetStaticConfigSchema();
+
+  private:
+    void Archive();
+
+    MasterclassCatalog& catalog_;
+    userver::storages::postgres::ClusterPtr db_cluster_;
+    std::int64_t batch_size_;
+
+    std::atomic<std::uint64_t> runs_{0};
+    std::atomic<std::uint64_t> archived_{0};
+    std::atomic<std::uint64_t> failures_{0};
+
+    userver::utils::PeriodicTask archive_task_;
+    userver::utils::statistics::Entry statistics_holder_;
+};
+
+}  // namespace masterclasses::components
+
+template <>
+inline constexpr bool userver::components::kHasValidate<
+    masterclasses::components::EventArchiver> = true;
@@ -0,0 +1,149 @@
+#include "components/favorite_counters.hpp"
+#include "sql/queries.hpp"
+
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+#include <userver/logging/log.hpp>
+#include <userver/storages/postgres/component.hpp>
+#include <userver/utils/datetime.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace masterclasses::components {
+
+namespace {
+
+using ClusterHostType = userver::storages::postgres::ClusterHostType;
+
+constexpr std::chrono::seconds kDefaultPublishPeriod{1};
+constexpr std::chrono::minutes kDefaultReconcilePeriod{5};
+
+std::int32_t Today() {
+    const auto now = userver::utils::datetime::Now();
+    return static_cast<std::int32_t>(
+        std::chrono::floor<std::chrono::days>(now).time_since_epoch().count());
+}
+
+}  // namespace
+
+FavoriteCounters::FavoriteCounters(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : ComponentBase(config, context),
+      catalog_(context.FindComponent<MasterclassCatalog>()),
+      db_cluster_(context.FindComponent<userver::components::Postgres>("app-db")
+                      .GetCluster()),
+      reconcile_period_(config["reconcile-period"].As<std::chrono::milliseconds>(
+          kDefaultReconcilePeriod)),
+      decay_half_life_days_(config["decay-half-life-days"].As<double>(0.0)) {
+    Publish();
+
+    const auto period = config["publish-period"].As<std::chrono::milliseconds>(
+        kDefaultPublishPeriod);
+    publish_task_.Start("favorite-counters-publish",
+                        userver::utils::PeriodicTask::Settings{period},
+                        [this] { Publish(); });
+}
+
+FavoriteCounters::~FavoriteCounters() { publish_task_.Stop(); }
+
+void FavoriteCounters::Add(std::int64_t masterclass_id, std::int64_t delta) {
+    auto& shard =
+        shards_[std::hash<std::thread::id>{}(std::this_thread::get_id()) %
+                kShards];
+    std::lock_guard lock(shard.mutex);
+    shard.deltas[masterclass_id] += delta;
+}
+
+std::shared_ptr<const catalog::PopularityRanking>
+FavoriteCounters::GetRanking() const {
+    return *ranking_.Read();
+}
+
+void FavoriteCounters::DrainDeltas() {
+    for (auto& shard : shards_) {
+        std::unordered_map<std::int64_t, std::int64_t> deltas;
+        {
+            std::lock_guard lock(shard.mutex);
+            deltas.swap(shard.deltas);
+        }
+        for (const auto& [id, delta] : deltas) {
+            auto& count = counts_[id];
+            count += delta;
+            if (count <= 0) {
+                counts_.erase(id);
+            }
+        }
+    }
+}
+
+void FavoriteCounters::Reconcile() {
+    // Дельты, пришедшие во время запроса, остаются в шардах и лягут поверх
+    // свежих счётчиков; если их строки уже попали в снимок запроса, они
+    // учтутся дважды до следующей сверки - для сортировки это допустимо.
+    DrainDeltas();
+    const auto result = db_cluster_->Execute(
+        ClusterHostType::kSlave, sql::kCountFavoritesByMasterclass);
+
+    std::unordered_map<std::int64_t, std::int64_t> fresh;
+    fresh.reserve(result.Size());
+    for (const auto& row : result) {
+        fresh.emplace(row[0].As<std::int64_t>(), row[1].As<std::int64_t>());
+    }
+    counts_ = std::move(fresh);
+    reconciled_ = true;
+    last_reconcile_ = std::chrono::steady_clock::now();
+}
+
+void FavoriteCounters::Publish() {
+    const auto snapshot = catalog_.GetSnapshot();
+    if (!snapshot) {
+        return;
+    }
+
+    if (!reconciled_ ||
+        std::chrono::steady_clock::now() - last_reconcile_ >=
+            reconcile_period_) {
+        try {
+            Reconcile();
+        } catch (const std::exception& ex) {
+            LOG_WARNING() << "favorite counters reconcile failed: "
+                          << ex.what();
+            if (!reconciled_) {
+                return;
+            }
+        }
+    }
+    DrainDeltas();
+
+    ranking_.Assign(catalog::PopularityRanking::Build(
+        *snapshot, counts_, Today(), decay_half_life_days_));
+}
+
+userver::yaml_config::Schema FavoriteCounters::GetStaticConfigSchema() {
+    return userver::yaml_config::MergeSchemas<
+        userver::components::ComponentBase>(R"(
+type: object
+description: счётчики избранного и рейтинг для sort_order=popular
+additionalProperties: false
+properties:
+    publish-period:
+        type: string
+        description: как часто сливать дельты и публиковать рейтинг
+        defaultDescription: 1s
+    reconcile-period:
+        type: string
+        description: как часто сверять счётчики с user_favorites в Postgres
+        defaultDescription: 5m
+    decay-half-life-days:
+        type: number
+        description: |
+            затухание по event_date - очки падают вдвое на каждые столько
+            дней от сегодня; 0 - без затухания
+        defaultDescription: 0
+)");
+}
+
+}  // namespace masterclasses::components
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <new>
+#include <string_view>
+#include <unordered_map>
+
+#include <userver/components/component_base.hpp>
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/engine/mutex.hpp>
+#include <userver/rcu/rcu.hpp>
+#include <userver/storages/postgres/cluster.hpp>
+#include <userver/utils/periodic_task.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+#include "catalog/popularity.hpp"
+#include "components/masterclass_catalog.hpp"
+
+namespace masterclasses::components {
+
+/// Число добавлений каждого мастер-класса в избранное для
+/// sort_order=popular. POST/DELETE /user/favorites пишут дельты в шарды
+/// (шард выбирается по потоку, так что параллельные переключения не бьются
+/// за одну строку кеша); фоновая задача сливает дельты, публикует
+/// PopularityRanking и время от времени сверяет счётчики с user_favorites.
+class FavoriteCounters final : public userver::components::ComponentBase {
+  public:
+    static constexpr std::string_view kName = "favorite-counters";
+
+    FavoriteCounters(const userver::components::ComponentConfig& config,
+                     const userver::components::ComponentContext& context);
+    ~FavoriteCounters() override;
+
+    static userver::yaml_config::Schema GetStaticConfigSchema();
+
+    /// `delta` = +1 для добавления в избранное, -1 для удаления.
+    void Add(std::int64_t masterclass_id, std::int64_t delta);
+
+    /// nullptr, пока каталог и счётчики ни разу не загрузились.
+    std::shared_ptr<const catalog::PopularityRanking> GetRanking() const;
+
+  private:
+    static constexpr std::size_t kShards = 16;
+    static constexpr std::size_t kCacheLineSize = 64;
+
+    struct alignas(kCacheLineSize) Shard {
+        userver::engine::Mutex mutex;
+        std::unordered_map<std::int64_t, std::int64_t> deltas;
+    };
+
+    void Publish();
+    void DrainDeltas();
+    void Reconcile();
+
+    const MasterclassCatalog& catalog_;
+    userver::storages::postgres::ClusterPtr db_cluster_;
+    std::chrono::milliseconds reconcile_period_;
+    double decay_half_life_days_;
+
+    std::array<Shard, kShards> shards_;
+
+    // Принадлежат фоновой задаче.
+    std::unordered_map<std::int64_t, std::int64_t> counts_;
+    bool reconciled_{false};
+    std::chrono::steady_clock::time_point last_reconcile_;
+
+    userver::rcu::Variable<std::shared_ptr<const catalog::PopularityRanking>>
+        ranking_;
+    userver::utils::PeriodicTask publish_task_;
+};
+
+}  // namespace masterclasses::components
+
+template <>
+inline constexpr bool userver::components::kHasValidate<
+    masterclasses::components::FavoriteCounters> = true;
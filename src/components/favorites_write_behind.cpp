@@ -0,0 +1,234 @@
+#include "components/favorites_write_behind.hpp"
+#include "sql/queries.hpp"
+#include "utils/batch_split.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <limits>
+#include <mutex>
+
+#include <userver/logging/log.hpp>
+#include <userver/storages/postgres/component.hpp>
+#include <userver/storages/postgres/exceptions.hpp>
+#include <userver/storages/postgres/transaction.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace masterclasses::components {
+
+namespace {
+
+constexpr std::chrono::milliseconds kDefaultFlushInterval{5};
+constexpr std::size_t kDefaultMaxBatchSize = 1000;
+
+/// Транзакция откатилась целиком - половины пакета пишутся заново. Если
+/// Postgres недоступен, делить пакет бесполезно.
+bool IsSplittable(const std::exception& ex) {
+    namespace pg = userver::storages::postgres;
+    return !dynamic_cast<const pg::ConnectionError*>(&ex) &&
+           !dynamic_cast<const pg::ClusterUnavailable*>(&ex);
+}
+
+}  // namespace
+
+FavoritesWriteBehind::FavoritesWriteBehind(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : ComponentBase(config, context),
+      enabled_(config["enabled"].As<bool>(false)),
+      max_batch_size_(
+          config["max-batch-size"].As<std::size_t>(kDefaultMaxBatchSize)),
+      db_cluster_(context.FindComponent<userver::components::Postgres>("app-db")
+                      .GetCluster()),
+      counters_(context.FindComponent<FavoriteCounters>()) {
+    if (!enabled_) {
+        return;
+    }
+    const auto interval =
+        config["flush-interval"].As<std::chrono::milliseconds>(
+            kDefaultFlushInterval);
+    flush_task_.Start("favorites-write-behind-flush",
+                      userver::utils::PeriodicTask::Settings{interval},
+                      [this] { Flush(); });
+}
+
+FavoritesWriteBehind::~FavoritesWriteBehind() {
+    flush_task_.Stop();
+    // Хэндлеры уже остановлены - дописываем всё, что осталось в очереди.
+    while (true) {
+        {
+            std::lock_guard lock(mutex_);
+            if (queue_.empty()) {
+                break;
+            }
+        }
+        Flush();
+    }
+}
+
+userver::engine::Future<void> FavoritesWriteBehind::Enqueue(
+    std::string user_id, std::int64_t masterclass_id, Op op) {
+    userver::engine::Promise<void> promise;
+    auto future = promise.get_future();
+
+    std::lock_guard lock(mutex_);
+    auto& pending = queue_[Key{std::move(user_id), masterclass_id}];
+    pending.op = op;
+    pending.waiters.push_back(std::move(promise));
+    return future;
+}
+
+void FavoritesWriteBehind::OverlayPending(
+    const std::string& user_id, std::vector<std::int64_t>& ids) const {
+    std::lock_guard lock(mutex_);
+    const Key first{user_id, std::numeric_limits<std::int64_t>::min()};
+    const auto apply = [&](const Queue& queue) {
+        for (auto it = queue.lower_bound(first);
+             it != queue.end() && it->first.first == user_id; ++it) {
+            const auto id = it->first.second;
+            const auto pos = std::find(ids.begin(), ids.end(), id);
+            if (it->second.op == Op::kAdd && pos == ids.end()) {
+                ids.push_back(id);
+            } else if (it->second.op == Op::kRemove && pos != ids.end()) {
+                ids.erase(pos);
+            }
+        }
+    };
+    // Очередь новее того, что пишется сейчас.
+    apply(in_flight_);
+    apply(queue_);
+}
+
+void FavoritesWriteBehind::Flush() {
+    {
+        std::lock_guard lock(mutex_);
+        if (queue_.empty()) {
+            return;
+        }
+        if (queue_.size() <= max_batch_size_) {
+            in_flight_.swap(queue_);
+        } else {
+            auto it = queue_.begin();
+            for (std::size_t i = 0; i < max_batch_size_; ++i) {
+                auto node = queue_.extract(it++);
+                in_flight_.insert(std::move(node));
+            }
+        }
+    }
+
+    std::vector<const Entry*> batch;
+    batch.reserve(in_flight_.size());
+    for (const auto& entry : in_flight_) {
+        batch.push_back(&entry);
+    }
+    Errors errors;
+    utils::WriteOrSplit(
+        std::span<const Entry* const>(batch),
+        [this](std::span<const Entry* const> part) { Write(part); },
+        IsSplittable,
+        [&errors](std::span<const Entry* const> part,
+                  const std::exception& ex) {
+            if (part.size() == 1) {
+                LOG_WARNING() << "favorites write-behind: operation for user "
+                              << part.front()->first.first
+                              << " failed: " << ex.what();
+            } else {
+                LOG_WARNING() << "favorites write-behind: " << ex.what();
+            }
+            const auto error = std::current_exception();
+            for (const auto* entry : part) {
+                errors.emplace(entry, error);
+            }
+        });
+    if (!errors.empty()) {
+        LOG_ERROR() << "favorites write-behind: " << errors.size() << " of "
+                    << batch.size() << " operations failed";
+    }
+
+    Queue done;
+    {
+        std::lock_guard lock(mutex_);
+        done.swap(in_flight_);
+    }
+    // Узлы map переносятся swap'ом без копирования - указатели в errors
+    // остаются действительными.
+    for (auto& entry : done) {
+        const auto error = errors.find(&entry);
+        for (auto& waiter : entry.second.waiters) {
+            if (error != errors.end()) {
+                waiter.set_exception(error->second);
+            } else {
+                waiter.set_value();
+            }
+        }
+    }
+}
+
+void FavoritesWriteBehind::Write(std::span<const Entry* const> batch) {
+    std::vector<std::string> add_users;
+    std::vector<std::int64_t> add_ids;
+    std::vector<std::string> remove_users;
+    std::vector<std::int64_t> remove_ids;
+    for (const auto* entry : batch) {
+        const auto& [key, pending] = *entry;
+        if (pending.op == Op::kAdd) {
+            add_users.push_back(key.first);
+            add_ids.push_back(key.second);
+        } else {
+            remove_users.push_back(key.first);
+            remove_ids.push_back(key.second);
+        }
+    }
+
+    auto transaction = db_cluster_->Begin(
+        "favorites-write-behind", userver::storages::postgres::Transaction::RW);
+    std::vector<std::int64_t> inserted;
+    std::vector<std::int64_t> deleted;
+    if (!add_ids.empty()) {
+        const auto result = transaction.Execute(sql::kInsertFavoritesBatch,
+                                                add_users, add_ids);
+        for (const auto& row : result) {
+            inserted.push_back(row[0].As<std::int64_t>());
+        }
+    }
+    if (!remove_ids.empty()) {
+        const auto result = transaction.Execute(sql::kDeleteFavoritesBatch,
+                                                remove_users, remove_ids);
+        for (const auto& row : result) {
+            deleted.push_back(row[0].As<std::int64_t>());
+        }
+    }
+    transaction.Commit();
+
+    // Счётчики - только по реально изменившимся строкам, как и без очереди.
+    for (const auto id : inserted) {
+        counters_.Add(id, 1);
+    }
+    for (const auto id : deleted) {
+        counters_.Add(id, -1);
+    }
+}
+
+userver::yaml_config::Schema FavoritesWriteBehind::GetStaticConfigSchema() {
+    return userver::yaml_config::MergeSchemas<
+        userver::components::ComponentBase>(R"(
+type: object
+description: отложенная пакетная запись избранного
+additionalProperties: false
+properties:
+    enabled:
+        type: boolean
+        description: включить очередь; иначе хэндлер пишет в Postgres сам
+        defaultDescription: false
+    flush-interval:
+        type: string
+        description: как часто писать накопленные операции
+        defaultDescription: 5ms
+    max-batch-size:
+        type: integer
+        description: максимум операций в одной транзакции
+        defaultDescription: 1000
+        minimum: 1
+)");
+}
+
+}  // namespace masterclasses::components
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <exception>
+#include <map>
+#include <span>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <userver/components/component_base.hpp>
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/engine/future.hpp>
+#include <userver/engine/mutex.hpp>
+#include <userver/storages/postgres/cluster.hpp>
+#include <userver/utils/periodic_task.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+#include "components/favorite_counters.hpp"
+
+namespace masterclasses::components {
+
+/// Отложенная запись избранного. POST/DELETE /user/favorites кладут
+/// операцию в очередь, где она схлопывается по (user_id, masterclass_id) -
+/// побеждает последняя; фоновая задача каждые flush-interval пишет очередь
+/// двумя многострочными запросами в одной транзакции. Если пакет не
+/// записался не из-за недоступности Postgres, он делится пополам, и ошибку
+/// получают только операции, которые не пишутся и поодиночке. Хэндлер
+/// ждёт коммита своей операции, а GET видит ещё не записанные операции
+/// через OverlayPending. При остановке очередь дописывается.
+class FavoritesWriteBehind final : public userver::components::ComponentBase {
+  public:
+    static constexpr std::string_view kName = "favorites-write-behind";
+
+    enum class Op {
+        kAdd,
+        kRemove,
+    };
+
+    FavoritesWriteBehind(const userver::components::ComponentConfig& config,
+                         const userver::components::ComponentContext& context);
+    ~FavoritesWriteBehind() override;
+
+    static userver::yaml_config::Schema GetStaticConfigSchema();
+
+    /// false - хэндлер пишет в Postgres сам, как раньше.
+    bool Enabled() const { return enabled_; }
+
+    /// Готов, когда операция (или заменившая её более поздняя по той же
+    /// паре) закоммичена; при ошибке записи future бросает её исключение.
+    userver::engine::Future<void> Enqueue(std::string user_id,
+                                          std::int64_t masterclass_id, Op op);
+
+    /// Применяет к `ids` из БД ещё не закоммиченные операции пользователя.
+    void OverlayPending(const std::string& user_id,
+                        std::vector<std::int64_t>& ids) const;
+
+  private:
+    using Key = std::pair<std::string, std::int64_t>;
+
+    struct Pending {
+        Op op{Op::kAdd};
+        std::vector<userver::engine::Promise<void>> waiters;
+    };
+    using Queue = std::map<Key, Pending>;
+    using Entry = Queue::value_type;
+    using Errors = std::map<const Entry*, std::exception_ptr>;
+
+    void Flush();
+    void Write(std::span<const Entry* const> batch);
+
+    bool enabled_;
+    std::size_t max_batch_size_;
+    userver::storages::postgres::ClusterPtr db_cluster_;
+    FavoriteCounters& counters_;
+
+    mutable userver::engine::Mutex mutex_;
+    Queue queue_;
+    Queue in_flight_;  // пишется прямо сейчас; виден в OverlayPending
+
+    userver::utils::PeriodicTask flush_task_;
+};
+
+}  // namespace masterclasses::components
+
+template <>
+inline constexpr bool userver::components::kHasValidate<
+    masterclasses::components::FavoritesWriteBehind> = true;
@@ -0,0 +1,127 @@
+#include "components/gazetteer.hpp"
+#include "catalog/text_normalizer.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <fstream>
+#include <stdexcept>
+
+#include <userver/logging/log.hpp>
+#include <userver/utils/async.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace masterclasses::components {
+
+namespace {
+
+std::u16string PaddedKey(std::string_view text) {
+    return u" " + catalog::NormalizePhrase(text) + u" ";
+}
+
+std::optional<double> ParseDegrees(std::string_view raw, double limit) {
+    double value = 0.0;
+    const auto [end, error] =
+        std::from_chars(raw.data(), raw.data() + raw.size(), value);
+    if (error != std::errc{} || end != raw.data() + raw.size() ||
+        value < -limit || value > limit) {
+        return std::nullopt;
+    }
+    return value;
+}
+
+}  // namespace
+
+Gazetteer::Gazetteer(const userver::components::ComponentConfig& config,
+                     const userver::components::ComponentContext& context)
+    : ComponentBase(config, context) {
+    const auto path = config["path"].As<std::string>("");
+    if (path.empty()) {
+        return;
+    }
+    auto& fs_task_processor = context.GetTaskProcessor(
+        config["fs-task-processor"].As<std::string>("fs-task-processor"));
+    userver::utils::Async(fs_task_processor, "gazetteer-load",
+                          [this, &path] { Load(path); })
+        .Get();
+    LOG_INFO() << "gazetteer loaded from " << path << ", " << places_.size()
+               << " names";
+}
+
+void Gazetteer::Load(const std::string& path) {
+    std::ifstream in(path);
+    if (!in) {
+        throw std::runtime_error("gazetteer: cannot open " + path);
+    }
+    // Строка: "название|синоним|...<TAB>широта<TAB>долгота", # - комментарий.
+    std::string line;
+    for (std::size_t number = 1; std::getline(in, line); ++number) {
+        if (line.empty() || line.front() == '#') {
+            continue;
+        }
+        const auto first_tab = line.find('\t');
+        const auto second_tab = line.find('\t', first_tab + 1);
+        std::optional<double> latitude;
+        std::optional<double> longitude;
+        if (first_tab != std::string::npos &&
+            second_tab != std::string::npos) {
+            const std::string_view view{line};
+            latitude = ParseDegrees(
+                view.substr(first_tab + 1, second_tab - first_tab - 1), 90.0);
+            longitude = ParseDegrees(view.substr(second_tab + 1), 180.0);
+        }
+        if (!latitude || !longitude) {
+            throw std::runtime_error("gazetteer: malformed line " +
+                                     std::to_string(number) + " in " + path);
+        }
+        std::string_view names{line.data(), first_tab};
+        while (!names.empty()) {
+            const auto end = std::min(names.find('|'), names.size());
+            auto key = PaddedKey(names.substr(0, end));
+            if (key.find_first_not_of(u' ') != std::u16string::npos) {
+                places_.push_back(
+                    Place{std::move(key), {*latitude, *longitude}});
+            }
+            names.remove_prefix(std::min(end + 1, names.size()));
+        }
+    }
+    std::stable_sort(places_.begin(), places_.end(),
+                     [](const Place& a, const Place& b) {
+                         return a.key.size() > b.key.size();
+                     });
+}
+
+std::optional<catalog::GeoPoint> Gazetteer::Locate(
+    std::string_view text) const {
+    if (places_.empty() || text.empty()) {
+        return std::nullopt;
+    }
+    const auto key = PaddedKey(text);
+    for (const auto& place : places_) {
+        if (key.find(place.key) != std::u16string::npos) {
+            return place.point;
+        }
+    }
+    return std::nullopt;
+}
+
+userver::yaml_config::Schema Gazetteer::GetStaticConfigSchema() {
+    return userver::yaml_config::MergeSchemas<
+        userver::components::ComponentBase>(R"(
+type: object
+description: локальный газеттир для координат мастер-классов
+additionalProperties: false
+properties:
+    path:
+        type: string
+        description: |
+            TSV "название|синоним<TAB>широта<TAB>долгота"; пусто - координаты
+            только из запроса /mcadd
+        defaultDescription: ''
+    fs-task-processor:
+        type: string
+        description: task processor для чтения файла
+        defaultDescription: fs-task-processor
+)");
+}
+
+}  // namespace masterclasses::components
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <optional>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <userver/components/component_base.hpp>
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+#include "catalog/geo_index.hpp"
+
+namespace masterclasses::components {
+
+/// Локальный газеттир: названия мест (город, район, станция метро) и их
+/// координаты из TSV-файла `path`. Внешнего геокодера нет, поэтому
+/// /mcadd ищет в тексте адреса самое длинное известное название.
+class Gazetteer final : public userver::components::ComponentBase {
+  public:
+    static constexpr std::string_view kName = "gazetteer";
+
+    Gazetteer(const userver::components::ComponentConfig& config,
+              const userver::components::ComponentContext& context);
+
+    static userver::yaml_config::Schema GetStaticConfigSchema();
+
+    /// Точка самого длинного названия, встречающегося в `text` целыми
+    /// словами (без учёта регистра и пунктуации); nullopt, если ни одного.
+    std::optional<catalog::GeoPoint> Locate(std::string_view text) const;
+
+  private:
+    struct Place {
+        std::u16string key;  // " название ", нормализованное
+        catalog::GeoPoint point;
+    };
+
+    void Load(const std::string& path);
+
+    std::vector<Place> places_;  // по убыванию длины названия
+};
+
+}  // namespace masterclasses::components
+
+template <>
+inline constexpr bool userver::components::kHasValidate<
+    masterclasses::components::Gazetteer> = true;
@@ -0,0 +1,166 @@
+#include "components/hedged_reads.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <mutex>
+#include <vector>
+
+#include <userver/components/statistics_storage.hpp>
+#include <userver/storages/postgres/component.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace masterclasses::components {
+
+namespace {
+
+constexpr double kDefaultPercentile = 95.0;
+constexpr std::chrono::milliseconds kDefaultMinDelay{5};
+constexpr std::chrono::milliseconds kDefaultMaxDelay{200};
+constexpr double kDefaultMaxHedgeRatio = 0.05;
+constexpr double kDefaultBurst = 10.0;
+
+/// Пока замеров меньше, перцентиль не считаем и хеджируем по max-delay.
+constexpr std::size_t kMinSamples = 32;
+/// Перцентиль пересчитывается раз в столько замеров.
+constexpr std::size_t kRecomputeEvery = 32;
+
+}  // namespace
+
+HedgedReads::HedgedReads(const userver::components::ComponentConfig& config,
+                         const userver::components::ComponentContext& context)
+    : ComponentBase(config, context),
+      enabled_(config["enabled"].As<bool>(false)),
+      percentile_(config["percentile"].As<double>(kDefaultPercentile)),
+      min_delay_(config["min-delay"].As<std::chrono::milliseconds>(
+          kDefaultMinDelay)),
+      max_delay_(config["max-delay"].As<std::chrono::milliseconds>(
+          kDefaultMaxDelay)),
+      max_hedge_ratio_(
+          config["max-hedge-ratio"].As<double>(kDefaultMaxHedgeRatio)),
+      burst_(config["burst"].As<double>(kDefaultBurst)),
+      db_cluster_(context.FindComponent<userver::components::Postgres>("app-db")
+                      .GetCluster()),
+      tokens_(burst_) {
+    statistics_holder_ =
+        context.FindComponent<userver::components::StatisticsStorage>()
+            .GetStorage()
+            .RegisterWriter(
+                "masterclasses.hedged-reads",
+                [this](userver::utils::statistics::Writer& writer) {
+                    std::lock_guard lock(states_mutex_);
+                    for (const auto& [name, state] : states_) {
+                        const userver::utils::statistics::LabelView label{
+                            "query", name};
+                        writer["requests"].ValueWithLabels(
+                            state.requests.load(), label);
+                        writer["hedged"].ValueWithLabels(state.hedged.load(),
+                                                         label);
+                        writer["hedge-wins"].ValueWithLabels(
+                            state.hedge_wins.load(), label);
+                        writer["primary-wins"].ValueWithLabels(
+                            state.primary_wins.load(), label);
+                        writer["rate-limited"].ValueWithLabels(
+                            state.rate_limited.load(), label);
+                        writer["delay-us"].ValueWithLabels(
+                            state.delay_us.load(), label);
+                    }
+                });
+}
+
+HedgedReads::~HedgedReads() { statistics_holder_.Unregister(); }
+
+HedgedReads::QueryState& HedgedReads::StateFor(
+    const userver::storages::postgres::Query& query) {
+    const auto& name = query.GetName();
+    const std::string_view key =
+        name ? std::string_view{name->GetUnderlying()} : "unnamed";
+
+    std::lock_guard lock(states_mutex_);
+    auto it = states_.find(key);
+    if (it == states_.end()) {
+        it = states_.try_emplace(std::string{key}).first;
+    }
+    return it->second;
+}
+
+std::chrono::microseconds HedgedReads::HedgeDelay(
+    const QueryState& state) const {
+    const auto delay = state.delay_us.load();
+    if (delay == 0) {
+        return max_delay_;
+    }
+    return std::clamp(std::chrono::microseconds{delay}, min_delay_,
+                      max_delay_);
+}
+
+void HedgedReads::Record(QueryState& state,
+                         std::chrono::microseconds latency) {
+    std::lock_guard lock(state.mutex);
+    state.window[state.recorded % kWindowSize] = latency;
+    ++state.recorded;
+    if (state.recorded < kMinSamples ||
+        state.recorded % kRecomputeEvery != 0) {
+        return;
+    }
+
+    const auto size = std::min(state.recorded, kWindowSize);
+    std::vector<std::chrono::microseconds> samples(
+        state.window.begin(), state.window.begin() + size);
+    const auto rank = std::min(
+        size - 1, static_cast<std::size_t>(std::ceil(
+                      percentile_ / 100.0 * static_cast<double>(size))) -
+                      1);
+    std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+    state.delay_us = samples[rank].count();
+}
+
+void HedgedReads::AddHedgeBudget() {
+    std::lock_guard lock(tokens_mutex_);
+    tokens_ = std::min(burst_, tokens_ + max_hedge_ratio_);
+}
+
+bool HedgedReads::TryTakeHedgeToken() {
+    std::lock_guard lock(tokens_mutex_);
+    if (tokens_ < 1.0) {
+        return false;
+    }
+    tokens_ -= 1.0;
+    return true;
+}
+
+userver::yaml_config::Schema HedgedReads::GetStaticConfigSchema() {
+    return userver::yaml_config::MergeSchemas<
+        userver::components::ComponentBase>(R"(
+type: object
+description: хеджированные чтения с реплик
+additionalProperties: false
+properties:
+    enabled:
+        type: boolean
+        description: включить хеджирование; иначе обычный запрос на kSlave
+        defaultDescription: false
+    percentile:
+        type: number
+        description: перцентиль времён запроса, после которого хеджируем
+        defaultDescription: 95
+    min-delay:
+        type: string
+        description: нижняя граница задержки перед хеджем
+        defaultDescription: 5ms
+    max-delay:
+        type: string
+        description: верхняя граница задержки и задержка, пока мало замеров
+        defaultDescription: 200ms
+    max-hedge-ratio:
+        type: number
+        description: максимальная доля запросов, получающих хедж
+        defaultDescription: 0.05
+    burst:
+        type: number
+        description: сколько хеджей можно сделать подряд сверх доли
+        defaultDescription: 10
+)");
+}
+
+}  // namespace masterclasses::components
@@ -0,0 +1,173 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+
+#include <userver/components/component_base.hpp>
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/engine/mutex.hpp>
+#include <userver/engine/wait_any.hpp>
+#include <userver/storages/postgres/cluster.hpp>
+#include <userver/storages/postgres/query.hpp>
+#include <userver/storages/postgres/result_set.hpp>
+#include <userver/utils/async.hpp>
+#include <userver/utils/statistics/entry.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+#include "components/request_traces.hpp"
+
+namespace masterclasses::components {
+
+/// Хеджированные чтения с реплик для идемпотентных запросов. Если реплика
+/// не ответила за задержку, равную заданному перцентилю недавних времён
+/// этого запроса, тот же запрос уходит на следующую реплику (round-robin);
+/// побеждает первый ответ, проигравший отменяется. Доля хеджей ограничена
+/// бакетом токенов, чтобы при деградации всех реплик не удваивать нагрузку.
+class HedgedReads final : public userver::components::ComponentBase {
+  public:
+    static constexpr std::string_view kName = "hedged-reads";
+
+    HedgedReads(const userver::components::ComponentConfig& config,
+                const userver::components::ComponentContext& context);
+    ~HedgedReads() override;
+
+    static userver::yaml_config::Schema GetStaticConfigSchema();
+
+    template <typename... Args>
+    userver::storages::postgres::ResultSet Execute(
+        const userver::storages::postgres::CommandControl& command_control,
+        const userver::storages::postgres::Query& query,
+        const Args&... args);
+
+  private:
+    static constexpr std::size_t kWindowSize = 512;
+
+    /// Последние времена ответа запроса и кешированный перцентиль.
+    struct QueryState {
+        userver::engine::Mutex mutex;
+        std::array<std::chrono::microseconds, kWindowSize> window{};
+        std::size_t recorded{0};
+        std::atomic<std::int64_t> delay_us{0};
+
+        std::atomic<std::uint64_t> requests{0};
+        std::atomic<std::uint64_t> hedged{0};
+        std::atomic<std::uint64_t> hedge_wins{0};
+        std::atomic<std::uint64_t> primary_wins{0};
+        std::atomic<std::uint64_t> rate_limited{0};
+    };
+
+    QueryState& StateFor(const userver::storages::postgres::Query& query);
+    std::chrono::microseconds HedgeDelay(const QueryState& state) const;
+    void Record(QueryState& state, std::chrono::microseconds latency);
+    void AddHedgeBudget();
+    bool TryTakeHedgeToken();
+
+    bool enabled_;
+    double percentile_;
+    std::chrono::microseconds min_delay_;
+    std::chrono::microseconds max_delay_;
+    double max_hedge_ratio_;
+    double burst_;
+
+    userver::storages::postgres::ClusterPtr db_cluster_;
+
+    userver::engine::Mutex states_mutex_;
+    std::map<std::string, QueryState, std::less<>> states_;
+
+    userver::engine::Mutex tokens_mutex_;
+    double tokens_;
+
+    userver::utils::statistics::Entry statistics_holder_;
+};
+
+template <typename... Args>
+userver::storages::postgres::ResultSet HedgedReads::Execute(
+    const userver::storages::postgres::CommandControl& command_control,
+    const userver::storages::postgres::Query& query, const Args&... args) {
+    using ClusterHostType = userver::storages::postgres::ClusterHostType;
+
+    // Время до запроса - работа хэндлера, сам запрос - стадия db.
+    auto* trace = RequestTraces::Trace::Current();
+    if (trace != nullptr) {
+        trace->Mark("handler");
+    }
+    const auto note_read = [trace](bool hedged) {
+        if (trace != nullptr) {
+            trace->Mark("db");
+            trace->NoteReplicaRead(hedged);
+        }
+    };
+
+    if (!enabled_) {
+        auto result = db_cluster_->Execute(
+            ClusterHostType::kSlave, command_control, query, args...);
+        note_read(false);
+        return result;
+    }
+
+    auto& state = StateFor(query);
+    ++state.requests;
+    AddHedgeBudget();
+    const auto started = std::chrono::steady_clock::now();
+    const auto elapsed = [started] {
+        return std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - started);
+    };
+
+    auto primary = userver::utils::Async("hedged-read-primary", [&] {
+        return db_cluster_->Execute(ClusterHostType::kSlave, command_control,
+                                    query, args...);
+    });
+    primary.WaitFor(HedgeDelay(state));
+    if (primary.IsFinished() || !TryTakeHedgeToken()) {
+        if (!primary.IsFinished()) {
+            ++state.rate_limited;
+        }
+        auto result = primary.Get();
+        Record(state, elapsed());
+        note_read(false);
+        return result;
+    }
+
+    ++state.hedged;
+    auto hedge = userver::utils::Async("hedged-read-hedge", [&] {
+        return db_cluster_->Execute(
+            userver::storages::postgres::ClusterHostTypeFlags{
+                ClusterHostType::kSlave} |
+                ClusterHostType::kRoundRobin,
+            command_control, query, args...);
+    });
+
+    // Первый успешный ответ побеждает; если один упал - ждём второй.
+    // Деструктор проигравшей задачи отменяет её запрос.
+    const auto first = userver::engine::WaitAny(primary, hedge);
+    auto& winner = first == std::size_t{1} ? hedge : primary;
+    auto& loser = first == std::size_t{1} ? primary : hedge;
+    try {
+        auto result = winner.Get();
+        ++(first == std::size_t{1} ? state.hedge_wins : state.primary_wins);
+        loser.RequestCancel();
+        Record(state, elapsed());
+        note_read(first == std::size_t{1});
+        return result;
+    } catch (const std::exception&) {
+    }
+    auto result = loser.Get();
+    ++(first == std::size_t{1} ? state.primary_wins : state.hedge_wins);
+    Record(state, elapsed());
+    note_read(first != std::size_t{1});
+    return result;
+}
+
+}  // namespace masterclasses::components
+
+template <>
+inline constexpr bool userver::components::kHasValidate<
+    masterclasses::components::HedgedReads> = true;
@@ -0,0 +1,372 @@
+#include "components/masterclass_catalog.hpp"
+#include "catalog/snapshot_file.hpp"
+#include "sql/queries.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <type_traits>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include <userver/components/statistics_storage.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/storages/postgres/component.hpp>
+#include <userver/utils/async.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/utils/uuid4.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace masterclasses::components {
+
+namespace {
+
+using ClusterHostType = userver::storages::postgres::ClusterHostType;
+
+constexpr std::chrono::seconds kDefaultUpdatePeriod{30};
+constexpr std::chrono::seconds kDefaultSnapshotDumpPeriod{60};
+constexpr std::size_t kDefaultChangeLogSize = 1024;
+
+/// Оценка памяти строки в rows: сама структура и буферы строк, не
+/// поместившиеся в SSO.
+std::size_t RowBytes(const models::Masterclass& masterclass) {
+    static const std::size_t kInlineCapacity = std::string{}.capacity();
+    std::size_t bytes = sizeof(models::Masterclass);
+    models::VisitMasterclassFields([&](std::string_view, auto field) {
+        if constexpr (std::is_same_v<std::decay_t<decltype(masterclass.*field)>,
+                                     std::string>) {
+            const auto capacity = (masterclass.*field).capacity();
+            if (capacity > kInlineCapacity) {
+                bytes += capacity + 1;
+            }
+        }
+    });
+    return bytes;
+}
+
+void WriteStatistics(userver::utils::statistics::Writer& writer,
+                     const catalog::CatalogSnapshot& snapshot) {
+    const auto stats = snapshot.columns->GetStats();
+    std::size_t row_bytes = 0;
+    for (const auto& row : snapshot.rows) {
+        row_bytes += RowBytes(*row);
+    }
+    const auto per_row = [&stats](std::size_t bytes) {
+        return stats.rows == 0 ? 0 : bytes / stats.rows;
+    };
+    writer["rows"] = stats.rows;
+    writer["version"] = snapshot.version;
+    writer["row-bytes-per-row"] = per_row(row_bytes);
+    // Столбцы - не замена rows, а добавка к ним: честный итог - сумма.
+    writer["total-bytes"] = row_bytes + stats.bytes;
+    writer["total-bytes-per-row"] = per_row(row_bytes + stats.bytes);
+    writer["columns"]["bytes"] = stats.bytes;
+    writer["columns"]["bytes-per-row"] = per_row(stats.bytes);
+    writer["columns"]["tags-arena-bytes"] = stats.tags_bytes;
+    for (std::size_t i = 0; i < catalog::ColumnStore::kColumns; ++i) {
+        const auto column = static_cast<catalog::ColumnStore::Column>(i);
+        writer["dictionary-size"][catalog::ColumnStore::ColumnName(column)] =
+            stats.dictionary_sizes[i];
+    }
+}
+
+}  // namespace
+
+MasterclassCatalog::MasterclassCatalog(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : ComponentBase(config, context),
+      db_cluster_(context.FindComponent<userver::components::Postgres>("app-db")
+                      .GetCluster()),
+      fs_task_processor_(context.GetTaskProcessor(
+          config["fs-task-processor"].As<std::string>("fs-task-processor"))),
+      snapshot_path_(config["snapshot-path"].As<std::string>("")),
+      epoch_(userver::utils::generators::GenerateUuid()),
+      change_log_(config["change-log-size"].As<std::size_t>(
+          kDefaultChangeLogSize)) {
+    // Из файла каталог готов сразу, сверка с Postgres - первым шагом
+    // фоновой задачи. Без файла старт, как и раньше, ждёт загрузки из БД.
+    const bool from_file = LoadSnapshotFile();
+    if (!from_file) {
+        try {
+            Reload();
+        } catch (const std::exception& ex) {
+            LOG_WARNING() << "initial masterclass catalog load failed, "
+                             "handlers fall back to SQL: "
+                          << ex.what();
+        }
+    }
+
+    const auto period = config["update-period"].As<std::chrono::milliseconds>(
+        kDefaultUpdatePeriod);
+    userver::utils::PeriodicTask::Settings settings{period};
+    if (from_file) {
+        settings.flags = userver::utils::PeriodicTask::Flags::kNow;
+    }
+    reload_task_.Start("masterclass-catalog-reload", settings,
+                       [this] { Reload(); });
+
+    if (!snapshot_path_.empty()) {
+        const auto dump_period =
+            config["snapshot-dump-period"].As<std::chrono::milliseconds>(
+                kDefaultSnapshotDumpPeriod);
+        dump_task_.Start("masterclass-catalog-dump",
+                         userver::utils::PeriodicTask::Settings{dump_period},
+                         [this] { DumpSnapshotFile(); });
+    }
+
+    statistics_holder_ =
+        context.FindComponent<userver::components::StatisticsStorage>()
+            .GetStorage()
+            .RegisterWriter(
+                "masterclasses.catalog",
+                [this](userver::utils::statistics::Writer& writer) {
+                    if (const auto snapshot = GetSnapshot()) {
+                        WriteStatistics(writer, *snapshot);
+                    }
+                });
+}
+
+MasterclassCatalog::~MasterclassCatalog() {
+    statistics_holder_.Unregister();
+    dump_task_.Stop();
+    reload_task_.Stop();
+}
+
+std::shared_ptr<const catalog::CatalogSnapshot>
+MasterclassCatalog::GetSnapshot() const {
+    return *snapshot_.Read();
+}
+
+void MasterclassCatalog::Reload() {
+    // Версия до чтения: всё, что Upsert/Apply/Erase опубликуют, пока идёт
+    // SELECT, в прочитанных строках может не быть, и Diff откатил бы это
+    // (а /mclist/changes показал бы откат как удаление и повторную
+    // вставку). Такие id Diff не трогает - их сверит следующая перезагрузка.
+    std::optional<std::uint64_t> read_version;
+    {
+        std::lock_guard lock(write_mutex_);
+        if (const auto current = GetSnapshot()) {
+            read_version = current->version;
+        }
+    }
+
+    // С мастера: по отстающей реплике откатились бы и записи, сделанные
+    // до чтения.
+    const auto result = db_cluster_->Execute(ClusterHostType::kMaster,
+                                             sql::kSelectAllMasterclasses);
+
+    std::vector<catalog::MasterclassPtr> rows;
+    rows.reserve(result.Size());
+    for (const auto& row : result) {
+        rows.push_back(std::make_shared<const models::Masterclass>(
+            models::ParseMasterclassRow(row)));
+    }
+
+    std::lock_guard lock(write_mutex_);
+    const auto current = GetSnapshot();
+    if (!current) {
+        Publish(catalog::CatalogSnapshot::Build(std::move(rows)), {});
+        return;
+    }
+
+    std::unordered_set<std::int64_t> raced;
+    if (!read_version || current->version != *read_version) {
+        const auto changes = ChangesSince(read_version.value_or(0));
+        if (!read_version || changes.resync) {
+            // Журнал уже не покрывает время чтения: какие строки менялись,
+            // неизвестно, сверка - в следующий раз.
+            LOG_INFO() << "masterclass catalog reload skipped: catalog "
+                          "changed beyond the change log during the read";
+            return;
+        }
+        raced.insert(changes.touched.begin(), changes.touched.end());
+    }
+
+    // Перечитываем целиком, но индексы пересобираем только по изменившимся
+    // строкам.
+    std::vector<catalog::MasterclassPtr> upserts;
+    std::vector<std::int64_t> erased;
+    current->Diff(rows, upserts, erased);
+    if (!raced.empty()) {
+        std::erase_if(upserts, [&raced](const catalog::MasterclassPtr& row) {
+            return raced.contains(row->id);
+        });
+        std::erase_if(erased, [&raced](std::int64_t id) {
+            return raced.contains(id);
+        });
+    }
+    if (upserts.empty() && erased.empty()) {
+        return;
+    }
+    std::vector<std::int64_t> touched = erased;
+    for (const auto& row : upserts) {
+        touched.push_back(row->id);
+    }
+    Publish(current->Apply(std::move(upserts), std::move(erased)),
+            std::move(touched));
+}
+
+void MasterclassCatalog::Publish(
+    std::shared_ptr<const catalog::CatalogSnapshot> next,
+    std::vector<std::int64_t> touched) {
+    const auto version = next->version;
+    snapshot_.Assign(std::move(next));
+
+    {
+        std::lock_guard lock(log_mutex_);
+        change_log_.Record(version, std::move(touched));
+    }
+    log_changed_.NotifyAll();
+}
+
+MasterclassCatalog::Changes MasterclassCatalog::ChangesSince(
+    std::uint64_t since) const {
+    std::lock_guard lock(log_mutex_);
+    return change_log_.Since(since);
+}
+
+bool MasterclassCatalog::WaitForChanges(
+    std::uint64_t since, userver::engine::Deadline deadline) const {
+    std::unique_lock lock(log_mutex_);
+    return log_changed_.WaitUntil(lock, deadline, [this, since] {
+        return change_log_.Version() != since;
+    });
+}
+
+bool MasterclassCatalog::LoadSnapshotFile() {
+    if (snapshot_path_.empty()) {
+        return false;
+    }
+    try {
+        auto rows = userver::utils::Async(
+                        fs_task_processor_, "masterclass-catalog-read",
+                        [this] {
+                            return catalog::ReadSnapshotFile(snapshot_path_);
+                        })
+                        .Get();
+        const auto size = rows.size();
+        auto snapshot = catalog::CatalogSnapshot::Build(std::move(rows));
+        dumped_ = snapshot;
+        std::lock_guard lock(write_mutex_);
+        Publish(std::move(snapshot), {});
+        LOG_INFO() << "masterclass catalog loaded from " << snapshot_path_
+                   << ", " << size << " rows";
+        return true;
+    } catch (const std::exception& ex) {
+        LOG_WARNING() << "masterclass catalog snapshot file not used: "
+                      << ex.what();
+        return false;
+    }
+}
+
+void MasterclassCatalog::DumpSnapshotFile() {
+    const auto snapshot = GetSnapshot();
+    if (!snapshot || snapshot == dumped_) {
+        return;
+    }
+    userver::utils::Async(fs_task_processor_, "masterclass-catalog-write",
+                          [this, &snapshot] {
+                              catalog::WriteSnapshotFile(*snapshot,
+                                                         snapshot_path_);
+                          })
+        .Get();
+    dumped_ = snapshot;
+}
+
+void MasterclassCatalog::Upsert(models::Masterclass masterclass) {
+    std::lock_guard lock(write_mutex_);
+    const auto current = GetSnapshot();
+    if (!current) {
+        return;
+    }
+    const auto id = masterclass.id;
+    Publish(current->Apply({std::make_shared<const models::Masterclass>(
+                               std::move(masterclass))},
+                           {}),
+            {id});
+}
+
+void MasterclassCatalog::Erase(std::int64_t id) {
+    Erase(std::vector<std::int64_t>{id});
+}
+
+void MasterclassCatalog::Erase(std::vector<std::int64_t> ids) {
+    std::lock_guard lock(write_mutex_);
+    const auto current = GetSnapshot();
+    if (!current) {
+        return;
+    }
+    std::erase_if(ids, [&current](std::int64_t id) {
+        return current->FindById(id) == nullptr;
+    });
+    if (ids.empty()) {
+        return;
+    }
+    auto touched = ids;
+    Publish(current->Apply({}, std::move(ids)), std::move(touched));
+}
+
+void MasterclassCatalog::Apply(std::vector<models::Masterclass> upserts,
+                               std::vector<std::int64_t> erased) {
+    std::lock_guard lock(write_mutex_);
+    const auto current = GetSnapshot();
+    if (!current) {
+        return;
+    }
+    std::erase_if(erased, [&current](std::int64_t id) {
+        return current->FindById(id) == nullptr;
+    });
+    if (upserts.empty() && erased.empty()) {
+        return;
+    }
+    std::vector<std::int64_t> touched = erased;
+    std::vector<catalog::MasterclassPtr> rows;
+    rows.reserve(upserts.size());
+    for (auto& masterclass : upserts) {
+        touched.push_back(masterclass.id);
+        rows.push_back(std::make_shared<const models::Masterclass>(
+            std::move(masterclass)));
+    }
+    Publish(current->Apply(std::move(rows), std::move(erased)),
+            std::move(touched));
+}
+
+userver::yaml_config::Schema MasterclassCatalog::GetStaticConfigSchema() {
+    return userver::yaml_config::MergeSchemas<
+        userver::components::ComponentBase>(R"(
+type: object
+description: in-memory копия таблицы masterclasses
+additionalProperties: false
+properties:
+    update-period:
+        type: string
+        description: период полной перезагрузки каталога из БД
+        defaultDescription: 30s
+    snapshot-path:
+        type: string
+        description: |
+            двоичный файл снимка каталога для старта без БД; пусто - не
+            сбрасывать и не читать
+        defaultDescription: ''
+    snapshot-dump-period:
+        type: string
+        description: как часто сбрасывать изменившийся каталог в файл
+        defaultDescription: 1m
+    fs-task-processor:
+        type: string
+        description: task processor для чтения и записи файла снимка
+        defaultDescription: fs-task-processor
+    change-log-size:
+        type: integer
+        description: |
+            сколько последних версий каталога помнит журнал изменений;
+            клиенты, отставшие сильнее, получают resync
+        defaultDescription: 1024
+)");
+}
+
+}  // namespace masterclasses::components
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <userver/components/component_base.hpp>
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/engine/condition_variable.hpp>
+#include <userver/engine/deadline.hpp>
+#include <userver/engine/mutex.hpp>
+#include <userver/engine/task/task_processor_fwd.hpp>
+#include <userver/rcu/rcu.hpp>
+#include <userver/storages/postgres/cluster.hpp>
+#include <userver/utils/periodic_task.hpp>
+#include <userver/utils/statistics/entry.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+#include "catalog/change_log.hpp"
+#include "catalog/snapshot.hpp"
+#include "models/masterclass.hpp"
+
+namespace masterclasses::components {
+
+/// In-memory копия таблицы masterclasses. Загружается при старте,
+/// периодически перечитывается целиком, а /mcadd и /mcdelete этого
+/// инстанса применяют свои изменения сразу. Если задан snapshot-path,
+/// каталог периодически сбрасывается в двоичный файл, и следующий старт
+/// поднимается из него, не дожидаясь Postgres. Последние изменения
+/// хранятся в ограниченном журнале для /mclist/changes. Память строк и
+/// столбцов каталога видна в метриках masterclasses.catalog.
+class MasterclassCatalog final : public userver::components::ComponentBase {
+  public:
+    static constexpr std::string_view kName = "masterclass-catalog";
+
+    MasterclassCatalog(const userver::components::ComponentConfig& config,
+                       const userver::components::ComponentContext& context);
+    ~MasterclassCatalog() override;
+
+    static userver::yaml_config::Schema GetStaticConfigSchema();
+
+    /// nullptr, пока каталог ни разу не загрузился из БД или файла.
+    std::shared_ptr<const catalog::CatalogSnapshot> GetSnapshot() const;
+
+    void Upsert(models::Masterclass masterclass);
+    void Erase(std::int64_t id);
+    /// Пакетом, одной новой версией снимка (перенос в архив).
+    void Erase(std::vector<std::int64_t> ids);
+    /// Изменения синхронизации одной новой версией снимка.
+    void Apply(std::vector<models::Masterclass> upserts,
+               std::vector<std::int64_t> erased);
+
+    /// В touched удалены те id, которых нет в снимке.
+    using Changes = catalog::ChangeLog::Changes;
+
+    /// Случайная метка запуска: версии разных инстансов и перезапусков
+    /// между собой не сравнимы.
+    const std::string& Epoch() const { return epoch_; }
+
+    /// Читать до GetSnapshot(): снимок публикуется раньше записи в журнал,
+    /// так что он не старше возвращённой версии.
+    Changes ChangesSince(std::uint64_t since) const;
+
+    /// Ждёт версии, отличной от `since`; false, если дождались deadline.
+    bool WaitForChanges(std::uint64_t since,
+                        userver::engine::Deadline deadline) const;
+
+  private:
+    /// Публикует снимок и пишет его изменения в журнал; под write_mutex_.
+    void Publish(std::shared_ptr<const catalog::CatalogSnapshot> next,
+                 std::vector<std::int64_t> touched);
+
+    void Reload();
+    bool LoadSnapshotFile();
+    void DumpSnapshotFile();
+
+    userver::storages::postgres::ClusterPtr db_cluster_;
+    userver::engine::TaskProcessor& fs_task_processor_;
+    std::string snapshot_path_;
+    userver::engine::Mutex write_mutex_;
+    userver::rcu::Variable<std::shared_ptr<const catalog::CatalogSnapshot>>
+        snapshot_;
+    std::string epoch_;
+    mutable userver::engine::Mutex log_mutex_;
+    mutable userver::engine::ConditionVariable log_changed_;
+    catalog::ChangeLog change_log_;  // под log_mutex_
+
+    // Принадлежит задаче сброса.
+    std::shared_ptr<const catalog::CatalogSnapshot> dumped_;
+    userver::utils::PeriodicTask reload_task_;
+    userver::utils::PeriodicTask dump_task_;
+    userver::utils::statistics::Entry statistics_holder_;
+};
+
+}  // namespace masterclasses::components
+
+template <>
+inline constexpr bool userver::components::kHasValidate<
+    masterclasses::components::MasterclassCatalog> = true;
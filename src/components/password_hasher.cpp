@@ -0,0 +1,252 @@
+#include "components/password_hasher.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include <openssl/evp.h>
+#include <openssl/rand.h>
+
+#include <userver/components/statistics_storage.hpp>
+#include <userver/crypto/algorithm.hpp>
+#include <userver/crypto/base64.hpp>
+#include <userver/crypto/hash.hpp>
+#include <userver/formats/json/inline.hpp>
+#include <userver/formats/json/serialize.hpp>
+#include <userver/utils/async.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace masterclasses::components {
+
+namespace {
+
+constexpr std::string_view kScryptPrefix = "scrypt";
+constexpr std::size_t kSaltSize = 16;
+constexpr std::size_t kKeySize = 32;
+
+constexpr std::uint64_t kDefaultN = 16384;
+constexpr std::uint64_t kDefaultR = 8;
+constexpr std::uint64_t kDefaultP = 1;
+constexpr std::int64_t kDefaultMaxQueue = 64;
+
+/// Разбивает `scrypt$N$r$p$salt$key` на части; false, если это не он.
+bool SplitScrypt(std::string_view stored,
+                 std::array<std::string_view, 6>& parts) {
+    std::size_t count = 0;
+    for (std::size_t begin = 0; begin <= stored.size();) {
+        const auto end = std::min(stored.find('$', begin), stored.size());
+        if (count == parts.size()) {
+            return false;
+        }
+        parts[count++] = stored.substr(begin, end - begin);
+        begin = end + 1;
+    }
+    return count == parts.size() && parts[0] == kScryptPrefix;
+}
+
+bool ParseUint(std::string_view raw, std::uint64_t& value) {
+    const auto* end = raw.data() + raw.size();
+    const auto [ptr, ec] = std::from_chars(raw.data(), end, value);
+    return ec == std::errc{} && ptr == end && value > 0;
+}
+
+std::string Scrypt(std::string_view password, std::string_view salt,
+                   std::uint64_t n, std::uint64_t r, std::uint64_t p) {
+    // Ровно столько памяти, сколько scrypt займёт при этих параметрах.
+    const std::uint64_t max_memory = 128 * r * (n + p + 2);
+    std::string key(kKeySize, '\0');
+    if (EVP_PBE_scrypt(password.data(), password.size(),
+                       reinterpret_cast<const unsigned char*>(salt.data()),
+                       salt.size(), n, r, p, max_memory,
+                       reinterpret_cast<unsigned char*>(key.data()),
+                       key.size()) != 1) {
+        throw std::runtime_error("scrypt failed");
+    }
+    return key;
+}
+
+std::int64_t ElapsedMs(std::chrono::steady_clock::time_point started) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+               std::chrono::steady_clock::now() - started)
+        .count();
+}
+
+void WriteLatency(userver::utils::statistics::Writer& writer,
+                  const userver::utils::statistics::Percentile<1000>& stats) {
+    writer["p50"] = stats.GetPercentile(50);
+    writer["p95"] = stats.GetPercentile(95);
+    writer["p99"] = stats.GetPercentile(99);
+}
+
+}  // namespace
+
+PasswordHasher::PasswordHasher(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : ComponentBase(config, context),
+      task_processor_(context.GetTaskProcessor(
+          config["task-processor"].As<std::string>())),
+      params_{config["scrypt-n"].As<std::uint64_t>(kDefaultN),
+              config["scrypt-r"].As<std::uint64_t>(kDefaultR),
+              config["scrypt-p"].As<std::uint64_t>(kDefaultP)},
+      max_queue_(config["max-queue"].As<std::int64_t>(kDefaultMaxQueue)) {
+    if (params_.n < 2 || (params_.n & (params_.n - 1)) != 0) {
+        throw std::runtime_error("password-hasher: scrypt-n must be a power "
+                                 "of two");
+    }
+
+    statistics_holder_ =
+        context.FindComponent<userver::components::StatisticsStorage>()
+            .GetStorage()
+            .RegisterWriter(
+                "masterclasses.password-hasher",
+                [this](userver::utils::statistics::Writer& writer) {
+                    writer["queued"] = queued_.load();
+                    writer["rejected"] = rejected_.load();
+                    writer["hashed"] = hashed_.load();
+                    writer["verified-ok"] = verified_ok_.load();
+                    writer["verified-failed"] = verified_failed_.load();
+                    writer["legacy"] = legacy_.load();
+                    WriteLatency(writer["hash-ms"],
+                                 hash_latency_.GetStatsForPeriod());
+                    WriteLatency(writer["verify-ms"],
+                                 verify_latency_.GetStatsForPeriod());
+                });
+}
+
+PasswordHasher::~PasswordHasher() { statistics_holder_.Unregister(); }
+
+template <typename Function>
+auto PasswordHasher::RunBounded(Latency& latency, Function&& function) {
+    // Очередь ограничена: лучше быстро отказать части входов, чем копить
+    // задачи, ответ на которые клиент уже не дождётся.
+    if (++queued_ > max_queue_) {
+        --queued_;
+        ++rejected_;
+        throw QueueFull{};
+    }
+    const auto started = std::chrono::steady_clock::now();
+    try {
+        auto result = userver::utils::Async(task_processor_, "password-hash",
+                                            std::forward<Function>(function))
+                          .Get();
+        --queued_;
+        latency.GetCurrentCounter().Account(
+            static_cast<std::size_t>(ElapsedMs(started)));
+        return result;
+    } catch (...) {
+        --queued_;
+        throw;
+    }
+}
+
+std::string PasswordHasher::Hash(std::string_view password) {
+    auto hash = RunBounded(hash_latency_, [this, password] {
+        return HashWith(password, params_);
+    });
+    ++hashed_;
+    return hash;
+}
+
+PasswordHasher::Match PasswordHasher::Verify(std::string_view password,
+                                             std::string_view stored) {
+    const auto match = RunBounded(verify_latency_, [this, password, stored] {
+        return VerifyNow(password, stored);
+    });
+    ++(match == Match::kNo ? verified_failed_ : verified_ok_);
+    if (match != Match::kNo && !stored.starts_with(kScryptPrefix)) {
+        ++legacy_;
+    }
+    return match;
+}
+
+std::string PasswordHasher::RenderQueueFull(
+    const userver::server::http::HttpRequest& request) const {
+    auto& response = request.GetHttpResponse();
+    response.SetContentType(userver::http::content_type::kApplicationJson);
+    response.SetHeader(std::string{"Retry-After"}, std::string{"1"});
+    request.SetResponseStatus(
+        userver::server::http::HttpStatus::kServiceUnavailable);
+    return userver::formats::json::ToString(userver::formats::json::MakeObject(
+        "status", "error", "message", "too many sign-ins, retry later"));
+}
+
+std::string PasswordHasher::HashWith(std::string_view password,
+                                     const Params& params) const {
+    std::string salt(kSaltSize, '\0');
+    if (RAND_bytes(reinterpret_cast<unsigned char*>(salt.data()),
+                   static_cast<int>(salt.size())) != 1) {
+        throw std::runtime_error("RAND_bytes failed");
+    }
+    const auto key = Scrypt(password, salt, params.n, params.r, params.p);
+
+    std::string stored{kScryptPrefix};
+    stored.append("$").append(std::to_string(params.n));
+    stored.append("$").append(std::to_string(params.r));
+    stored.append("$").append(std::to_string(params.p));
+    stored.append("$").append(userver::crypto::base64::Base64Encode(salt));
+    stored.append("$").append(userver::crypto::base64::Base64Encode(key));
+    return stored;
+}
+
+PasswordHasher::Match PasswordHasher::VerifyNow(
+    std::string_view password, std::string_view stored) const {
+    std::array<std::string_view, 6> parts;
+    if (!SplitScrypt(stored, parts)) {
+        // Хеши до перехода на scrypt: SHA-256 в hex.
+        return userver::crypto::algorithm::AreStringsEqualConstTime(
+                   userver::crypto::hash::Sha256(password), stored)
+                   ? Match::kYesNeedsRehash
+                   : Match::kNo;
+    }
+
+    Params params{};
+    if (!ParseUint(parts[1], params.n) || !ParseUint(parts[2], params.r) ||
+        !ParseUint(parts[3], params.p)) {
+        return Match::kNo;
+    }
+    const auto salt = userver::crypto::base64::Base64Decode(parts[4]);
+    const auto expected = userver::crypto::base64::Base64Decode(parts[5]);
+    const auto key = Scrypt(password, salt, params.n, params.r, params.p);
+    if (!userver::crypto::algorithm::AreStringsEqualConstTime(key, expected)) {
+        return Match::kNo;
+    }
+    const bool current = params.n == params_.n && params.r == params_.r &&
+                         params.p == params_.p;
+    return current ? Match::kYes : Match::kYesNeedsRehash;
+}
+
+userver::yaml_config::Schema PasswordHasher::GetStaticConfigSchema() {
+    return userver::yaml_config::MergeSchemas<
+        userver::components::ComponentBase>(R"(
+type: object
+description: хеширование паролей scrypt на отдельном task processor
+additionalProperties: false
+properties:
+    task-processor:
+        type: string
+        description: task processor, на котором считаются хеши
+    max-queue:
+        type: integer
+        description: сколько операций может ждать или считаться одновременно
+        defaultDescription: 64
+    scrypt-n:
+        type: integer
+        description: параметр стоимости N (степень двойки)
+        defaultDescription: 16384
+    scrypt-r:
+        type: integer
+        description: размер блока r
+        defaultDescription: 8
+    scrypt-p:
+        type: integer
+        description: параллелизм p
+        defaultDescription: 1
+)");
+}
+
+}  // namespace masterclasses::components
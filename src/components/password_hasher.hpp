@@ -0,0 +1,93 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <userver/components/component_base.hpp>
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/engine/task/task_processor_fwd.hpp>
+#include <userver/server/http/http_request.hpp>
+#include <userver/utils/statistics/entry.hpp>
+#include <userver/utils/statistics/percentile.hpp>
+#include <userver/utils/statistics/recentperiod.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+namespace masterclasses::components {
+
+/// Хеширование паролей scrypt на отдельном task processor: вход и
+/// регистрация ждут результат, но не занимают потоки main-task-processor.
+/// Хеш хранится как `scrypt$N$r$p$<соль>$<ключ>` (base64). Старые хеши -
+/// голый SHA-256 в hex - проверяются как раньше и помечаются на перехеш.
+class PasswordHasher final : public userver::components::ComponentBase {
+  public:
+    static constexpr std::string_view kName = "password-hasher";
+
+    /// В очереди уже max-queue операций - клиенту стоит повторить позже.
+    class QueueFull : public std::runtime_error {
+      public:
+        QueueFull() : std::runtime_error("password hasher queue is full") {}
+    };
+
+    enum class Match {
+        kNo,
+        kYes,
+        /// Пароль верный, но хеш старый (SHA-256 или другие параметры).
+        kYesNeedsRehash,
+    };
+
+    PasswordHasher(const userver::components::ComponentConfig& config,
+                   const userver::components::ComponentContext& context);
+    ~PasswordHasher() override;
+
+    static userver::yaml_config::Schema GetStaticConfigSchema();
+
+    /// Бросают QueueFull при переполнении очереди.
+    std::string Hash(std::string_view password);
+    Match Verify(std::string_view password, std::string_view stored);
+
+    /// Ответ на QueueFull: 503 и Retry-After, возвращает тело ответа.
+    std::string RenderQueueFull(
+        const userver::server::http::HttpRequest& request) const;
+
+  private:
+    struct Params {
+        std::uint64_t n;
+        std::uint64_t r;
+        std::uint64_t p;
+    };
+
+    using LatencyPercentile = userver::utils::statistics::Percentile<1000>;
+    using Latency = userver::utils::statistics::RecentPeriod<LatencyPercentile,
+                                                             LatencyPercentile>;
+
+    template <typename Function>
+    auto RunBounded(Latency& latency, Function&& function);
+
+    std::string HashWith(std::string_view password, const Params& params) const;
+    Match VerifyNow(std::string_view password, std::string_view stored) const;
+
+    userver::engine::TaskProcessor& task_processor_;
+    Params params_;
+    std::int64_t max_queue_;
+
+    std::atomic<std::int64_t> queued_{0};
+    std::atomic<std::uint64_t> rejected_{0};
+    std::atomic<std::uint64_t> hashed_{0};
+    std::atomic<std::uint64_t> verified_ok_{0};
+    std::atomic<std::uint64_t> verified_failed_{0};
+    std::atomic<std::uint64_t> legacy_{0};
+    Latency hash_latency_;
+    Latency verify_latency_;
+
+    userver::utils::statistics::Entry statistics_holder_;
+};
+
+}  // namespace masterclasses::components
+
+template <>
+inline constexpr bool userver::components::kHasValidate<
+    masterclasses::components::PasswordHasher> = true;
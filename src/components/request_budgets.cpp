@@ -0,0 +1,281 @@
+#include "components/request_budgets.hpp"
+#include "components/admission_control.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <string>
+
+#include <userver/components/statistics_storage.hpp>
+#include <userver/engine/task/cancel.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace masterclasses::components {
+
+namespace {
+
+constexpr std::chrono::milliseconds kDefaultTimeout{2000};
+constexpr std::chrono::milliseconds kDefaultStatementTimeout{1000};
+constexpr std::chrono::milliseconds kMinRemaining{1};
+
+std::string_view BaseName(std::string_view path) {
+    const auto slash = path.rfind('/');
+    return slash == std::string_view::npos ? path : path.substr(slash + 1);
+}
+
+}  // namespace
+
+RequestBudgets::Budget::Budget(
+    HandlerState& state, std::chrono::steady_clock::time_point deadline,
+    std::chrono::milliseconds statement_timeout, RequestTraces& traces,
+    AdmissionControl& admission, std::string_view handler_name,
+    const userver::server::http::HttpRequest& request)
+    : state_(state),
+      admission_(admission),
+      handler_name_(handler_name),
+      started_(std::chrono::steady_clock::now()),
+      deadline_(deadline),
+      statement_timeout_(statement_timeout),
+      uncaught_exceptions_(std::uncaught_exceptions()),
+      trace_(traces, handler_name, request) {
+    ++state_.started;
+}
+
+RequestBudgets::Budget::~Budget() {
+    try {
+        CheckRegressions();
+    } catch (const std::exception&) {
+        // Проверка регрессий не должна ронять запрос.
+    }
+    if (std::uncaught_exceptions() <= uncaught_exceptions_) {
+        return;
+    }
+    if (userver::engine::current_task::ShouldCancel()) {
+        ++state_.cancelled;
+    } else if (std::chrono::steady_clock::now() >= deadline_) {
+        ++state_.timeouts;
+    }
+}
+
+void RequestBudgets::Budget::CheckRegressions() const {
+    state_.db_round_trips += db_round_trips_;
+    if (state_.max_db_round_trips != 0 &&
+        db_round_trips_ > state_.max_db_round_trips) {
+        ++state_.round_trips_exceeded;
+        LOG_LIMITED_WARNING()
+            << handler_name_ << ": " << db_round_trips_
+            << " DB round trips per request, budget "
+            << state_.max_db_round_trips << "; " << DescribeDbCalls();
+    }
+
+    const auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - started_);
+    if (state_.latency_ceiling.count() != 0 &&
+        elapsed > state_.latency_ceiling) {
+        ++state_.latency_exceeded;
+        LOG_LIMITED_WARNING()
+            << handler_name_ << ": request took " << elapsed.count()
+            << "ms, ceiling " << state_.latency_ceiling.count() << "ms; "
+            << DescribeDbCalls();
+    }
+}
+
+std::string RequestBudgets::Budget::DescribeDbCalls() const {
+    // "db calls: mc_sync_handler.cpp:151 x120, mc_sync_handler.cpp:123"
+    std::string description = "db calls:";
+    if (db_round_trips_ == 0) {
+        return description + " none";
+    }
+    std::uint32_t described = 0;
+    for (std::size_t i = 0; i < db_call_site_count_; ++i) {
+        const auto& site = db_call_sites_[i];
+        description += i == 0 ? " " : ", ";
+        description += BaseName(site.location.file_name());
+        description += ':';
+        description += std::to_string(site.location.line());
+        if (site.calls > 1) {
+            description += " x" + std::to_string(site.calls);
+        }
+        described += site.calls;
+    }
+    if (described < db_round_trips_) {
+        description +=
+            ", +" + std::to_string(db_round_trips_ - described) + " more";
+    }
+    return description;
+}
+
+RequestBudgets::Budget::DbCall::DbCall(
+    const Budget& budget, userver::storages::postgres::CommandControl control)
+    : CommandControl(control),
+      budget_(budget),
+      started_(std::chrono::steady_clock::now()) {}
+
+RequestBudgets::Budget::DbCall::~DbCall() {
+    budget_.admission_.ObserveDbLatency(
+        budget_.handler_name_, std::chrono::steady_clock::now() - started_);
+}
+
+RequestBudgets::Budget::DbCall RequestBudgets::Budget::Db(
+    std::source_location location) const {
+    ++db_round_trips_;
+    trace_.NoteDbRoundTrip();
+    const auto site = std::find_if(
+        db_call_sites_.begin(), db_call_sites_.begin() + db_call_site_count_,
+        [&location](const DbCallSite& known) {
+            return known.location.line() == location.line() &&
+                   std::string_view{known.location.file_name()} ==
+                       location.file_name();
+        });
+    if (site != db_call_sites_.begin() + db_call_site_count_) {
+        ++site->calls;
+    } else if (db_call_site_count_ < db_call_sites_.size()) {
+        db_call_sites_[db_call_site_count_++] = {location, 1};
+    }
+
+    // Истёкший бюджет всё равно отдаём минимальным таймаутом: запрос
+    // упадёт сразу, а не займёт соединение.
+    const auto remaining = std::max(
+        kMinRemaining, std::chrono::duration_cast<std::chrono::milliseconds>(
+                           deadline_ - std::chrono::steady_clock::now()));
+    return DbCall{*this,
+                  userver::storages::postgres::CommandControl{
+                      remaining, std::min(remaining, statement_timeout_)}};
+}
+
+userver::engine::Deadline RequestBudgets::Budget::Deadline() const {
+    return userver::engine::Deadline::FromTimePoint(deadline_);
+}
+
+RequestBudgets::RequestBudgets(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : ComponentBase(config, context),
+      traces_(context.FindComponent<RequestTraces>()),
+      admission_(context.FindComponent<AdmissionControl>()),
+      client_timeout_header_(config["client-timeout-header"].As<std::string>(
+          "X-Request-Timeout-Ms")),
+      statement_timeout_(
+          config["statement-timeout"].As<std::chrono::milliseconds>(
+              kDefaultStatementTimeout)) {
+    default_state_.timeout =
+        config["default-timeout"].As<std::chrono::milliseconds>(
+            kDefaultTimeout);
+    const auto& handlers = config["handlers"];
+    for (auto it = handlers.begin(); it != handlers.end(); ++it) {
+        auto& state = handlers_[it.GetName()];
+        state.timeout = (*it)["timeout"].As<std::chrono::milliseconds>(
+            default_state_.timeout);
+        state.max_db_round_trips =
+            (*it)["max-db-round-trips"].As<std::uint32_t>(0);
+        state.latency_ceiling =
+            (*it)["latency-ceiling"].As<std::chrono::milliseconds>(
+                std::chrono::milliseconds{0});
+    }
+
+    statistics_holder_ =
+        context.FindComponent<userver::components::StatisticsStorage>()
+            .GetStorage()
+            .RegisterWriter(
+                "masterclasses.db-budget",
+                [this](userver::utils::statistics::Writer& writer) {
+                    for (const auto& [name, state] : handlers_) {
+                        const userver::utils::statistics::LabelView label{
+                            "handler", name};
+                        writer["started"].ValueWithLabels(state.started.load(),
+                                                          label);
+                        writer["timeouts"].ValueWithLabels(
+                            state.timeouts.load(), label);
+                        writer["cancelled"].ValueWithLabels(
+                            state.cancelled.load(), label);
+                        writer["db-round-trips"].ValueWithLabels(
+                            state.db_round_trips.load(), label);
+                        writer["round-trips-exceeded"].ValueWithLabels(
+                            state.round_trips_exceeded.load(), label);
+                        writer["latency-exceeded"].ValueWithLabels(
+                            state.latency_exceeded.load(), label);
+                    }
+                });
+}
+
+RequestBudgets::~RequestBudgets() { statistics_holder_.Unregister(); }
+
+RequestBudgets::HandlerState& RequestBudgets::StateFor(
+    std::string_view handler_name) {
+    const auto it = handlers_.find(handler_name);
+    return it == handlers_.end() ? default_state_ : it->second;
+}
+
+RequestBudgets::Budget RequestBudgets::Start(
+    std::string_view handler_name,
+    const userver::server::http::HttpRequest& request) {
+    auto& state = StateFor(handler_name);
+    auto timeout = state.timeout;
+
+    // Клиент может только сократить бюджет: мусор в заголовке игнорируем.
+    const auto& header = request.GetHeader(client_timeout_header_);
+    if (!header.empty()) {
+        try {
+            const auto client_ms = std::stoll(header);
+            if (client_ms > 0) {
+                timeout = std::min(timeout,
+                                   std::chrono::milliseconds{client_ms});
+            }
+        } catch (const std::exception&) {
+        }
+    }
+    return Budget{state, std::chrono::steady_clock::now() + timeout,
+                  statement_timeout_, traces_, admission_, handler_name,
+                  request};
+}
+
+userver::yaml_config::Schema RequestBudgets::GetStaticConfigSchema() {
+    return userver::yaml_config::MergeSchemas<
+        userver::components::ComponentBase>(R"(
+type: object
+description: дедлайны запросов и таймауты обращений к БД
+additionalProperties: false
+properties:
+    client-timeout-header:
+        type: string
+        description: заголовок с оставшимся у клиента временем, мс
+        defaultDescription: X-Request-Timeout-Ms
+    default-timeout:
+        type: string
+        description: бюджет хэндлера, не перечисленного в handlers
+        defaultDescription: 2s
+    statement-timeout:
+        type: string
+        description: верхняя граница statement_timeout одного запроса
+        defaultDescription: 1s
+    handlers:
+        type: object
+        description: бюджеты по имени компонента хэндлера
+        properties: {}
+        additionalProperties:
+            type: object
+            description: бюджет одного хэндлера
+            additionalProperties: false
+            properties:
+                timeout:
+                    type: string
+                    description: время на весь запрос, включая все обращения к БД
+                max-db-round-trips:
+                    type: integer
+                    description: |
+                        сколько обращений к БД на запрос ещё не регрессия;
+                        0 - без предела
+                    defaultDescription: 0
+                    minimum: 0
+                latency-ceiling:
+                    type: string
+                    description: |
+                        время ответа, выше которого запрос считается
+                        регрессией; в отличие от timeout, запрос не
+                        прерывается
+                    defaultDescription: 0ms
+)");
+}
+
+}  // namespace masterclasses::components
@@ -0,0 +1,158 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <map>
+#include <source_location>
+#include <string>
+#include <string_view>
+
+#include <userver/components/component_base.hpp>
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/engine/deadline.hpp>
+#include <userver/server/http/http_request.hpp>
+#include <userver/storages/postgres/options.hpp>
+#include <userver/utils/statistics/entry.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+#include "components/request_traces.hpp"
+
+namespace masterclasses::components {
+
+class AdmissionControl;
+
+/// Бюджеты времени запросов к БД. Дедлайн запроса - меньшее из таймаута
+/// хэндлера в конфиге и оставшегося времени клиента из заголовка
+/// (client-timeout-header, миллисекунды); каждый запрос в Postgres получает
+/// CommandControl с остатком бюджета, так что запрос, до которого клиенту
+/// уже нет дела, не держит соединение из пула. Хэндлеры начинают бюджет до
+/// очереди admission-control, так что ожидание места тоже его тратит.
+/// Бюджет же ведёт трассу запроса (RequestTraces::Trace) и следит за
+/// регрессиями: у хэндлера может быть предел обращений к БД на запрос
+/// (max-db-round-trips) и потолок времени ответа (latency-ceiling).
+/// Превышение не прерывает запрос, а попадает в метрики и в лог с местами
+/// обращений к БД, так что лишний запрос виден с точностью до строки.
+/// Время каждого обращения к БД уходит в admission-control как сигнал
+/// перегрузки Postgres.
+class RequestBudgets final : public userver::components::ComponentBase {
+    struct HandlerState {
+        std::chrono::milliseconds timeout{0};
+        std::uint32_t max_db_round_trips{0};  // 0 - без предела
+        std::chrono::milliseconds latency_ceiling{0};  // 0 - без потолка
+        std::atomic<std::uint64_t> started{0};
+        std::atomic<std::uint64_t> timeouts{0};
+        std::atomic<std::uint64_t> cancelled{0};
+        std::atomic<std::uint64_t> db_round_trips{0};
+        std::atomic<std::uint64_t> round_trips_exceeded{0};
+        std::atomic<std::uint64_t> latency_exceeded{0};
+    };
+
+  public:
+    static constexpr std::string_view kName = "request-budgets";
+
+    /// Бюджет одного запроса. Если запрос завершается исключением,
+    /// деструктор относит его к таймаутам (дедлайн истёк) или к отменам
+    /// (клиент ушёл, задача отменена).
+    class Budget {
+      public:
+        /// CommandControl одного обращения к БД. Живёт как временный
+        /// объект до конца полного выражения, то есть до возврата из
+        /// Execute, и деструктором сообщает время обращения в
+        /// admission-control.
+        class DbCall final
+            : public userver::storages::postgres::CommandControl {
+          public:
+            DbCall(const DbCall&) = delete;
+            DbCall& operator=(const DbCall&) = delete;
+            ~DbCall();
+
+          private:
+            friend class Budget;
+            DbCall(const Budget& budget,
+                   userver::storages::postgres::CommandControl control);
+
+            const Budget& budget_;
+            std::chrono::steady_clock::time_point started_;
+        };
+
+        Budget(const Budget&) = delete;
+        Budget& operator=(const Budget&) = delete;
+        ~Budget();
+
+        /// Таймауты для следующего запроса в БД: execute - остаток
+        /// бюджета (он же ограничивает ожидание соединения из пула),
+        /// statement - остаток, но не больше statement-timeout. Каждый
+        /// вызов считается обращением к БД из места вызова `location`.
+        DbCall Db(
+            std::source_location location =
+                std::source_location::current()) const;
+
+        userver::engine::Deadline Deadline() const;
+
+        RequestTraces::Trace& GetTrace() const { return trace_; }
+
+      private:
+        friend class RequestBudgets;
+
+        /// Больше мест обращений на запрос не запоминаем - остальные
+        /// только считаются.
+        static constexpr std::size_t kMaxDbCallSites = 8;
+
+        struct DbCallSite {
+            std::source_location location;
+            std::uint32_t calls{0};
+        };
+
+        Budget(HandlerState& state,
+               std::chrono::steady_clock::time_point deadline,
+               std::chrono::milliseconds statement_timeout,
+               RequestTraces& traces, AdmissionControl& admission,
+               std::string_view handler_name,
+               const userver::server::http::HttpRequest& request);
+
+        void CheckRegressions() const;
+        std::string DescribeDbCalls() const;
+
+        HandlerState& state_;
+        AdmissionControl& admission_;
+        std::string_view handler_name_;
+        std::chrono::steady_clock::time_point started_;
+        std::chrono::steady_clock::time_point deadline_;
+        std::chrono::milliseconds statement_timeout_;
+        int uncaught_exceptions_;
+        mutable std::uint32_t db_round_trips_{0};
+        mutable std::array<DbCallSite, kMaxDbCallSites> db_call_sites_{};
+        mutable std::size_t db_call_site_count_{0};
+        mutable RequestTraces::Trace trace_;
+    };
+
+    RequestBudgets(const userver::components::ComponentConfig& config,
+                   const userver::components::ComponentContext& context);
+    ~RequestBudgets() override;
+
+    static userver::yaml_config::Schema GetStaticConfigSchema();
+
+    Budget Start(std::string_view handler_name,
+                 const userver::server::http::HttpRequest& request);
+
+  private:
+    HandlerState& StateFor(std::string_view handler_name);
+
+    RequestTraces& traces_;
+    AdmissionControl& admission_;
+    std::string client_timeout_header_;
+    std::chrono::milliseconds statement_timeout_;
+    std::map<std::string, HandlerState, std::less<>> handlers_;
+    HandlerState default_state_;
+    userver::utils::statistics::Entry statistics_holder_;
+};
+
+}  // namespace masterclasses::components
+
+template <>
+inline constexpr bool userver::components::kHasValidate<
+    masterclasses::components::RequestBudgets> = true;
@@ -0,0 +1,226 @@
+#include "components/request_traces.hpp"
+
+#include <algorithm>
+#include <array>
+#include <exception>
+
+#include <userver/components/statistics_storage.hpp>
+#include <userver/engine/task/local_variable.hpp>
+#include <userver/utils/rand.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace masterclasses::components {
+
+namespace {
+
+constexpr std::size_t kDefaultCapacity = 1024;
+constexpr double kDefaultSampleRate = 0.01;
+constexpr std::chrono::milliseconds kDefaultSlowThreshold{250};
+constexpr std::uint32_t kPpm = 1000000;
+
+/// Значения, по которым можно узнать пользователя, в трассу не пишем.
+constexpr std::array<std::string_view, 5> kMaskedArgs{
+    "password", "phone", "seen_token", "token", "user_id"};
+constexpr std::size_t kMaxArgValue = 32;
+
+userver::engine::TaskLocalVariable<RequestTraces::Trace*> current_trace;
+
+/// Аргументы запроса по имени: name=value&..., значения обрезаны, личные -
+/// звёздочкой. Одинаковые запросы дают одинаковую строку.
+std::string NormalizeArgs(const userver::server::http::HttpRequest& request) {
+    auto names = request.ArgNames();
+    std::sort(names.begin(), names.end());
+
+    std::string normalized;
+    for (const auto& name : names) {
+        if (!normalized.empty()) {
+            normalized += '&';
+        }
+        normalized += name;
+        normalized += '=';
+        if (std::find(kMaskedArgs.begin(), kMaskedArgs.end(), name) !=
+            kMaskedArgs.end()) {
+            normalized += '*';
+            continue;
+        }
+        const auto& value = request.GetArg(name);
+        if (value.size() <= kMaxArgValue) {
+            normalized += value;
+            continue;
+        }
+        // Не режем UTF-8 посреди символа.
+        auto size = kMaxArgValue;
+        while (size > 0 &&
+               (static_cast<unsigned char>(value[size]) & 0xC0) == 0x80) {
+            --size;
+        }
+        normalized.append(value, 0, size);
+        normalized += "...";
+    }
+    return normalized;
+}
+
+}  // namespace
+
+RequestTraces::Trace::Trace(RequestTraces& owner,
+                            std::string_view handler_name,
+                            const userver::server::http::HttpRequest& request)
+    : owner_(owner),
+      handler_name_(handler_name),
+      request_(request),
+      previous_(*current_trace),
+      uncaught_exceptions_(std::uncaught_exceptions()),
+      started_at_(std::chrono::system_clock::now()),
+      started_(std::chrono::steady_clock::now()),
+      last_mark_(started_) {
+    *current_trace = this;
+}
+
+RequestTraces::Trace::~Trace() {
+    *current_trace = previous_;
+    try {
+        owner_.Finish(*this);
+    } catch (const std::exception&) {
+        // Трасса не должна ронять запрос.
+    }
+}
+
+RequestTraces::Trace* RequestTraces::Trace::Current() {
+    return *current_trace;
+}
+
+void RequestTraces::Trace::Mark(std::string_view stage) {
+    const auto now = std::chrono::steady_clock::now();
+    const auto micros = static_cast<std::uint32_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(now - last_mark_)
+            .count());
+    last_mark_ = now;
+
+    for (std::uint8_t i = 0; i < stage_count_; ++i) {
+        if (utils::TraceSample::Text(stages_[i].name) == stage) {
+            stages_[i].micros += micros;
+            return;
+        }
+    }
+    if (stage_count_ == stages_.size()) {
+        // Стадий больше, чем влезает в образец: время - в последнюю.
+        stages_.back().micros += micros;
+        return;
+    }
+    auto& added = stages_[stage_count_++];
+    utils::TraceSample::SetText(added.name, stage);
+    added.micros = micros;
+}
+
+void RequestTraces::Trace::NoteReplicaRead(bool hedged) {
+    ++replica_reads_;
+    hedged_ = hedged_ || hedged;
+}
+
+std::string RequestTraces::Trace::Respond(std::string body) {
+    response_bytes_ = body.size();
+    return body;
+}
+
+RequestTraces::RequestTraces(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : ComponentBase(config, context),
+      sample_ppm_(static_cast<std::uint32_t>(
+          std::clamp(config["sample-rate"].As<double>(kDefaultSampleRate), 0.0,
+                     1.0) *
+          kPpm)),
+      slow_threshold_(config["slow-threshold"].As<std::chrono::milliseconds>(
+          kDefaultSlowThreshold)),
+      ring_(config["capacity"].As<std::size_t>(kDefaultCapacity)) {
+    statistics_holder_ =
+        context.FindComponent<userver::components::StatisticsStorage>()
+            .GetStorage()
+            .RegisterWriter(
+                "masterclasses.traces",
+                [this](userver::utils::statistics::Writer& writer) {
+                    writer["recorded"] = ring_.Pushed();
+                    writer["dropped"] = ring_.Dropped();
+                    writer["slow"] = slow_.load();
+                });
+}
+
+RequestTraces::~RequestTraces() { statistics_holder_.Unregister(); }
+
+std::vector<utils::TraceSample> RequestTraces::Samples() const {
+    return ring_.Snapshot();
+}
+
+void RequestTraces::Finish(Trace& trace) {
+    trace.Mark("handler");
+    const auto total = std::chrono::duration_cast<std::chrono::microseconds>(
+        trace.last_mark_ - trace.started_);
+    const bool slow = total >= slow_threshold_;
+    if (!slow && userver::utils::RandRange(kPpm) >= sample_ppm_) {
+        return;
+    }
+
+    // Дальше - только для записываемых запросов.
+    utils::TraceSample sample;
+    sample.timestamp_ms =
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+            trace.started_at_.time_since_epoch())
+            .count();
+    sample.total_micros = static_cast<std::uint32_t>(total.count());
+    sample.response_bytes = static_cast<std::uint32_t>(trace.response_bytes_);
+    sample.failed = std::uncaught_exceptions() > trace.uncaught_exceptions_;
+    // Статус ответа по исключению выставит фреймворк уже после нас.
+    sample.status =
+        sample.failed ? 0
+                      : static_cast<std::uint16_t>(
+                            trace.request_.GetHttpResponse().GetStatus());
+    sample.db_round_trips = static_cast<std::uint16_t>(
+        std::min<std::uint32_t>(trace.db_round_trips_, UINT16_MAX));
+    if (trace.db_round_trips_ > trace.replica_reads_) {
+        sample.db_hosts |= utils::TraceSample::kDbMaster;
+    }
+    if (trace.replica_reads_ > 0) {
+        sample.db_hosts |= utils::TraceSample::kDbReplica;
+    }
+    if (trace.hedged_) {
+        sample.db_hosts |= utils::TraceSample::kDbHedge;
+    }
+    sample.slow = slow;
+    sample.stage_count = trace.stage_count_;
+    sample.stages = trace.stages_;
+    utils::TraceSample::SetText(sample.handler, trace.handler_name_);
+    utils::TraceSample::SetText(sample.args, NormalizeArgs(trace.request_));
+
+    if (slow) {
+        ++slow_;
+    }
+    ring_.Push(sample);
+}
+
+userver::yaml_config::Schema RequestTraces::GetStaticConfigSchema() {
+    return userver::yaml_config::MergeSchemas<
+        userver::components::ComponentBase>(R"(
+type: object
+description: выборочные трассы запросов в кольце в памяти
+additionalProperties: false
+properties:
+    capacity:
+        type: integer
+        description: сколько последних образцов держит кольцо
+        defaultDescription: 1024
+        minimum: 1
+    sample-rate:
+        type: number
+        description: доля запросов, попадающих в кольцо
+        defaultDescription: 0.01
+        minimum: 0
+        maximum: 1
+    slow-threshold:
+        type: string
+        description: запросы не быстрее этого попадают в кольцо всегда
+        defaultDescription: 250ms
+)");
+}
+
+}  // namespace masterclasses::components
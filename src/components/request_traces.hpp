@@ -0,0 +1,108 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <userver/components/component_base.hpp>
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/server/http/http_request.hpp>
+#include <userver/utils/statistics/entry.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+#include "utils/trace_ring.hpp"
+
+namespace masterclasses::components {
+
+/// Трассы отдельных запросов без журнала запросов. Каждый запрос с
+/// бюджетом (RequestBudgets) ведёт Trace: время по стадиям, число
+/// обращений к БД, какие хосты отвечали, размер ответа. В кольцо
+/// (utils::TraceRing, capacity образцов) попадает доля sample-rate
+/// запросов и каждый запрос дольше slow-threshold; остальные трассы
+/// ничего не стоят, кроме пары замеров времени. Кольцо отдаёт
+/// RequestTracesHandler на порту мониторинга.
+class RequestTraces final : public userver::components::ComponentBase {
+  public:
+    static constexpr std::string_view kName = "request-traces";
+
+    /// Трасса одного запроса; решение, писать ли образец, - в деструкторе.
+    /// Пока трасса жива, она доступна коду запроса через Current(), так
+    /// что стадии отмечают и компоненты, которым хэндлер её не передаёт.
+    class Trace {
+      public:
+        Trace(RequestTraces& owner, std::string_view handler_name,
+              const userver::server::http::HttpRequest& request);
+        Trace(const Trace&) = delete;
+        Trace& operator=(const Trace&) = delete;
+        ~Trace();
+
+        /// Трасса запроса текущей задачи или nullptr.
+        static Trace* Current();
+
+        /// Время с предыдущей отметки относится к стадии `stage`;
+        /// одноимённые стадии складываются. Остаток до конца запроса
+        /// уходит в стадию handler.
+        void Mark(std::string_view stage);
+
+        void NoteDbRoundTrip() { ++db_round_trips_; }
+        void NoteReplicaRead(bool hedged);
+
+        /// Запоминает размер тела ответа и возвращает тело.
+        std::string Respond(std::string body);
+
+      private:
+        friend class RequestTraces;
+
+        RequestTraces& owner_;
+        std::string_view handler_name_;
+        const userver::server::http::HttpRequest& request_;
+        Trace* previous_;
+        int uncaught_exceptions_;
+        std::chrono::system_clock::time_point started_at_;
+        std::chrono::steady_clock::time_point started_;
+        std::chrono::steady_clock::time_point last_mark_;
+        std::uint32_t db_round_trips_{0};
+        std::uint32_t replica_reads_{0};
+        bool hedged_{false};
+        std::size_t response_bytes_{0};
+        std::uint8_t stage_count_{0};
+        std::array<utils::TraceSample::Stage, utils::TraceSample::kMaxStages>
+            stages_{};
+    };
+
+    RequestTraces(const userver::components::ComponentConfig& config,
+                  const userver::components::ComponentContext& context);
+    ~RequestTraces() override;
+
+    static userver::yaml_config::Schema GetStaticConfigSchema();
+
+    /// Образцы из кольца, от новых к старым.
+    std::vector<utils::TraceSample> Samples() const;
+
+    std::size_t Capacity() const { return ring_.Capacity(); }
+    std::uint64_t Recorded() const { return ring_.Pushed(); }
+    std::uint64_t Dropped() const { return ring_.Dropped(); }
+
+  private:
+    void Finish(Trace& trace);
+
+    std::uint32_t sample_ppm_;
+    std::chrono::microseconds slow_threshold_;
+    utils::TraceRing ring_;
+
+    std::atomic<std::uint64_t> slow_{0};
+
+    userver::utils::statistics::Entry statistics_holder_;
+};
+
+}  // namespace masterclasses::components
+
+template <>
+inline constexpr bool userver::components::kHasValidate<
+    masterclasses::components::RequestTraces> = true;
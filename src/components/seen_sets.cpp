@@ -0,0 +1,146 @@
+#include "components/seen_sets.hpp"
+
+#include <algorithm>
+#include <functional>
+
+#include <userver/utils/uuid4.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace masterclasses::components {
+
+namespace {
+
+constexpr std::chrono::minutes kDefaultTtl{30};
+constexpr std::size_t kDefaultMaxIdsPerSet = 100000;
+constexpr std::size_t kDefaultMaxSets = 100000;
+constexpr std::size_t kTokenLength = 32;
+
+}  // namespace
+
+SeenSets::Handle::Handle(std::shared_ptr<Entry> entry, std::size_t max_ids)
+    : entry_(std::move(entry)), lock_(entry_->mutex) {
+    // Очистка на месте, а не новый Entry: запрос, который держал старый,
+    // дописал бы показанное в множество, которого уже нет в шарде.
+    if (entry_->ids.Size() >= max_ids) {
+        entry_->ids = utils::IdSet{};
+    }
+}
+
+void SeenSets::Handle::Add(std::span<const std::int64_t> ids) {
+    for (const auto id : ids) {
+        entry_->ids.Add(id);
+    }
+}
+
+SeenSets::SeenSets(const userver::components::ComponentConfig& config,
+                   const userver::components::ComponentContext& context)
+    : ComponentBase(config, context),
+      ttl_(config["ttl"].As<std::chrono::milliseconds>(kDefaultTtl)),
+      max_ids_per_set_(config["max-ids-per-set"].As<std::size_t>(
+          kDefaultMaxIdsPerSet)),
+      max_sets_per_shard_(std::max<std::size_t>(
+          config["max-sets"].As<std::size_t>(kDefaultMaxSets) / kShards, 1)) {
+    eviction_task_.Start("seen-sets-eviction",
+                         userver::utils::PeriodicTask::Settings{ttl_ / 4},
+                         [this] { EvictExpired(); });
+}
+
+SeenSets::~SeenSets() { eviction_task_.Stop(); }
+
+std::string SeenSets::GenerateToken() {
+    return userver::utils::generators::GenerateUuid();
+}
+
+bool SeenSets::IsValidToken(std::string_view token) {
+    return token.size() == kTokenLength &&
+           std::all_of(token.begin(), token.end(), [](char c) {
+               return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') ||
+                      (c >= 'A' && c <= 'F');
+           });
+}
+
+SeenSets::Handle SeenSets::Acquire(const std::string& token) {
+    auto& shard = shards_[std::hash<std::string>{}(token) % kShards];
+    std::shared_ptr<Entry> entry;
+    {
+        std::lock_guard lock(shard.mutex);
+        auto it = shard.entries.find(token);
+        if (it == shard.entries.end()) {
+            if (shard.entries.size() >= max_sets_per_shard_ &&
+                !EvictOldest(shard)) {
+                // Все множества шарда сейчас заняты запросами: этот
+                // запрос работает с множеством, которое не сохранится.
+                return Handle{std::make_shared<Entry>(), max_ids_per_set_};
+            }
+            it = shard.entries.emplace(token, nullptr).first;
+        }
+        auto& slot = it->second;
+        if (!slot) {
+            slot = std::make_shared<Entry>();
+        }
+        // Обращение отмечается под мьютексом шарда, как и проверка в
+        // EvictExpired: выданное множество не вытеснится из-под запроса.
+        slot->last_access = std::chrono::steady_clock::now();
+        entry = slot;
+    }
+    return Handle{std::move(entry), max_ids_per_set_};
+}
+
+bool SeenSets::EvictOldest(Shard& shard) {
+    auto oldest = shard.entries.end();
+    for (auto it = shard.entries.begin(); it != shard.entries.end(); ++it) {
+        // use_count > 1 - множество держит Handle запроса.
+        if (it->second.use_count() == 1 &&
+            (oldest == shard.entries.end() ||
+             it->second->last_access < oldest->second->last_access)) {
+            oldest = it;
+        }
+    }
+    if (oldest == shard.entries.end()) {
+        return false;
+    }
+    shard.entries.erase(oldest);
+    return true;
+}
+
+void SeenSets::EvictExpired() {
+    const auto deadline = std::chrono::steady_clock::now() - ttl_;
+    for (auto& shard : shards_) {
+        std::lock_guard lock(shard.mutex);
+        for (auto it = shard.entries.begin(); it != shard.entries.end();) {
+            if (it->second.use_count() == 1 &&
+                it->second->last_access < deadline) {
+                it = shard.entries.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+}
+
+userver::yaml_config::Schema SeenSets::GetStaticConfigSchema() {
+    return userver::yaml_config::MergeSchemas<
+        userver::components::ComponentBase>(R"(
+type: object
+description: seen-set'ы разговоров агента для исключения показанных id
+additionalProperties: false
+properties:
+    ttl:
+        type: string
+        description: время жизни множества с последнего обращения
+        defaultDescription: 30m
+    max-ids-per-set:
+        type: integer
+        description: при переполнении множество начинается заново
+        defaultDescription: 100000
+    max-sets:
+        type: integer
+        description: |
+            сколько множеств держит инстанс; при переполнении вытесняется
+            самое давнее
+        defaultDescription: 100000
+        minimum: 1
+)");
+}
+
+}  // namespace masterclasses::components
@@ -0,0 +1,91 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <userver/components/component_base.hpp>
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/engine/mutex.hpp>
+#include <userver/utils/periodic_task.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+#include "utils/id_set.hpp"
+
+namespace masterclasses::components {
+
+/// Множества уже показанных в разговоре мастер-классов, ключ - seen_token.
+/// Живут в памяти инстанса и вытесняются по TTL с последнего обращения;
+/// множеств не больше max-sets - при переполнении уходит самое давнее.
+class SeenSets final : public userver::components::ComponentBase {
+    struct Entry {
+        userver::engine::Mutex mutex;
+        utils::IdSet ids;
+        std::chrono::steady_clock::time_point last_access;
+    };
+
+  public:
+    static constexpr std::string_view kName = "seen-sets";
+
+    /// Эксклюзивный доступ к одному множеству: запросы одного разговора
+    /// выполняются по очереди, поэтому чтение и дописывание id атомарны.
+    class Handle {
+      public:
+        const utils::IdSet& Ids() const { return entry_->ids; }
+        void Add(std::span<const std::int64_t> ids);
+
+      private:
+        friend class SeenSets;
+        /// Переполненное множество (max_ids и больше) очищается на месте,
+        /// под мьютексом множества.
+        Handle(std::shared_ptr<Entry> entry, std::size_t max_ids);
+
+        std::shared_ptr<Entry> entry_;
+        std::unique_lock<userver::engine::Mutex> lock_;
+    };
+
+    SeenSets(const userver::components::ComponentConfig& config,
+             const userver::components::ComponentContext& context);
+    ~SeenSets() override;
+
+    static userver::yaml_config::Schema GetStaticConfigSchema();
+
+    static std::string GenerateToken();
+
+    /// Токен в формате GenerateToken; остальное хэндлеры отклоняют.
+    static bool IsValidToken(std::string_view token);
+
+    /// Создаёт пустое множество, если токен неизвестен или уже вытеснен.
+    Handle Acquire(const std::string& token);
+
+  private:
+    static constexpr std::size_t kShards = 16;
+
+    struct Shard {
+        userver::engine::Mutex mutex;
+        std::unordered_map<std::string, std::shared_ptr<Entry>> entries;
+    };
+
+    void EvictExpired();
+    /// Освобождает место в полном шарде; вызывается под его мьютексом.
+    static bool EvictOldest(Shard& shard);
+
+    std::chrono::milliseconds ttl_;
+    std::size_t max_ids_per_set_;
+    std::size_t max_sets_per_shard_;
+    std::array<Shard, kShards> shards_;
+    userver::utils::PeriodicTask eviction_task_;
+};
+
+}  // namespace masterclasses::components
+
+template <>
+inline constexpr bool
+    userver::components::kHasValidate<masterclasses::components::SeenSets> =
+        true;
@@ -0,0 +1,339 @@
+#include "components/session_tokens.hpp"
+#include "sql/queries.hpp"
+
+#include <algorithm>
+#include <array>
+#include <charconv>
+#include <stdexcept>
+#include <utility>
+
+#include <userver/components/statistics_storage.hpp>
+#include <userver/crypto/algorithm.hpp>
+#include <userver/crypto/base64.hpp>
+#include <userver/crypto/hash.hpp>
+#include <userver/formats/common/items.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/server/handlers/exceptions.hpp>
+#include <userver/storages/postgres/component.hpp>
+#include <userver/storages/secdist/component.hpp>
+#include <userver/utils/datetime.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace masterclasses::components {
+
+namespace {
+
+using ClusterHostType = userver::storages::postgres::ClusterHostType;
+
+constexpr std::chrono::hours kDefaultTtl{24 * 7};
+constexpr std::chrono::seconds kDefaultRevocationsRefreshPeriod{10};
+constexpr std::string_view kBearerPrefix = "Bearer ";
+
+/// kid, user_id, issued_at, expires_at, подпись.
+constexpr std::size_t kTokenParts = 5;
+
+std::int64_t NowSeconds() {
+    return std::chrono::duration_cast<std::chrono::seconds>(
+               userver::utils::datetime::Now().time_since_epoch())
+        .count();
+}
+
+std::string Sign(std::string_view key, std::string_view payload) {
+    return userver::crypto::base64::Base64UrlEncode(
+        userver::crypto::hash::HmacSha256(
+            key, payload, userver::crypto::hash::OutputEncoding::kBinary),
+        userver::crypto::base64::Pad::kWithout);
+}
+
+bool ParseSeconds(std::string_view raw, std::int64_t& value) {
+    const auto* end = raw.data() + raw.size();
+    const auto [ptr, ec] = std::from_chars(raw.data(), end, value);
+    return ec == std::errc{} && ptr == end;
+}
+
+}  // namespace
+
+SessionKeys::SessionKeys(const userver::formats::json::Value& secdist) {
+    const auto section = secdist["session_keys"];
+    if (section.IsMissing()) {
+        return;
+    }
+    current = section["current"].As<std::string>();
+    for (const auto& [kid, key] :
+         userver::formats::common::Items(section["keys"])) {
+        if (kid.empty() || kid.find('.') != std::string::npos) {
+            throw std::runtime_error("session key id '" + kid +
+                                     "' must be non-empty and without dots");
+        }
+        auto secret = key.As<std::string>();
+        if (secret.empty()) {
+            throw std::runtime_error("session key '" + kid + "' is empty");
+        }
+        keys.emplace(kid, std::move(secret));
+    }
+    if (!keys.contains(current)) {
+        throw std::runtime_error("session_keys.current '" + current +
+                                 "' is not in session_keys.keys");
+    }
+}
+
+SessionTokens::SessionTokens(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : ComponentBase(config, context),
+      ttl_(config["ttl"].As<std::chrono::seconds>(kDefaultTtl)),
+      require_token_(config["require-token"].As<bool>(true)),
+      db_cluster_(context.FindComponent<userver::components::Postgres>("app-db")
+                      .GetCluster()) {
+    secdist_subscriber_ =
+        context.FindComponent<userver::components::Secdist>().UpdateAndListen(
+            this, kName, &SessionTokens::OnSecdistUpdate);
+    // Без ключа /login и /register не выдадут токен, а хэндлеры /user/*
+    // не примут ни одного - лучше не стартовать.
+    if (keys_.Read()->keys.empty()) {
+        throw std::runtime_error(
+            "session-tokens: no signing key, configure session_keys in "
+            "secdist");
+    }
+    if (!require_token_) {
+        LOG_WARNING() << "session-tokens: require-token is off, requests "
+                         "without a token are trusted by user_id";
+    }
+
+    try {
+        RefreshRevocations();
+    } catch (const std::exception& ex) {
+        LOG_WARNING() << "session revocations load failed: " << ex.what();
+    }
+
+    const auto period =
+        config["revocations-refresh-period"].As<std::chrono::milliseconds>(
+            kDefaultRevocationsRefreshPeriod);
+    revocations_task_.Start("session-revocations-refresh",
+                            userver::utils::PeriodicTask::Settings{period},
+                            [this] { RefreshRevocations(); });
+
+    statistics_holder_ =
+        context.FindComponent<userver::components::StatisticsStorage>()
+            .GetStorage()
+            .RegisterWriter(
+                "masterclasses.session-tokens",
+                [this](userver::utils::statistics::Writer& writer) {
+                    writer["issued"] = issued_.load();
+                    writer["verified"] = verified_.load();
+                    writer["legacy"] = legacy_.load();
+                    writer["rejected"] = rejected_.load();
+                    writer["expired"] = expired_.load();
+                    writer["revoked"] = revoked_.load();
+                    writer["revocations"] = revocations_.Read()->size();
+                });
+}
+
+SessionTokens::~SessionTokens() {
+    statistics_holder_.Unregister();
+    revocations_task_.Stop();
+    secdist_subscriber_.Unsubscribe();
+}
+
+SessionTokens::Issued SessionTokens::Issue(std::string_view user_id) const {
+    const auto keys = keys_.Read();
+    const auto key = keys->keys.find(keys->current);
+    if (key == keys->keys.end()) {
+        throw std::runtime_error("session signing key is not configured");
+    }
+
+    const auto issued_at = NowSeconds();
+    const auto expires_at = issued_at + ttl_.count();
+    auto token = keys->current;
+    token.append(".").append(user_id);
+    token.append(".").append(std::to_string(issued_at));
+    token.append(".").append(std::to_string(expires_at));
+    const auto signature = Sign(key->second, token);
+    token.append(".").append(signature);
+
+    ++issued_;
+    return Issued{std::move(token), expires_at};
+}
+
+std::string SessionTokens::Authenticate(
+    const userver::server::http::HttpRequest& request,
+    std::string_view claimed_user_id, RevokedTokens revoked) const {
+    const auto& header = request.GetHeader("Authorization");
+    if (header.empty()) {
+        if (require_token_) {
+            ++rejected_;
+            throw userver::server::handlers::Unauthorized(
+                userver::server::handlers::ExternalBody{
+                    "missing session token"});
+        }
+        ++legacy_;
+        return std::string{claimed_user_id};
+    }
+
+    std::string_view token = header;
+    if (!token.starts_with(kBearerPrefix)) {
+        ++rejected_;
+        throw userver::server::handlers::Unauthorized(
+            userver::server::handlers::ExternalBody{
+                "expected 'Authorization: Bearer <token>'"});
+    }
+    token.remove_prefix(kBearerPrefix.size());
+
+    std::string user_id;
+    switch (Verify(token, user_id)) {
+        case Verdict::kOk:
+            break;
+        case Verdict::kExpired:
+            ++expired_;
+            throw userver::server::handlers::Unauthorized(
+                userver::server::handlers::ExternalBody{
+                    "session token expired"});
+        case Verdict::kRevoked:
+            if (revoked == RevokedTokens::kAccept) {
+                break;
+            }
+            ++revoked_;
+            throw userver::server::handlers::Unauthorized(
+                userver::server::handlers::ExternalBody{
+                    "session token revoked"});
+        case Verdict::kMalformed:
+        case Verdict::kUnknownKey:
+        case Verdict::kBadSignature:
+            ++rejected_;
+            throw userver::server::handlers::Unauthorized(
+                userver::server::handlers::ExternalBody{
+                    "invalid session token"});
+    }
+
+    if (!claimed_user_id.empty() && claimed_user_id != user_id) {
+        ++rejected_;
+        throw userver::server::handlers::Unauthorized(
+            userver::server::handlers::ExternalBody{
+                "session token belongs to another user"});
+    }
+    ++verified_;
+    return user_id;
+}
+
+SessionTokens::Verdict SessionTokens::Verify(std::string_view token,
+                                             std::string& user_id) const {
+    std::array<std::string_view, kTokenParts> parts;
+    std::size_t count = 0;
+    for (std::size_t begin = 0; begin <= token.size();) {
+        const auto dot = std::min(token.find('.', begin), token.size());
+        if (count == kTokenParts) {
+            return Verdict::kMalformed;
+        }
+        parts[count++] = token.substr(begin, dot - begin);
+        begin = dot + 1;
+    }
+    if (count != kTokenParts) {
+        return Verdict::kMalformed;
+    }
+
+    const auto& [kid, subject, issued_raw, expires_raw, signature] = parts;
+    std::int64_t issued_at = 0;
+    std::int64_t expires_at = 0;
+    if (subject.empty() || !ParseSeconds(issued_raw, issued_at) ||
+        !ParseSeconds(expires_raw, expires_at)) {
+        return Verdict::kMalformed;
+    }
+
+    {
+        const auto keys = keys_.Read();
+        const auto key = keys->keys.find(std::string{kid});
+        if (key == keys->keys.end()) {
+            return Verdict::kUnknownKey;
+        }
+        const auto payload =
+            token.substr(0, token.size() - signature.size() - 1);
+        if (!userver::crypto::algorithm::AreStringsEqualConstTime(
+                Sign(key->second, payload), signature)) {
+            return Verdict::kBadSignature;
+        }
+    }
+
+    if (expires_at <= NowSeconds()) {
+        return Verdict::kExpired;
+    }
+
+    user_id.assign(subject);
+    const auto revocations = revocations_.Read();
+    const auto revoked = revocations->find(user_id);
+    if (revoked != revocations->end() && issued_at <= revoked->second) {
+        return Verdict::kRevoked;
+    }
+    return Verdict::kOk;
+}
+
+void SessionTokens::RevokeAll(
+    std::string_view user_id,
+    const userver::storages::postgres::CommandControl& command_control) {
+    const auto now = NowSeconds();
+    db_cluster_->Execute(ClusterHostType::kMaster, command_control,
+                         sql::kUpsertSessionRevocation, user_id, now);
+
+    auto revocations = revocations_.StartWrite();
+    auto& revoked_before = (*revocations)[std::string{user_id}];
+    revoked_before = std::max(revoked_before, now);
+    revocations.Commit();
+}
+
+void SessionTokens::OnSecdistUpdate(
+    const userver::storages::secdist::SecdistConfig& secdist) {
+    auto keys = secdist.Get<SessionKeys>();
+    if (keys.keys.empty() && !keys_.Read()->keys.empty()) {
+        // Обновление secdist без ключей не должно выключить вход.
+        LOG_ERROR() << "session_keys disappeared from secdist, keeping the "
+                       "previous keys";
+        return;
+    }
+    keys_.Assign(std::move(keys));
+}
+
+void SessionTokens::RefreshRevocations() {
+    const auto result = db_cluster_->Execute(
+        ClusterHostType::kSlave, sql::kSelectSessionRevocations,
+        static_cast<double>(ttl_.count()));
+
+    // Локальные отзывы могли ещё не доехать до реплики - сливаем, а не
+    // заменяем; записи старше ttl больше не нужны: такие токены истекли.
+    const auto horizon = NowSeconds() - ttl_.count();
+    auto revocations = revocations_.StartWrite();
+    std::erase_if(*revocations, [horizon](const auto& entry) {
+        return entry.second <= horizon;
+    });
+    for (const auto& row : result) {
+        auto& revoked_before = (*revocations)[row[0].As<std::string>()];
+        revoked_before = std::max(revoked_before, row[1].As<std::int64_t>());
+    }
+    revocations.Commit();
+}
+
+userver::yaml_config::Schema SessionTokens::GetStaticConfigSchema() {
+    return userver::yaml_config::MergeSchemas<
+        userver::components::ComponentBase>(R"(
+type: object
+description: подписанные токены сессии (ключи - session_keys в secdist)
+additionalProperties: false
+properties:
+    ttl:
+        type: string
+        description: время жизни выданного токена
+        defaultDescription: 168h
+    require-token:
+        type: boolean
+        description: |
+            отклонять запросы /user/* и /userdelete без токена; false -
+            только на время перехода клиентов: запросу без заголовка
+            верим по user_id (метрика legacy)
+        defaultDescription: true
+    revocations-refresh-period:
+        type: string
+        description: как часто подтягивать session_revocations из Postgres
+        defaultDescription: 10s
+)");
+}
+
+}  // namespace masterclasses::components
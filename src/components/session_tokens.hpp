@@ -0,0 +1,124 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+#include <userver/components/component_base.hpp>
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/concurrent/async_event_source.hpp>
+#include <userver/formats/json/value.hpp>
+#include <userver/rcu/rcu.hpp>
+#include <userver/server/http/http_request.hpp>
+#include <userver/storages/postgres/cluster.hpp>
+#include <userver/storages/secdist/secdist.hpp>
+#include <userver/utils/periodic_task.hpp>
+#include <userver/utils/statistics/entry.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+namespace masterclasses::components {
+
+/// Ключи подписи из секции session_keys в secdist: `current` - id ключа
+/// для новых токенов, `keys` - все ключи, которыми ещё проверяем.
+struct SessionKeys {
+    SessionKeys() = default;
+    explicit SessionKeys(const userver::formats::json::Value& secdist);
+
+    std::string current;
+    std::unordered_map<std::string, std::string> keys;
+};
+
+/// Подписанные токены сессии. /login и /register выдают токен
+/// `<kid>.<user_id>.<issued_at>.<expires_at>.<подпись>` (HMAC-SHA256,
+/// base64url), хэндлеры /user/* и /userdelete проверяют его в процессе:
+/// разбор, HMAC и поиск в наборе отзывов, без запроса в БД. Ключи
+/// перечитываются при обновлении secdist, отзывы (session_revocations)
+/// подтягиваются фоновой задачей. Без ключа подписи компонент не
+/// стартует.
+class SessionTokens final : public userver::components::ComponentBase {
+  public:
+    static constexpr std::string_view kName = "session-tokens";
+
+    struct Issued {
+        std::string token;
+        std::int64_t expires_at;
+    };
+
+    SessionTokens(const userver::components::ComponentConfig& config,
+                  const userver::components::ComponentContext& context);
+    ~SessionTokens() override;
+
+    static userver::yaml_config::Schema GetStaticConfigSchema();
+
+    /// Принимать ли отозванный токен.
+    enum class RevokedTokens {
+        kReject,
+        /// Только для хода удаления аккаунта: /userdelete отзывает токены
+        /// сразу, а узнать статус задачи владельцу всё равно нужно.
+        kAccept,
+    };
+
+    Issued Issue(std::string_view user_id) const;
+
+    /// user_id из токена в заголовке Authorization (Bearer). Если заголовка
+    /// нет, Unauthorized; только с require-token: false (на время перехода
+    /// клиентов) возвращает `claimed_user_id`. Неверный, истёкший
+    /// или отозванный токен, а также токен другого пользователя -
+    /// Unauthorized.
+    std::string Authenticate(
+        const userver::server::http::HttpRequest& request,
+        std::string_view claimed_user_id,
+        RevokedTokens revoked = RevokedTokens::kReject) const;
+
+    /// Отзывает все выданные пользователю токены: сразу в этом процессе
+    /// и в session_revocations для остальных.
+    void RevokeAll(
+        std::string_view user_id,
+        const userver::storages::postgres::CommandControl& command_control);
+
+  private:
+    /// user_id -> токены, выданные не позже этого момента, отозваны.
+    using Revocations = std::unordered_map<std::string, std::int64_t>;
+
+    enum class Verdict {
+        kOk,
+        kMalformed,
+        kUnknownKey,
+        kBadSignature,
+        kExpired,
+        kRevoked,
+    };
+
+    Verdict Verify(std::string_view token, std::string& user_id) const;
+    void OnSecdistUpdate(
+        const userver::storages::secdist::SecdistConfig& secdist);
+    void RefreshRevocations();
+
+    std::chrono::seconds ttl_;
+    bool require_token_;
+    userver::storages::postgres::ClusterPtr db_cluster_;
+
+    userver::rcu::Variable<SessionKeys> keys_;
+    userver::rcu::Variable<Revocations> revocations_;
+
+    mutable std::atomic<std::uint64_t> issued_{0};
+    mutable std::atomic<std::uint64_t> verified_{0};
+    mutable std::atomic<std::uint64_t> legacy_{0};
+    mutable std::atomic<std::uint64_t> rejected_{0};
+    mutable std::atomic<std::uint64_t> expired_{0};
+    mutable std::atomic<std::uint64_t> revoked_{0};
+
+    userver::concurrent::AsyncEventSubscriberScope secdist_subscriber_;
+    userver::utils::PeriodicTask revocations_task_;
+    userver::utils::statistics::Entry statistics_holder_;
+};
+
+}  // namespace masterclasses::components
+
+template <>
+inline constexpr bool userver::components::kHasValidate<
+    masterclasses::components::SessionTokens> = true;
@@ -0,0 +1,207 @@
+#include "components/user_purge.hpp"
+#include "sql/queries.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include <userver/components/statistics_storage.hpp>
+#include <userver/engine/sleep.hpp>
+#include <userver/engine/task/cancel.hpp>
+#include <userver/formats/serialize/common_containers.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/storages/postgres/component.hpp>
+#include <userver/utils/statistics/writer.hpp>
+#include <userver/yaml_config/merge_schemas.hpp>
+
+namespace masterclasses::components {
+
+namespace {
+
+using ClusterHostType = userver::storages::postgres::ClusterHostType;
+
+constexpr std::chrono::seconds kDefaultPollInterval{1};
+constexpr std::int64_t kDefaultBatchSize = 500;
+constexpr std::chrono::milliseconds kDefaultBatchPause{50};
+constexpr std::chrono::minutes kDefaultLease{1};
+constexpr std::int32_t kDefaultMaxAttempts = 5;
+
+UserPurge::Job ParseJob(const userver::storages::postgres::Row& row) {
+    UserPurge::Job job;
+    job.id = row["id"].As<std::int64_t>();
+    job.status = row["status"].As<std::string>();
+    job.favorites_deleted = row["favorites_deleted"].As<std::int64_t>();
+    job.attempts = row["attempts"].As<std::int32_t>();
+    job.created_at = row["created_at"].As<std::int64_t>();
+    job.finished_at = row["finished_at"].As<std::optional<std::int64_t>>();
+    return job;
+}
+
+}  // namespace
+
+UserPurge::UserPurge(const userver::components::ComponentConfig& config,
+                     const userver::components::ComponentContext& context)
+    : ComponentBase(config, context),
+      db_cluster_(context.FindComponent<userver::components::Postgres>("app-db")
+                      .GetCluster()),
+      counters_(context.FindComponent<FavoriteCounters>()),
+      batch_size_(config["batch-size"].As<std::int64_t>(kDefaultBatchSize)),
+      batch_pause_(config["batch-pause"].As<std::chrono::milliseconds>(
+          kDefaultBatchPause)),
+      lease_(config["lease"].As<std::chrono::milliseconds>(kDefaultLease)),
+      max_attempts_(
+          config["max-attempts"].As<std::int32_t>(kDefaultMaxAttempts)) {
+    const auto period = config["poll-interval"].As<std::chrono::milliseconds>(
+        kDefaultPollInterval);
+    poll_task_.Start("user-purge",
+                     userver::utils::PeriodicTask::Settings{period},
+                     [this] { Drain(); });
+
+    statistics_holder_ =
+        context.FindComponent<userver::components::StatisticsStorage>()
+            .GetStorage()
+            .RegisterWriter(
+                "masterclasses.user-purge",
+                [this](userver::utils::statistics::Writer& writer) {
+                    writer["jobs-done"] = jobs_done_.load();
+                    writer["attempts-failed"] = attempts_failed_.load();
+                    writer["favorites-deleted"] = favorites_deleted_.load();
+                    writer["batches"] = batches_.load();
+                });
+}
+
+UserPurge::~UserPurge() {
+    statistics_holder_.Unregister();
+    poll_task_.Stop();
+}
+
+std::optional<UserPurge::Job> UserPurge::Enqueue(
+    std::string_view user_id,
+    const userver::storages::postgres::CommandControl& command_control) {
+    // Два параллельных запроса на одного пользователя: проигравший вставку
+    // получит пустой ответ из-за уникального индекса, повтор увидит
+    // задачу победителя.
+    for (int attempt = 0; attempt < 2; ++attempt) {
+        const auto result = db_cluster_->Execute(
+            ClusterHostType::kMaster, command_control, sql::kEnqueueUserPurge,
+            std::string{user_id});
+        if (!result.IsEmpty()) {
+            Job job;
+            job.id = result[0]["id"].As<std::int64_t>();
+            job.status = result[0]["status"].As<std::string>();
+            return job;
+        }
+    }
+    return std::nullopt;
+}
+
+std::optional<UserPurge::Job> UserPurge::Find(
+    std::int64_t job_id, std::string_view user_id,
+    const userver::storages::postgres::CommandControl& command_control) {
+    const auto result =
+        db_cluster_->Execute(ClusterHostType::kMaster, command_control,
+                             sql::kSelectUserPurgeJob, job_id, user_id);
+    if (result.IsEmpty()) {
+        return std::nullopt;
+    }
+    return ParseJob(result[0]);
+}
+
+void UserPurge::Drain() {
+    const double lease_seconds =
+        std::chrono::duration<double>(lease_).count();
+    while (!userver::engine::current_task::ShouldCancel()) {
+        const auto claimed = db_cluster_->Execute(
+            ClusterHostType::kMaster, sql::kClaimUserPurgeJob, lease_seconds);
+        if (claimed.IsEmpty()) {
+            return;
+        }
+        const auto job_id = claimed[0]["id"].As<std::int64_t>();
+        const auto user_id = claimed[0]["user_id"].As<std::string>();
+        try {
+            Purge(job_id, user_id);
+            ++jobs_done_;
+        } catch (const std::exception& ex) {
+            if (userver::engine::current_task::ShouldCancel()) {
+                // Остановка сервиса: задачу заберут снова по lease, попытку
+                // не засчитываем.
+                return;
+            }
+            LOG_WARNING() << "user purge job " << job_id
+                          << " failed: " << ex.what();
+            ++attempts_failed_;
+            db_cluster_->Execute(ClusterHostType::kMaster,
+                                 sql::kFailUserPurgeJob, job_id,
+                                 std::string{ex.what()}, max_attempts_);
+            // Не крутим ту же задачу в цикле: следующая попытка - на
+            // следующем тике.
+            return;
+        }
+    }
+}
+
+void UserPurge::Purge(std::int64_t job_id, const std::string& user_id) {
+    // Каждый пакет - свой короткий запрос: блокировки строк держатся
+    // только на время пакета, а пауза между пакетами не даёт одному
+    // тяжёлому аккаунту занять базу.
+    while (true) {
+        const auto removed = db_cluster_->Execute(
+            ClusterHostType::kMaster, sql::kDeleteUserFavoritesBatch, user_id,
+            batch_size_);
+        ++batches_;
+        for (const auto& row : removed) {
+            counters_.Add(row[0].As<std::int64_t>(), -1);
+        }
+        const auto count = static_cast<std::int64_t>(removed.Size());
+        favorites_deleted_ += removed.Size();
+        // Заодно продлевает lease задачи.
+        db_cluster_->Execute(ClusterHostType::kMaster,
+                             sql::kUpdateUserPurgeProgress, job_id, count);
+        if (count < batch_size_) {
+            break;
+        }
+        userver::engine::InterruptibleSleepFor(batch_pause_);
+        if (userver::engine::current_task::ShouldCancel()) {
+            throw std::runtime_error("user purge interrupted");
+        }
+    }
+    // Избранное, добавленное за время пакетов, уйдёт каскадом вместе с
+    // users - его немного.
+    db_cluster_->Execute(ClusterHostType::kMaster, sql::kFinishUserPurgeJob,
+                         job_id, user_id);
+}
+
+userver::yaml_config::Schema UserPurge::GetStaticConfigSchema() {
+    return userver::yaml_config::MergeSchemas<
+        userver::components::ComponentBase>(R"(
+type: object
+description: фоновое удаление аккаунтов из очереди user_purge_jobs
+additionalProperties: false
+properties:
+    poll-interval:
+        type: string
+        description: как часто проверять очередь
+        defaultDescription: 1s
+    batch-size:
+        type: integer
+        description: сколько строк избранного удалять одним запросом
+        defaultDescription: 500
+        minimum: 1
+    batch-pause:
+        type: string
+        description: пауза между пакетами одной задачи
+        defaultDescription: 50ms
+    lease:
+        type: string
+        description: |
+            через сколько без прогресса задача в running считается
+            брошенной и забирается снова
+        defaultDescription: 1m
+    max-attempts:
+        type: integer
+        description: после стольких неудачных попыток задача - failed
+        defaultDescription: 5
+        minimum: 1
+)");
+}
+
+}  // namespace masterclasses::components
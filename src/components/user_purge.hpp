@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <userver/components/component_base.hpp>
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/storages/postgres/cluster.hpp>
+#include <userver/utils/periodic_task.hpp>
+#include <userver/utils/statistics/entry.hpp>
+#include <userver/yaml_config/schema.hpp>
+
+#include "components/favorite_counters.hpp"
+
+namespace masterclasses::components {
+
+/// Удаление аккаунтов в фоне. /userdelete только ставит задачу в
+/// user_purge_jobs; воркер забирает задачи (FOR UPDATE SKIP LOCKED, так
+/// что инстансов может быть несколько), удаляет избранное пакетами по
+/// batch-size с паузой batch-pause между ними, каждый пакет - отдельным
+/// коротким запросом, и последней удаляет строку users. Удалённое
+/// избранное списывается со счётчиков FavoriteCounters. Задача, чей
+/// воркер пропал, через lease снова становится доступной; после
+/// max-attempts неудач - failed.
+class UserPurge final : public userver::components::ComponentBase {
+  public:
+    static constexpr std::string_view kName = "user-purge";
+
+    struct Job {
+        std::int64_t id{0};
+        std::string status;
+        std::int64_t favorites_deleted{0};
+        std::int32_t attempts{0};
+        std::int64_t created_at{0};
+        std::optional<std::int64_t> finished_at;
+    };
+
+    UserPurge(const userver::components::ComponentConfig& config,
+              const userver::components::ComponentContext& context);
+    ~UserPurge() override;
+
+    static userver::yaml_config::Schema GetStaticConfigSchema();
+
+    /// Ставит удаление пользователя в очередь или возвращает уже стоящую
+    /// задачу; nullopt, если такого пользователя нет.
+    std::optional<Job> Enqueue(
+        std::string_view user_id,
+        const userver::storages::postgres::CommandControl& command_control);
+
+    /// Задача `job_id` пользователя `user_id`; чужая задача неотличима от
+    /// несуществующей.
+    std::optional<Job> Find(
+        std::int64_t job_id, std::string_view user_id,
+        const userver::storages::postgres::CommandControl& command_control);
+
+  private:
+    /// Обрабатывает задачи, пока очередь не опустеет.
+    void Drain();
+    void Purge(std::int64_t job_id, const std::string& user_id);
+
+    userver::storages::postgres::ClusterPtr db_cluster_;
+    FavoriteCounters& counters_;
+    std::int64_t batch_size_;
+    std::chrono::milliseconds batch_pause_;
+    std::chrono::milliseconds lease_;
+    std::int32_t max_attempts_;
+
+    std::atomic<std::uint64_t> jobs_done_{0};
+    std::atomic<std::uint64_t> attempts_failed_{0};
+    std::atomic<std::uint64_t> favorites_deleted_{0};
+    std::atomic<std::uint64_t> batches_{0};
+
+    userver::utils::PeriodicTask poll_task_;
+    userver::utils::statistics::Entry statistics_holder_;
+};
+
+}  // namespace masterclasses::components
+
+template <>
+inline constexpr bool userver::components::kHasValidate<
+    masterclasses::components::UserPurge> = true;
@@ -3,8 +3,9 @@
 #include "utils/phone.hpp"
 
 #include <optional>
+#include <string>
 
-#include <userver/crypto/hash.hpp>
+#include <userver/logging/log.hpp>
 #include <userver/formats/json/serialize.hpp>
 #include <userver/formats/json/value.hpp>
 #include <userver/formats/json/value_builder.hpp>
@@ -25,7 +26,12 @@ AuthLoginHandler::AuthLoginHandler(
     const userver::components::ComponentContext& context)
     : HttpHandlerBase(config, context),
       db_cluster_(context.FindComponent<userver::components::Postgres>("app-db")
-                      .GetCluster()) {}
+                      .GetCluster()),
+      admission_(context.FindComponent<components::AdmissionControl>()),
+      budgets_(context.FindComponent<components::RequestBudgets>()),
+      hedged_reads_(context.FindComponent<components::HedgedReads>()),
+      sessions_(context.FindComponent<components::SessionTokens>()),
+      hasher_(context.FindComponent<components::PasswordHasher>()) {}
 
 std::string AuthLoginHandler::HandleRequestThrow(
     const userver::server::http::HttpRequest& request,
@@ -33,6 +39,12 @@ std::string AuthLoginHandler::HandleRequestThrow(
     request.GetHttpResponse().SetContentType(
         userver::http::content_type::kApplicationJson);
 
+    const auto budget = budgets_.Start(kName, request);
+    const auto ticket = admission_.Admit(kName);
+    if (!ticket.Admitted()) {
+        return admission_.RenderRejection(request, ticket);
+    }
+
     if (request.GetMethod() != userver::server::http::HttpMethod::kPost) {
         throw userver::server::handlers::ClientError(
             userver::server::handlers::ExternalBody{
@@ -64,8 +76,8 @@ std::string AuthLoginHandler::HandleRequestThrow(
             userver::server::handlers::ExternalBody{"invalid phone"});
     }
 
-    auto result = db_cluster_->Execute(ClusterHostType::kSlave,
-                                       sql::kSelectUserByPhone, *phone_digits);
+    auto result = hedged_reads_.Execute(budget.Db(), sql::kSelectUserByPhone,
+                                        *phone_digits);
 
     if (result.IsEmpty()) {
         request.SetResponseStatus(
@@ -75,11 +87,18 @@ std::string AuthLoginHandler::HandleRequestThrow(
                                                "User not found"));
     }
 
-    auto row = result[0];
-    auto stored_hash = row["password_hash"].As<std::string>();
-    auto input_hash = userver::crypto::hash::Sha256(password);
+    const auto row = result[0];
+    const auto user_id = row["id"].As<std::string>();
+    const auto stored_hash = row["password_hash"].As<std::string>();
+
+    components::PasswordHasher::Match match{};
+    try {
+        match = hasher_.Verify(password, stored_hash);
+    } catch (const components::PasswordHasher::QueueFull&) {
+        return hasher_.RenderQueueFull(request);
+    }
 
-    if (input_hash != stored_hash) {
+    if (match == components::PasswordHasher::Match::kNo) {
         request.SetResponseStatus(
             userver::server::http::HttpStatus::kUnauthorized);
         return userver::formats::json::ToString(
@@ -87,14 +106,41 @@ std::string AuthLoginHandler::HandleRequestThrow(
                                                "Invalid password"));
     }
 
+    if (match == components::PasswordHasher::Match::kYesNeedsRehash) {
+        // Вход уже удался: не вышло перехешировать - попробуем в следующий
+        // раз. Условие на старый хеш не даёт затереть смену пароля. Хеш -
+        // до Db(): иначе время scrypt засчиталось бы обращению к БД и
+        // съело бы его таймаут.
+        std::optional<std::string> new_hash;
+        try {
+            new_hash = hasher_.Hash(password);
+        } catch (const components::PasswordHasher::QueueFull&) {
+            LOG_INFO() << "password rehash postponed: hasher queue is full";
+        }
+        if (new_hash.has_value()) {
+            try {
+                db_cluster_->Execute(ClusterHostType::kMaster, budget.Db(),
+                                     sql::kUpdateUserPasswordHash, user_id,
+                                     *new_hash, stored_hash);
+            } catch (const std::exception& ex) {
+                LOG_WARNING() << "password rehash failed: " << ex.what();
+            }
+        }
+    }
+
+    const auto session = sessions_.Issue(user_id);
+
     userver::formats::json::ValueBuilder response;
     response["status"] = "success";
-    response["user_id"] = row["id"].As<std::string>();
+    response["user_id"] = user_id;
+    response["token"] = session.token;
+    response["expires_at"] = session.expires_at;
     response["full_name"] = row["full_name"].As<std::string>();
     response["telegram_nick"] =
         row["telegram_nick"].As<std::optional<std::string>>().value_or("");
 
-    return userver::formats::json::ToString(response.ExtractValue());
+    return budget.GetTrace().Respond(
+        userver::formats::json::ToString(response.ExtractValue()));
 }
 
 }  // namespace masterclasses::handlers
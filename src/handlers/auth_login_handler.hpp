@@ -7,6 +7,12 @@
 #include <userver/server/handlers/http_handler_base.hpp>
 #include <userver/storages/postgres/cluster.hpp>
 
+#include "components/admission_control.hpp"
+#include "components/hedged_reads.hpp"
+#include "components/password_hasher.hpp"
+#include "components/request_budgets.hpp"
+#include "components/session_tokens.hpp"
+
 namespace masterclasses::handlers {
 
 class AuthLoginHandler final
@@ -23,6 +29,11 @@ class AuthLoginHandler final
 
   private:
     userver::storages::postgres::ClusterPtr db_cluster_;
+    components::AdmissionControl& admission_;
+    components::RequestBudgets& budgets_;
+    components::HedgedReads& hedged_reads_;
+    const components::SessionTokens& sessions_;
+    components::PasswordHasher& hasher_;
 };
 
 }  // namespace masterclasses::handlers
@@ -2,7 +2,6 @@
 #include "sql/queries.hpp"
 #include "utils/phone.hpp"
 
-#include <userver/crypto/hash.hpp>
 #include <userver/formats/json/serialize.hpp>
 #include <userver/formats/json/value.hpp>
 #include <userver/formats/json/value_builder.hpp>
@@ -34,7 +33,11 @@ AuthRegisterHandler::AuthRegisterHandler(
     const userver::components::ComponentContext& context)
     : HttpHandlerBase(config, context),
       db_cluster_(context.FindComponent<userver::components::Postgres>("app-db")
-                      .GetCluster()) {}
+                      .GetCluster()),
+      admission_(context.FindComponent<components::AdmissionControl>()),
+      budgets_(context.FindComponent<components::RequestBudgets>()),
+      sessions_(context.FindComponent<components::SessionTokens>()),
+      hasher_(context.FindComponent<components::PasswordHasher>()) {}
 
 std::string AuthRegisterHandler::HandleRequestThrow(
     const userver::server::http::HttpRequest& request,
@@ -42,6 +45,12 @@ std::string AuthRegisterHandler::HandleRequestThrow(
     request.GetHttpResponse().SetContentType(
         userver::http::content_type::kApplicationJson);
 
+    const auto budget = budgets_.Start(kName, request);
+    const auto ticket = admission_.Admit(kName);
+    if (!ticket.Admitted()) {
+        return admission_.RenderRejection(request, ticket);
+    }
+
     if (request.GetMethod() != userver::server::http::HttpMethod::kPost) {
         throw userver::server::handlers::ClientError(
             userver::server::handlers::ExternalBody{
@@ -81,8 +90,9 @@ std::string AuthRegisterHandler::HandleRequestThrow(
             userver::server::handlers::ExternalBody{"invalid phone"});
     }
 
-    const auto existing = db_cluster_->Execute(
-        ClusterHostType::kSlave, sql::kExistsUserByPhoneDigits, *phone_digits);
+    const auto existing =
+        db_cluster_->Execute(ClusterHostType::kSlave, budget.Db(),
+                             sql::kExistsUserByPhoneDigits, *phone_digits);
     if (!existing.IsEmpty()) {
         userver::formats::json::ValueBuilder response;
         request.SetResponseStatus(userver::server::http::HttpStatus::kConflict);
@@ -91,12 +101,17 @@ std::string AuthRegisterHandler::HandleRequestThrow(
         return userver::formats::json::ToString(response.ExtractValue());
     }
 
+    std::string password_hash;
+    try {
+        password_hash = hasher_.Hash(password);
+    } catch (const components::PasswordHasher::QueueFull&) {
+        return hasher_.RenderQueueFull(request);
+    }
     auto id = userver::utils::generators::GenerateUuid();
-    auto password_hash = userver::crypto::hash::Sha256(password);
 
     const auto result = db_cluster_->Execute(
-        ClusterHostType::kMaster, sql::kInsertUser, id, *phone_canonical,
-        full_name, telegram_nick, password_hash);
+        ClusterHostType::kMaster, budget.Db(), sql::kInsertUser, id,
+        *phone_canonical, full_name, telegram_nick, password_hash);
 
     userver::formats::json::ValueBuilder response;
     if (result.RowsAffected() == 0) {
@@ -106,10 +121,14 @@ std::string AuthRegisterHandler::HandleRequestThrow(
     } else {
         request.SetResponseStatus(userver::server::http::HttpStatus::kCreated);
         response["status"] = "success";
+        const auto session = sessions_.Issue(id);
         response["user_id"] = id;
+        response["token"] = session.token;
+        response["expires_at"] = session.expires_at;
     }
 
-    return userver::formats::json::ToString(response.ExtractValue());
+    return budget.GetTrace().Respond(
+        userver::formats::json::ToString(response.ExtractValue()));
 }
 
 }  // namespace masterclasses::handlers
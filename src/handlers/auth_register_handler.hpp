@@ -9,6 +9,11 @@
 #include <userver/server/request/request_context.hpp>
 #include <userver/storages/postgres/cluster.hpp>
 
+#include "components/admission_control.hpp"
+#include "components/password_hasher.hpp"
+#include "components/request_budgets.hpp"
+#include "components/session_tokens.hpp"
+
 namespace masterclasses::handlers {
 
 class AuthRegisterHandler final
@@ -25,6 +30,10 @@ class AuthRegisterHandler final
 
   private:
     userver::storages::postgres::ClusterPtr db_cluster_;
+    components::AdmissionControl& admission_;
+    components::RequestBudgets& budgets_;
+    const components::SessionTokens& sessions_;
+    components::PasswordHasher& hasher_;
 };
 
 }  // namespace masterclasses::handlers
@@ -1,11 +1,15 @@
 #include "handlers/mc_add_handler.hpp"
+#include "models/masterclass.hpp"
 #include "sql/queries.hpp"
 
+#include <cmath>
 #include <cstdint>
+#include <optional>
 #include <stdexcept>
 #include <string>
 
 #include <userver/formats/json/serialize.hpp>
+#include <userver/formats/serialize/common_containers.hpp>
 #include <userver/formats/json/value.hpp>
 #include <userver/formats/json/value_builder.hpp>
 #include <userver/server/handlers/exceptions.hpp>
@@ -54,13 +58,30 @@ std::string ExtractRequiredString(const userver::formats::json::Value& json,
     }
 }
 
+std::optional<double> ExtractCoordinate(
+    const userver::formats::json::Value& json, std::string_view field,
+    double limit) {
+    const auto value =
+        Extract<std::optional<double>>(json, field, std::nullopt);
+    if (value && (!std::isfinite(*value) || std::abs(*value) > limit)) {
+        throw userver::server::handlers::ClientError(
+            userver::server::handlers::ExternalBody{
+                "invalid field '" + std::string{field} + "': out of range"});
+    }
+    return value;
+}
+
 }  // namespace
 
 McAddHandler::McAddHandler(const userver::components::ComponentConfig& config,
                            const userver::components::ComponentContext& context)
     : HttpHandlerBase(config, context),
       db_cluster_(context.FindComponent<userver::components::Postgres>("app-db")
-                      .GetCluster()) {}
+                      .GetCluster()),
+      catalog_(context.FindComponent<components::MasterclassCatalog>()),
+      admission_(context.FindComponent<components::AdmissionControl>()),
+      budgets_(context.FindComponent<components::RequestBudgets>()),
+      gazetteer_(context.FindComponent<components::Gazetteer>()) {}
 
 std::string McAddHandler::HandleRequestThrow(
     const userver::server::http::HttpRequest& request,
@@ -68,6 +89,12 @@ std::string McAddHandler::HandleRequestThrow(
     request.GetHttpResponse().SetContentType(
         userver::http::content_type::kApplicationJson);
 
+    const auto budget = budgets_.Start(kName, request);
+    const auto ticket = admission_.Admit(kName);
+    if (!ticket.Admitted()) {
+        return admission_.RenderRejection(request, ticket);
+    }
+
     if (request.GetMethod() != userver::server::http::HttpMethod::kPost) {
         throw userver::server::handlers::ClientError(
             userver::server::handlers::ExternalBody{
@@ -117,25 +144,46 @@ std::string McAddHandler::HandleRequestThrow(
     const auto additional_tags =
         Extract<std::string>(payload, "additional_tags", "");
 
-    std::string event_date;
+    // Без даты - NULL: такие строки не уходят в архив и в date_asc
+    // идут после датированных, а не в начало с 1970-01-01.
+    std::optional<std::string> event_date;
     if (payload.HasMember("event_date")) {
         try {
             event_date = payload["event_date"].As<std::string>();
-            if (event_date.empty()) {
-                event_date = "1970-01-01";
+            if (event_date->empty()) {
+                event_date = std::nullopt;
             }
         } catch (...) {
-            event_date = "1970-01-01";
+            event_date = std::nullopt;
+        }
+    }
+
+    // Координаты из запроса; без них - по газеттиру, сначала по адресу,
+    // потом по описанию. Не нашлось - строка без координат.
+    auto latitude = ExtractCoordinate(payload, "latitude", 90.0);
+    auto longitude = ExtractCoordinate(payload, "longitude", 180.0);
+    if (latitude.has_value() != longitude.has_value()) {
+        throw userver::server::handlers::ClientError(
+            userver::server::handlers::ExternalBody{
+                "latitude and longitude must be given together"});
+    }
+    if (!latitude) {
+        auto point = gazetteer_.Locate(location);
+        if (!point) {
+            point = gazetteer_.Locate(description);
+        }
+        if (point) {
+            latitude = point->latitude;
+            longitude = point->longitude;
         }
-    } else {
-        event_date = "1970-01-01";
     }
 
     const auto result = db_cluster_->Execute(
-        ClusterHostType::kMaster, sql::kInsertMasterclass, id, title, location,
-        price, website, image_url, format, company, category, min_age, rating,
-        description, event_date, duration, organizer, contact_tg, contact_vk,
-        contact_phone, audience, additional_tags);
+        ClusterHostType::kMaster, budget.Db(), sql::kInsertMasterclass, id,
+        title, location, price, website, image_url, format, company, category,
+        min_age, rating, description, event_date, duration, organizer,
+        contact_tg, contact_vk, contact_phone, audience, additional_tags,
+        latitude, longitude);
 
     userver::formats::json::ValueBuilder response;
     response["id"] = id;
@@ -143,11 +191,13 @@ std::string McAddHandler::HandleRequestThrow(
         request.SetResponseStatus(userver::server::http::HttpStatus::kConflict);
         response["status"] = "duplicate";
     } else {
+        catalog_.Upsert(models::ParseMasterclassRow(result[0]));
         request.SetResponseStatus(userver::server::http::HttpStatus::kCreated);
         response["status"] = "created";
     }
 
-    return userver::formats::json::ToString(response.ExtractValue());
+    return budget.GetTrace().Respond(
+        userver::formats::json::ToString(response.ExtractValue()));
 }
 
 }  // namespace masterclasses::handlers
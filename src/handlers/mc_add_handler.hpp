@@ -9,6 +9,11 @@
 #include <userver/server/request/request_context.hpp>
 #include <userver/storages/postgres/cluster.hpp>
 
+#include "components/admission_control.hpp"
+#include "components/gazetteer.hpp"
+#include "components/masterclass_catalog.hpp"
+#include "components/request_budgets.hpp"
+
 namespace masterclasses::handlers {
 
 class McAddHandler final : public userver::server::handlers::HttpHandlerBase {
@@ -24,6 +29,10 @@ class McAddHandler final : public userver::server::handlers::HttpHandlerBase {
 
   private:
     userver::storages::postgres::ClusterPtr db_cluster_;
+    components::MasterclassCatalog& catalog_;
+    components::AdmissionControl& admission_;
+    components::RequestBudgets& budgets_;
+    const components::Gazetteer& gazetteer_;
 };
 
 }  // namespace masterclasses::handlers
@@ -0,0 +1,132 @@
+#include "handlers/mc_changes_handler.hpp"
+#include "models/masterclass.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <chrono>
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <userver/formats/json/inline.hpp>
+#include <userver/formats/json/serialize.hpp>
+#include <userver/formats/json/value_builder.hpp>
+#include <userver/server/handlers/exceptions.hpp>
+
+namespace masterclasses::handlers {
+
+namespace {
+
+constexpr std::int64_t kMaxWaitSeconds = 30;
+
+struct Cursor {
+    std::string_view epoch;
+    std::uint64_t version{0};
+};
+
+/// Курсор - `<эпоха>:<версия>`, как его выдаёт этот хэндлер.
+std::optional<Cursor> ParseCursor(std::string_view raw) {
+    const auto colon = raw.rfind(':');
+    if (colon == std::string_view::npos || colon == 0) {
+        return std::nullopt;
+    }
+    Cursor cursor{raw.substr(0, colon)};
+    const auto digits = raw.substr(colon + 1);
+    const auto* end = digits.data() + digits.size();
+    const auto [ptr, ec] = std::from_chars(digits.data(), end, cursor.version);
+    if (ec != std::errc{} || ptr != end) {
+        return std::nullopt;
+    }
+    return cursor;
+}
+
+std::string FormatCursor(std::string_view epoch, std::uint64_t version) {
+    std::string cursor{epoch};
+    cursor.push_back(':');
+    cursor.append(std::to_string(version));
+    return cursor;
+}
+
+}  // namespace
+
+McChangesHandler::McChangesHandler(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : HttpHandlerBase(config, context),
+      catalog_(context.FindComponent<components::MasterclassCatalog>()) {}
+
+std::string McChangesHandler::HandleRequestThrow(
+    const userver::server::http::HttpRequest& request,
+    userver::server::request::RequestContext&) const {
+    request.GetHttpResponse().SetContentType(
+        userver::http::content_type::kApplicationJson);
+
+    if (!catalog_.GetSnapshot()) {
+        request.SetResponseStatus(
+            userver::server::http::HttpStatus::kServiceUnavailable);
+        return userver::formats::json::ToString(
+            userver::formats::json::MakeObject("status", "error", "message",
+                                               "catalog is not ready"));
+    }
+
+    std::optional<Cursor> since;
+    const auto& raw_since = request.GetArg("since");
+    if (!raw_since.empty()) {
+        since = ParseCursor(raw_since);
+        if (!since.has_value()) {
+            throw userver::server::handlers::ClientError(
+                userver::server::handlers::ExternalBody{
+                    "invalid 'since' cursor"});
+        }
+    }
+
+    std::int64_t wait_seconds = 0;
+    const auto& raw_wait = request.GetArg("wait");
+    if (!raw_wait.empty()) {
+        try {
+            wait_seconds =
+                std::clamp<std::int64_t>(std::stoll(raw_wait), 0,
+                                         kMaxWaitSeconds);
+        } catch (const std::exception&) {
+            throw userver::server::handlers::ClientError(
+                userver::server::handlers::ExternalBody{
+                    "invalid 'wait' parameter"});
+        }
+    }
+
+    // Курсор другого запуска (или без курсора) - только полная
+    // перезагрузка, ждать изменений нет смысла.
+    const bool same_epoch =
+        since.has_value() && since->epoch == catalog_.Epoch();
+    if (same_epoch && wait_seconds > 0) {
+        catalog_.WaitForChanges(since->version,
+                                userver::engine::Deadline::FromDuration(
+                                    std::chrono::seconds{wait_seconds}));
+    }
+
+    // Версии начинаются с 1, так что since = 0 всегда даёт resync.
+    const auto changes =
+        catalog_.ChangesSince(same_epoch ? since->version : 0);
+    const auto snapshot = catalog_.GetSnapshot();
+
+    userver::formats::json::ValueBuilder response;
+    response["cursor"] = FormatCursor(catalog_.Epoch(), changes.version);
+    response["resync"] = changes.resync;
+    userver::formats::json::ValueBuilder upserted(
+        userver::formats::common::Type::kArray);
+    userver::formats::json::ValueBuilder deleted(
+        userver::formats::common::Type::kArray);
+    for (const auto id : changes.touched) {
+        if (const auto* row = snapshot->FindById(id)) {
+            upserted.PushBack(models::ToJson(*row));
+        } else {
+            deleted.PushBack(id);
+        }
+    }
+    response["upserted"] = upserted.ExtractValue();
+    response["deleted"] = deleted.ExtractValue();
+    return userver::formats::json::ToString(response.ExtractValue());
+}
+
+}  // namespace masterclasses::handlers
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <string_view>
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/server/handlers/http_handler_base.hpp>
+#include <userver/server/http/http_response.hpp>
+#include <userver/server/request/request_context.hpp>
+
+#include "components/masterclass_catalog.hpp"
+
+namespace masterclasses::handlers {
+
+/// GET /mclist/changes?since=<cursor>&wait=<секунды>: изменения каталога
+/// после курсора из журнала MasterclassCatalog, с long-poll до wait.
+class McChangesHandler final
+    : public userver::server::handlers::HttpHandlerBase {
+  public:
+    static constexpr std::string_view kName = "handler-mclist-changes";
+
+    McChangesHandler(const userver::components::ComponentConfig& config,
+                     const userver::components::ComponentContext& context);
+
+    std::string HandleRequestThrow(
+        const userver::server::http::HttpRequest& request,
+        userver::server::request::RequestContext& context) const override;
+
+  private:
+    const components::MasterclassCatalog& catalog_;
+};
+
+}  // namespace masterclasses::handlers
@@ -42,7 +42,10 @@ McDeleteHandler::McDeleteHandler(
     const userver::components::ComponentContext& context)
     : HttpHandlerBase(config, context),
       db_cluster_(context.FindComponent<userver::components::Postgres>("app-db")
-                      .GetCluster()) {}
+                      .GetCluster()),
+      catalog_(context.FindComponent<components::MasterclassCatalog>()),
+      admission_(context.FindComponent<components::AdmissionControl>()),
+      budgets_(context.FindComponent<components::RequestBudgets>()) {}
 
 std::string McDeleteHandler::HandleRequestThrow(
     const userver::server::http::HttpRequest& request,
@@ -50,6 +53,12 @@ std::string McDeleteHandler::HandleRequestThrow(
     request.GetHttpResponse().SetContentType(
         userver::http::content_type::kApplicationJson);
 
+    const auto budget = budgets_.Start(kName, request);
+    const auto ticket = admission_.Admit(kName);
+    if (!ticket.Admitted()) {
+        return admission_.RenderRejection(request, ticket);
+    }
+
     if (request.GetMethod() != userver::server::http::HttpMethod::kDelete) {
         throw userver::server::handlers::ClientError(
             userver::server::handlers::ExternalBody{
@@ -58,22 +67,25 @@ std::string McDeleteHandler::HandleRequestThrow(
 
     const auto id = ParseId(request);
 
-    const auto result = db_cluster_->Execute(ClusterHostType::kMaster,
-                                             sql::kDeleteMasterclass, id);
+    const auto result = db_cluster_->Execute(
+        ClusterHostType::kMaster, budget.Db(), sql::kDeleteMasterclass, id);
 
     userver::formats::json::ValueBuilder response;
     response["id"] = id;
 
-    if (result.RowsAffected() == 0) {
+    // Строка - в masterclasses или уже в архиве; запрос вернёт её id.
+    if (result.IsEmpty()) {
         request.SetResponseStatus(userver::server::http::HttpStatus::kNotFound);
         response["status"] = "not_found";
         response["message"] = "masterclass with this id does not exist";
     } else {
+        catalog_.Erase(id);
         request.SetResponseStatus(userver::server::http::HttpStatus::kOk);
         response["status"] = "deleted";
     }
 
-    return userver::formats::json::ToString(response.ExtractValue());
+    return budget.GetTrace().Respond(
+        userver::formats::json::ToString(response.ExtractValue()));
 }
 
 }  // namespace masterclasses::handlers
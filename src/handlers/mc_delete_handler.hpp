@@ -9,6 +9,10 @@
 #include <userver/server/request/request_context.hpp>
 #include <userver/storages/postgres/cluster.hpp>
 
+#include "components/admission_control.hpp"
+#include "components/masterclass_catalog.hpp"
+#include "components/request_budgets.hpp"
+
 namespace masterclasses::handlers {
 
 class McDeleteHandler final
@@ -25,6 +29,9 @@ class McDeleteHandler final
 
   private:
     userver::storages::postgres::ClusterPtr db_cluster_;
+    components::MasterclassCatalog& catalog_;
+    components::AdmissionControl& admission_;
+    components::RequestBudgets& budgets_;
 };
 
 }  // namespace masterclasses::handlers
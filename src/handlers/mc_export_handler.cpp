@@ -0,0 +1,297 @@
+#include "handlers/mc_export_handler.hpp"
+#include "catalog/filter.hpp"
+#include "models/masterclass.hpp"
+#include "sql/queries.hpp"
+#include "utils/filter_args.hpp"
+
+#include <charconv>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+
+#include <userver/formats/json/inline.hpp>
+#include <userver/formats/json/serialize.hpp>
+#include <userver/storages/postgres/component.hpp>
+
+namespace masterclasses::handlers {
+
+namespace {
+
+using ClusterHostType = userver::storages::postgres::ClusterHostType;
+
+/// Куски ответа примерно такого размера уходят клиенту по мере готовности.
+constexpr std::size_t kChunkSize = 64 * 1024;
+/// Столько строк за раз читается из курсора Postgres.
+constexpr std::uint32_t kPortalBatch = 500;
+
+constexpr std::string_view kNdjsonContentType = "application/x-ndjson";
+constexpr std::string_view kCsvContentType = "text/csv; charset=utf-8";
+
+enum class ExportFormat { kNdjson, kCsv };
+
+void AppendCsvCell(std::string& out, std::string_view value) {
+    if (value.find_first_of(",\"\r\n") == std::string_view::npos) {
+        out.append(value);
+        return;
+    }
+    out.push_back('"');
+    for (const auto c : value) {
+        if (c == '"') {
+            out.push_back('"');
+        }
+        out.push_back(c);
+    }
+    out.push_back('"');
+}
+
+template <typename T>
+void AppendCsvNumber(std::string& out, T value) {
+    char buffer[32];
+    const auto [end, ec] =
+        std::to_chars(buffer, buffer + sizeof(buffer), value);
+    out.append(buffer, ec == std::errc{} ? end : buffer);
+}
+
+void AppendCsvHeader(std::string& out) {
+    bool first = true;
+    models::VisitMasterclassFields([&](std::string_view name, auto) {
+        if (!std::exchange(first, false)) {
+            out.push_back(',');
+        }
+        out.append(name);
+    });
+    out.append("\r\n");
+}
+
+void AppendRow(std::string& out, ExportFormat format,
+               const models::Masterclass& masterclass) {
+    if (format == ExportFormat::kNdjson) {
+        out.append(
+            userver::formats::json::ToString(models::ToJson(masterclass)));
+        out.push_back('\n');
+        return;
+    }
+    bool first = true;
+    models::VisitMasterclassFields([&](std::string_view, auto field) {
+        if (!std::exchange(first, false)) {
+            out.push_back(',');
+        }
+        const auto& value = masterclass.*field;
+        if constexpr (std::is_same_v<std::decay_t<decltype(value)>,
+                                     std::string>) {
+            AppendCsvCell(out, value);
+        } else if constexpr (std::is_same_v<std::decay_t<decltype(value)>,
+                                            std::optional<double>>) {
+            // Пустая ячейка - NULL.
+            if (value.has_value()) {
+                AppendCsvNumber(out, *value);
+            }
+        } else {
+            AppendCsvNumber(out, value);
+        }
+    });
+    out.append("\r\n");
+}
+
+/// Последняя строка выгрузки. Ответ уже идёт со статусом 200, так что
+/// оборванный посреди поток без неё неотличим от полного: клиент считает
+/// выгрузку целой, только если дочитал до `complete`. В CSV это строка-
+/// комментарий (`comment='#'` в pandas и т.п.).
+void AppendTrailer(std::string& out, ExportFormat format,
+                   std::string_view status, std::uint64_t rows,
+                   std::string_view message) {
+    if (format == ExportFormat::kNdjson) {
+        out.append(userver::formats::json::ToString(
+            message.empty()
+                ? userver::formats::json::MakeObject("status", status, "rows",
+                                                     rows)
+                : userver::formats::json::MakeObject(
+                      "status", status, "rows", rows, "message", message)));
+        out.push_back('\n');
+        return;
+    }
+    out.append("#status=").append(status);
+    out.append(",rows=").append(std::to_string(rows));
+    if (!message.empty()) {
+        out.append(",message=");
+        for (const auto c : message) {
+            out.push_back(c == '\r' || c == '\n' ? ' ' : c);
+        }
+    }
+    out.append("\r\n");
+}
+
+/// Ответ с ошибкой до начала потока: статус и JSON-тело одним куском.
+void RespondError(userver::server::http::ResponseBodyStream& stream,
+                  userver::server::http::HttpStatus status,
+                  std::string_view message,
+                  userver::engine::Deadline deadline) {
+    stream.SetStatusCode(status);
+    stream.SetHeader(std::string{"Content-Type"},
+                     std::string{"application/json; charset=utf-8"});
+    stream.SetEndOfHeaders();
+    stream.PushBodyChunk(userver::formats::json::ToString(
+                             userver::formats::json::MakeObject(
+                                 "status", "error", "message", message)),
+                         deadline);
+}
+
+}  // namespace
+
+McExportHandler::McExportHandler(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : HttpHandlerBase(config, context),
+      db_cluster_(context.FindComponent<userver::components::Postgres>("app-db")
+                      .GetCluster()),
+      catalog_(context.FindComponent<components::MasterclassCatalog>()),
+      admission_(context.FindComponent<components::AdmissionControl>()),
+      budgets_(context.FindComponent<components::RequestBudgets>()) {}
+
+void McExportHandler::HandleStreamRequest(
+    userver::server::http::HttpRequest& request,
+    userver::server::request::RequestContext&,
+    userver::server::http::ResponseBodyStream& response_body_stream) const {
+    const auto budget = budgets_.Start(kName, request);
+    const auto deadline = budget.Deadline();
+    const auto ticket = admission_.Admit(kName);
+    if (!ticket.Admitted()) {
+        response_body_stream.SetHeader(std::string{"Retry-After"},
+                                       std::string{"1"});
+        RespondError(response_body_stream,
+                     ticket.GetRejection() ==
+                             components::AdmissionControl::Rejection::kQueueFull
+                         ? userver::server::http::HttpStatus::kTooManyRequests
+                         : userver::server::http::HttpStatus::
+                               kServiceUnavailable,
+                     "server is overloaded, retry later", deadline);
+        return;
+    }
+
+    const auto& raw_format = request.GetArg("format");
+    ExportFormat format = ExportFormat::kNdjson;
+    if (raw_format == "csv") {
+        format = ExportFormat::kCsv;
+    } else if (!raw_format.empty() && raw_format != "ndjson") {
+        RespondError(response_body_stream,
+                     userver::server::http::HttpStatus::kBadRequest,
+                     "format must be 'ndjson' or 'csv'", deadline);
+        return;
+    }
+
+    catalog::Filter filter;
+    try {
+        filter = utils::ParseFilterArgs(request);
+    } catch (const std::exception& ex) {
+        RespondError(response_body_stream,
+                     userver::server::http::HttpStatus::kBadRequest,
+                     std::string{"invalid filter: "} + ex.what(), deadline);
+        return;
+    }
+
+    // Снимок фиксируется на весь экспорт: изменения каталога во время
+    // выгрузки в неё не попадут. Архива в каталоге нет, поэтому
+    // include_past (с q он - 400) выгружается курсором по Postgres.
+    const auto snapshot =
+        filter.upcoming_from.has_value() ? catalog_.GetSnapshot() : nullptr;
+    if (!snapshot && filter.text.has_value()) {
+        RespondError(response_body_stream,
+                     userver::server::http::HttpStatus::kServiceUnavailable,
+                     "search index is not ready", deadline);
+        return;
+    }
+
+    response_body_stream.SetStatusCode(userver::server::http::HttpStatus::kOk);
+    response_body_stream.SetHeader(
+        std::string{"Content-Type"},
+        std::string{format == ExportFormat::kCsv ? kCsvContentType
+                                                 : kNdjsonContentType});
+    response_body_stream.SetEndOfHeaders();
+
+    std::string chunk;
+    chunk.reserve(kChunkSize * 2);
+    if (format == ExportFormat::kCsv) {
+        AppendCsvHeader(chunk);
+    }
+    std::uint64_t rows = 0;
+    const auto append = [&](const models::Masterclass& row) {
+        AppendRow(chunk, format, row);
+        ++rows;
+        if (chunk.size() >= kChunkSize) {
+            response_body_stream.PushBodyChunk(std::move(chunk), deadline);
+            chunk = std::string{};
+            chunk.reserve(kChunkSize * 2);
+        }
+    };
+    const auto finish = [&] {
+        AppendTrailer(chunk, format, "complete", rows, {});
+        response_body_stream.PushBodyChunk(std::move(chunk), deadline);
+    };
+
+    // Ошибка посреди выгрузки: статус 200 уже ушёл, поэтому сообщаем о
+    // ней последней строкой и пробрасываем дальше.
+    const auto fail = [&](std::string_view message) {
+        chunk.clear();
+        AppendTrailer(chunk, format, "error", rows, message);
+        try {
+            response_body_stream.PushBodyChunk(std::move(chunk), deadline);
+        } catch (const std::exception&) {
+            // Клиент уже отключился.
+        }
+    };
+
+    try {
+        if (snapshot) {
+            const catalog::ColumnFilter matches(filter, *snapshot->columns);
+            if (filter.text.has_value()) {
+                // Текстовый запрос сужает набор строк, порядок остаётся по
+                // id.
+                for (const auto& hit :
+                     snapshot->text_index->Search(*filter.text)) {
+                    const auto position = snapshot->IndexOf(hit.id);
+                    if (position >= 0 &&
+                        matches(static_cast<std::size_t>(position))) {
+                        append(*snapshot->rows[static_cast<std::size_t>(
+                            position)]);
+                    }
+                }
+            } else {
+                for (std::size_t i = 0; i < snapshot->rows.size(); ++i) {
+                    if (matches(i)) {
+                        append(*snapshot->rows[i]);
+                    }
+                }
+            }
+        } else {
+            const catalog::FilterMatcher matches(filter);
+
+            // Каталога нет - серверный курсор, по kPortalBatch строк за раз.
+            auto transaction = db_cluster_->Begin(
+                "mcexport", ClusterHostType::kSlave,
+                userver::storages::postgres::Transaction::RO, budget.Db());
+            auto portal = transaction.MakePortal(
+                budget.Db(), filter.upcoming_from.has_value()
+                                 ? sql::kSelectAllMasterclasses
+                                 : sql::kSelectAllMasterclassesWithArchive);
+            while (!portal.Done()) {
+                const auto batch = portal.Fetch(kPortalBatch);
+                for (const auto& db_row : batch) {
+                    const auto row = models::ParseMasterclassRow(db_row);
+                    if (matches(row)) {
+                        append(row);
+                    }
+                }
+            }
+            transaction.Commit();
+        }
+    } catch (const std::exception&) {
+        fail("export aborted, retry");
+        throw;
+    }
+    finish();
+}
+
+}  // namespace masterclasses::handlers
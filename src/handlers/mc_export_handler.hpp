@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string_view>
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/server/handlers/http_handler_base.hpp>
+#include <userver/server/http/http_response_body_stream.hpp>
+#include <userver/server/request/request_context.hpp>
+#include <userver/storages/postgres/cluster.hpp>
+
+#include "components/admission_control.hpp"
+#include "components/masterclass_catalog.hpp"
+#include "components/request_budgets.hpp"
+
+namespace masterclasses::handlers {
+
+/// GET /mcexport: весь каталог или его часть по фильтрам /mclist одним
+/// потоковым ответом (NDJSON или CSV, chunked). Строки идут из снимка
+/// каталога, без него - из серверного курсора Postgres; в памяти
+/// держится только текущий кусок ответа. Последняя строка - итог
+/// (`complete` и число строк или `error`), по ней видно, что поток не
+/// оборвался.
+class McExportHandler final
+    : public userver::server::handlers::HttpHandlerBase {
+  public:
+    static constexpr std::string_view kName = "handler-mcexport";
+
+    McExportHandler(const userver::components::ComponentConfig& config,
+                    const userver::components::ComponentContext& context);
+
+    void HandleStreamRequest(
+        userver::server::http::HttpRequest& request,
+        userver::server::request::RequestContext& context,
+        userver::server::http::ResponseBodyStream& response_body_stream)
+        const override;
+
+  private:
+    userver::storages::postgres::ClusterPtr db_cluster_;
+    const components::MasterclassCatalog& catalog_;
+    components::AdmissionControl& admission_;
+    components::RequestBudgets& budgets_;
+};
+
+}  // namespace masterclasses::handlers
@@ -0,0 +1,118 @@
+#include "handlers/mc_get_handler.hpp"
+#include "models/masterclass.hpp"
+#include "sql/queries.hpp"
+#include "utils/id_list.hpp"
+#include "utils/response_format.hpp"
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <userver/formats/json/value_builder.hpp>
+#include <userver/server/handlers/exceptions.hpp>
+
+namespace masterclasses::handlers {
+
+namespace {
+
+constexpr std::size_t kMaxIds = 100;
+
+}  // namespace
+
+McGetHandler::McGetHandler(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : HttpHandlerBase(config, context),
+      catalog_(context.FindComponent<components::MasterclassCatalog>()),
+      admission_(context.FindComponent<components::AdmissionControl>()),
+      budgets_(context.FindComponent<components::RequestBudgets>()),
+      hedged_reads_(context.FindComponent<components::HedgedReads>()) {}
+
+std::string McGetHandler::HandleRequestThrow(
+    const userver::server::http::HttpRequest& request,
+    userver::server::request::RequestContext&) const {
+    request.GetHttpResponse().SetContentType(
+        userver::http::content_type::kApplicationJson);
+
+    const auto budget = budgets_.Start(kName, request);
+
+    // Повторы схлопываются, порядок первого вхождения сохраняется.
+    std::vector<std::int64_t> ids;
+    {
+        std::unordered_set<std::int64_t> unique;
+        for (const auto id : utils::ParseIdList(request.GetArg("ids"))) {
+            if (unique.insert(id).second) {
+                ids.push_back(id);
+            }
+        }
+    }
+    if (ids.empty()) {
+        throw userver::server::handlers::ClientError(
+            userver::server::handlers::ExternalBody{
+                "query parameter 'ids' is required"});
+    }
+    if (ids.size() > kMaxIds) {
+        throw userver::server::handlers::ClientError(
+            userver::server::handlers::ExternalBody{
+                "at most " + std::to_string(kMaxIds) + " ids per request"});
+    }
+
+    // Указатели в снимок (он держится до конца запроса) и в строки из БД,
+    // как страница /user/favorites: мастер-классы не копируются.
+    const auto snapshot = catalog_.GetSnapshot();
+    std::unordered_map<std::int64_t, const models::Masterclass*> found;
+    std::vector<std::int64_t> misses;
+    if (snapshot) {
+        for (const auto id : ids) {
+            if (const auto* row = snapshot->FindById(id)) {
+                found.emplace(id, row);
+            } else {
+                misses.push_back(id);
+            }
+        }
+    } else {
+        misses = ids;
+    }
+
+    // Промах - строка могла появиться в БД после последней перезагрузки
+    // каталога; в Postgres идём только за ними и одним запросом.
+    std::vector<models::Masterclass> from_db;
+    if (!misses.empty()) {
+        const auto ticket = admission_.Admit(kName);
+        if (!ticket.Admitted()) {
+            return admission_.RenderRejection(request, ticket);
+        }
+        const auto result = hedged_reads_.Execute(
+            budget.Db(), sql::kSelectMasterclassesByIds, misses);
+        // reserve: указатели на элементы from_db не должны протухнуть.
+        from_db.reserve(result.Size());
+        for (const auto& row : result) {
+            const auto& masterclass =
+                from_db.emplace_back(models::ParseMasterclassRow(row));
+            found.emplace(masterclass.id, &masterclass);
+        }
+    }
+
+    std::vector<const models::Masterclass*> masterclasses;
+    masterclasses.reserve(found.size());
+    userver::formats::json::ValueBuilder missing(
+        userver::formats::json::Type::kArray);
+    for (const auto id : ids) {
+        const auto it = found.find(id);
+        if (it == found.end()) {
+            missing.PushBack(id);
+        } else {
+            masterclasses.push_back(it->second);
+        }
+    }
+
+    userver::formats::json::ValueBuilder meta;
+    meta["returned"] = masterclasses.size();
+    meta["missing"] = missing.ExtractValue();
+    return budget.GetTrace().Respond(utils::RenderMasterclassList(
+        request, masterclasses, meta.ExtractValue()));
+}
+
+}  // namespace masterclasses::handlers
@@ -0,0 +1,38 @@
+#pragma once
+
+#include <string_view>
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/server/handlers/http_handler_base.hpp>
+#include <userver/server/http/http_response.hpp>
+#include <userver/server/request/request_context.hpp>
+
+#include "components/admission_control.hpp"
+#include "components/hedged_reads.hpp"
+#include "components/masterclass_catalog.hpp"
+#include "components/request_budgets.hpp"
+
+namespace masterclasses::handlers {
+
+/// GET /mc?ids=1,2,3: мастер-классы по id в порядке запроса. Отвечает из
+/// каталога; id, которых в нём нет, добираются одним запросом к реплике.
+class McGetHandler final : public userver::server::handlers::HttpHandlerBase {
+  public:
+    static constexpr std::string_view kName = "handler-mc-get";
+
+    McGetHandler(const userver::components::ComponentConfig& config,
+                 const userver::components::ComponentContext& context);
+
+    std::string HandleRequestThrow(
+        const userver::server::http::HttpRequest& request,
+        userver::server::request::RequestContext& context) const override;
+
+  private:
+    const components::MasterclassCatalog& catalog_;
+    components::AdmissionControl& admission_;
+    components::RequestBudgets& budgets_;
+    components::HedgedReads& hedged_reads_;
+};
+
+}  // namespace masterclasses::handlers
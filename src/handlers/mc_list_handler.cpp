@@ -1,26 +1,33 @@
 #include "handlers/mc_list_handler.hpp"
+#include "catalog/filter.hpp"
+#include "catalog/select.hpp"
+#include "models/masterclass.hpp"
 #include "sql/queries.hpp"
+#include "utils/filter_args.hpp"
+#include "utils/id_list.hpp"
+#include "utils/id_set.hpp"
+#include "utils/request_arena.hpp"
+#include "utils/response_format.hpp"
 
 #include <algorithm>
-#include <cctype>
 #include <cstdint>
+#include <memory_resource>
 #include <optional>
 #include <stdexcept>
 #include <string>
-#include <string_view>
 #include <vector>
 
+#include <userver/formats/json/inline.hpp>
 #include <userver/formats/json/serialize.hpp>
 #include <userver/formats/json/value_builder.hpp>
+#include <userver/logging/log.hpp>
 #include <userver/server/handlers/exceptions.hpp>
-#include <userver/storages/postgres/component.hpp>
+#include <userver/storages/postgres/exceptions.hpp>
 
 namespace masterclasses::handlers {
 
 namespace {
 
-using ClusterHostType = userver::storages::postgres::ClusterHostType;
-
 std::int64_t ParsePositiveInt(const std::string& raw) {
     if (raw.empty()) {
         throw std::invalid_argument("value is empty");
@@ -53,49 +60,75 @@ std::int64_t ParseNonNegativeInt(const std::string& raw) {
     return value;
 }
 
-std::vector<std::int64_t> ParseIdList(std::string_view raw) {
-    std::vector<std::int64_t> ids;
-    std::size_t start = 0;
-    while (start < raw.size()) {
-        auto end = raw.find(',', start);
-        if (end == std::string_view::npos) {
-            end = raw.size();
-        }
-        auto token = raw.substr(start, end - start);
-        while (!token.empty() && token.front() == ' ')
-            token.remove_prefix(1);
-        while (!token.empty() && token.back() == ' ')
-            token.remove_suffix(1);
-        if (!token.empty()) {
-            try {
-                auto value = std::stoll(std::string(token));
-                if (value > 0) {
-                    ids.push_back(value);
-                }
-            } catch (const std::exception&) {
-            }
-        }
-        start = end + 1;
-    }
-    return ids;
-}
-
 constexpr std::int64_t kMaxLimit = 100;
 
-/// Strict YYYY-MM-DD for query params (avoids injection).
-bool IsValidIsoDate(std::string_view s) {
-    if (s.size() != 10) {
-        return false;
-    }
-    if (s[4] != '-' || s[7] != '-') {
-        return false;
+/// SQL с тем же порядком, что и у каталога (catalog/sort_keys.cpp).
+/// popular в Postgres - по числу добавлений в избранное без затухания.
+/// Предстоящие читаются из masterclasses, а представление с архивом -
+/// только для include_past: общий текст с условием на $15 под generic
+/// plan просматривал бы архив и в ленте по умолчанию.
+const userver::storages::postgres::Query& DbQueryFor(catalog::SortOrder order,
+                                                     bool include_past) {
+    switch (order) {
+        case catalog::SortOrder::kDateAsc:
+            return include_past
+                       ? sql::kSelectMasterclassesFilteredDateAscWithArchive
+                       : sql::kSelectMasterclassesFilteredDateAsc;
+        case catalog::SortOrder::kDateDesc:
+            return include_past
+                       ? sql::kSelectMasterclassesFilteredDateDescWithArchive
+                       : sql::kSelectMasterclassesFilteredDateDesc;
+        case catalog::SortOrder::kPriceAsc:
+            return include_past
+                       ? sql::kSelectMasterclassesFilteredPriceAscWithArchive
+                       : sql::kSelectMasterclassesFilteredPriceAsc;
+        case catalog::SortOrder::kPriceDesc:
+            return include_past
+                       ? sql::kSelectMasterclassesFilteredPriceDescWithArchive
+                       : sql::kSelectMasterclassesFilteredPriceDesc;
+        case catalog::SortOrder::kRatingDesc:
+            return include_past
+                       ? sql::kSelectMasterclassesFilteredRatingDescWithArchive
+                       : sql::kSelectMasterclassesFilteredRatingDesc;
+        case catalog::SortOrder::kPopular:
+            return include_past
+                       ? sql::kSelectMasterclassesFilteredPopularWithArchive
+                       : sql::kSelectMasterclassesFilteredPopular;
+        default:
+            return include_past ? sql::kSelectMasterclassesFilteredWithArchive
+                                : sql::kSelectMasterclassesFiltered;
     }
-    for (std::size_t i : {0u, 1u, 2u, 3u, 5u, 6u, 8u, 9u}) {
-        if (!std::isdigit(static_cast<unsigned char>(s[i]))) {
-            return false;
-        }
+}
+
+std::vector<models::Masterclass> SelectFromDb(
+    components::HedgedReads& hedged_reads,
+    const userver::storages::postgres::CommandControl& command_control,
+    const userver::storages::postgres::Query& query,
+    const catalog::Filter& filter,
+    const std::optional<std::vector<std::int64_t>>& exclude_ids,
+    std::int64_t limit, std::int64_t offset) {
+    // У запросов по представлению с архивом нет $15.
+    const auto result =
+        filter.upcoming_from.has_value()
+            ? hedged_reads.Execute(
+                  command_control, query, filter.category, filter.audience,
+                  filter.tags, filter.format, filter.company, filter.min_age,
+                  filter.max_price, filter.min_price, filter.min_rating,
+                  exclude_ids, filter.event_date_from, filter.event_date_to,
+                  limit, offset, *filter.upcoming_from)
+            : hedged_reads.Execute(
+                  command_control, query, filter.category, filter.audience,
+                  filter.tags, filter.format, filter.company, filter.min_age,
+                  filter.max_price, filter.min_price, filter.min_rating,
+                  exclude_ids, filter.event_date_from, filter.event_date_to,
+                  limit, offset);
+
+    std::vector<models::Masterclass> masterclasses;
+    masterclasses.reserve(result.Size());
+    for (const auto& row : result) {
+        masterclasses.push_back(models::ParseMasterclassRow(row));
     }
-    return true;
+    return masterclasses;
 }
 
 }  // namespace
@@ -104,8 +137,15 @@ McListHandler::McListHandler(
     const userver::components::ComponentConfig& config,
     const userver::components::ComponentContext& context)
     : HttpHandlerBase(config, context),
-      db_cluster_(context.FindComponent<userver::components::Postgres>("app-db")
-                      .GetCluster()) {}
+      catalog_(context.FindComponent<components::MasterclassCatalog>()),
+      seen_sets_(context.FindComponent<components::SeenSets>()),
+      favorite_counters_(
+          context.FindComponent<components::FavoriteCounters>()),
+      admission_(context.FindComponent<components::AdmissionControl>()),
+      budgets_(context.FindComponent<components::RequestBudgets>()),
+      hedged_reads_(context.FindComponent<components::HedgedReads>()),
+      allocation_stats_(context.FindComponent<components::AllocationStats>()
+                            .ForHandler(kName)) {}
 
 std::string McListHandler::HandleRequestThrow(
     const userver::server::http::HttpRequest& request,
@@ -113,8 +153,19 @@ std::string McListHandler::HandleRequestThrow(
     request.GetHttpResponse().SetContentType(
         userver::http::content_type::kApplicationJson);
 
-    const auto raw_limit = request.GetArg("n");
-    const auto raw_offset = request.GetArg("offset");
+    // Временное (id, страница, кандидаты выборки) - в арене запроса.
+    utils::RequestArena arena;
+    const components::AllocationStats::Scope allocations(allocation_stats_,
+                                                         arena);
+
+    const auto budget = budgets_.Start(kName, request);
+    const auto ticket = admission_.Admit(kName);
+    if (!ticket.Admitted()) {
+        return admission_.RenderRejection(request, ticket);
+    }
+
+    const auto& raw_limit = request.GetArg("n");
+    const auto& raw_offset = request.GetArg("offset");
 
     std::int64_t limit = 20;
     if (!raw_limit.empty()) {
@@ -133,141 +184,149 @@ std::string McListHandler::HandleRequestThrow(
         }
     }
 
-    auto category = request.GetArg("category");
-    auto audience = request.GetArg("audience");
-    auto tags = request.GetArg("tags");
-    auto format = request.GetArg("format");
-    auto company = request.GetArg("company");
-    auto exclude_ids = request.GetArg("exclude_ids");
+    const auto& exclude_ids = request.GetArg("exclude_ids");
 
-    std::optional<int> min_age;
-    if (request.HasArg("min_age")) {
-        min_age = std::stoi(request.GetArg("min_age"));
+    catalog::Filter filter;
+    try {
+        filter = utils::ParseFilterArgs(request);
+    } catch (const std::exception& ex) {
+        throw userver::server::handlers::ClientError(
+            userver::server::handlers::ExternalBody{
+                std::string{"invalid filter: "} + ex.what()});
     }
-
-    std::optional<double> max_price;
-    if (request.HasArg("max_price")) {
-        max_price = std::stod(request.GetArg("max_price"));
+    std::optional<std::pmr::vector<std::int64_t>> exclude_ids_opt;
+    if (!exclude_ids.empty()) {
+        auto parsed_ids = utils::ParseIdList(exclude_ids, arena.Resource());
+        if (!parsed_ids.empty()) {
+            exclude_ids_opt = std::move(parsed_ids);
+        }
     }
 
-    std::optional<double> min_price;
-    if (request.HasArg("min_price")) {
-        min_price = std::stod(request.GetArg("min_price"));
-    }
+    const auto& sort_order = request.GetArg("sort_order");
+    auto order = catalog::ParseSortOrder(sort_order).value_or(
+        catalog::SortOrder::kId);
+
+    const auto& query =
+        DbQueryFor(order, !filter.upcoming_from.has_value());
 
-    std::optional<double> min_rating;
-    if (request.HasArg("min_rating")) {
-        min_rating = std::stod(request.GetArg("min_rating"));
+    if (filter.text.has_value() && sort_order.empty()) {
+        order = catalog::SortOrder::kRelevance;
+    } else if (filter.near.has_value() && sort_order.empty()) {
+        order = catalog::SortOrder::kDistance;
     }
 
-    std::optional<std::string> category_opt =
-        category.empty() ? std::nullopt : std::optional<std::string>(category);
-    if (category_opt.has_value()) {
-        const auto& c = *category_opt;
-        if (c == "photo_video" || c == "photography") {
-            category_opt = "photo_video,photography";
-        } else if (c == "tech_digital" || c == "tech_coding") {
-            category_opt = "tech_digital,tech_coding";
+    std::optional<components::SeenSets::Handle> seen;
+    std::string seen_token;
+    if (request.HasArg("seen_token")) {
+        // Исключение показанного - AND-NOT по seen-set'у в памяти вместо
+        // id <> ALL($10) в Postgres.
+        seen_token = request.GetArg("seen_token");
+        if (seen_token.empty()) {
+            seen_token = components::SeenSets::GenerateToken();
+        } else if (!components::SeenSets::IsValidToken(seen_token)) {
+            throw userver::server::handlers::ClientError(
+                userver::server::handlers::ExternalBody{
+                    "invalid 'seen_token': use the token from a previous "
+                    "response or an empty value"});
         }
-    }
-    std::optional<std::string> audience_opt =
-        audience.empty() ? std::nullopt : std::optional<std::string>(audience);
-    std::optional<std::string> tags_opt =
-        tags.empty() ? std::nullopt : std::optional<std::string>(tags);
-    std::optional<std::string> format_opt =
-        format.empty() ? std::nullopt : std::optional<std::string>(format);
-    std::optional<std::string> company_opt =
-        company.empty() ? std::nullopt : std::optional<std::string>(company);
-    std::optional<std::vector<std::int64_t>> exclude_ids_opt = std::nullopt;
-    if (!exclude_ids.empty()) {
-        auto parsed_ids = ParseIdList(exclude_ids);
-        if (!parsed_ids.empty()) {
-            exclude_ids_opt = std::move(parsed_ids);
+        seen.emplace(seen_sets_.Acquire(seen_token));
+        if (exclude_ids_opt.has_value()) {
+            seen->Add(*exclude_ids_opt);
         }
     }
 
-    std::optional<std::string> event_date_from_opt = std::nullopt;
-    std::optional<std::string> event_date_to_opt = std::nullopt;
-    if (request.HasArg("event_date_from")) {
-        const auto& s = request.GetArg("event_date_from");
-        if (IsValidIsoDate(s)) {
-            event_date_from_opt = std::string(s);
+    const auto select_from_catalog =
+        [&](const catalog::CatalogSnapshot& snapshot) {
+            utils::IdSet explicit_excluded;
+            const utils::IdSet* excluded = nullptr;
+            if (seen.has_value()) {
+                excluded = &seen->Ids();
+            } else if (exclude_ids_opt.has_value()) {
+                for (const auto id : *exclude_ids_opt) {
+                    explicit_excluded.Add(id);
+                }
+                excluded = &explicit_excluded;
+            }
+            const auto popularity = order == catalog::SortOrder::kPopular
+                                        ? favorite_counters_.GetRanking()
+                                        : nullptr;
+            return catalog::Select(snapshot, filter, excluded, order, limit,
+                                   offset, popularity.get(), arena.Resource());
+        };
+
+    // Страница - указатели в снимок каталога или в строки из БД; и то и
+    // другое живёт до конца запроса. В каталоге нет архива, так что
+    // include_past читается из Postgres (с q и lat/lon он - 400).
+    catalog::Page masterclasses(arena.Resource());
+    std::vector<models::Masterclass> from_db;
+    const bool catalog_only =
+        filter.text.has_value() || filter.near.has_value();
+    const bool catalog_preferred =
+        filter.upcoming_from.has_value() &&
+        (seen.has_value() || order != catalog::SortOrder::kId);
+    auto snapshot = (catalog_only || catalog_preferred)
+                        ? catalog_.GetSnapshot()
+                        : nullptr;
+    if (snapshot) {
+        masterclasses = select_from_catalog(*snapshot);
+    } else if (catalog_only) {
+        // Полнотекстовый и гео-поиск есть только в каталоге.
+        request.SetResponseStatus(
+            userver::server::http::HttpStatus::kServiceUnavailable);
+        return userver::formats::json::ToString(
+            userver::formats::json::MakeObject(
+                "status", "error", "message",
+                filter.text.has_value() ? "search index is not ready"
+                                        : "geo index is not ready"));
+    } else {
+        std::optional<std::vector<std::int64_t>> db_exclude_ids;
+        if (exclude_ids_opt.has_value()) {
+            db_exclude_ids.emplace(exclude_ids_opt->begin(),
+                                   exclude_ids_opt->end());
         }
-    }
-    if (request.HasArg("event_date_to")) {
-        const auto& s = request.GetArg("event_date_to");
-        if (IsValidIsoDate(s)) {
-            event_date_to_opt = std::string(s);
+        if (seen.has_value()) {
+            db_exclude_ids = std::nullopt;
+            if (!seen->Ids().Empty()) {
+                db_exclude_ids = seen->Ids().ToVector();
+            }
+        }
+        try {
+            from_db = SelectFromDb(hedged_reads_, budget.Db(), query,
+                                   filter, db_exclude_ids, limit, offset);
+            for (const auto& row : from_db) {
+                masterclasses.push_back(&row);
+            }
+        } catch (const userver::storages::postgres::Error& ex) {
+            // Postgres недоступен - лента читается из каталога (в том
+            // числе поднятого из файла снимка), если он есть. Для
+            // include_past это не подходит: в каталоге нет архива.
+            if (!filter.upcoming_from.has_value()) {
+                throw;
+            }
+            snapshot = catalog_.GetSnapshot();
+            if (!snapshot) {
+                throw;
+            }
+            LOG_WARNING() << "mclist falls back to catalog: " << ex.what();
+            masterclasses = select_from_catalog(*snapshot);
         }
     }
 
-    auto sort_order = request.GetArg("sort_order");
-    const userver::storages::postgres::Query* query_ptr =
-        &sql::kSelectMasterclassesFiltered;
-
-    if (sort_order == "date_asc") {
-        query_ptr = &sql::kSelectMasterclassesFilteredDateAsc;
-    } else if (sort_order == "date_desc") {
-        query_ptr = &sql::kSelectMasterclassesFilteredDateDesc;
-    }
-
-    const auto result = db_cluster_->Execute(
-        ClusterHostType::kSlave, *query_ptr, category_opt, audience_opt,
-        tags_opt, format_opt, company_opt, min_age, max_price, min_price,
-        min_rating, exclude_ids_opt, event_date_from_opt, event_date_to_opt,
-        limit, offset);
-
-    userver::formats::json::ValueBuilder masterclasses_json(
-        userver::formats::json::Type::kArray);
-
-    for (const auto& row : result) {
-        userver::formats::json::ValueBuilder entry;
-        entry["id"] = row["id"].As<std::int64_t>();
-        entry["title"] = row["title"].As<std::string>();
-        entry["location"] = row["location"].As<std::string>();
-        entry["price"] = row["price"].As<double>();
-        entry["website"] = row["website"].As<std::string>();
-        entry["image_url"] = row["image_url"].As<std::string>();
-
-        entry["format"] =
-            row["format"].As<std::optional<std::string>>().value_or("offline");
-        entry["company"] =
-            row["company"].As<std::optional<std::string>>().value_or("single");
-        entry["category"] =
-            row["category"].As<std::optional<std::string>>().value_or("");
-        entry["min_age"] = row["min_age"].As<std::optional<int>>().value_or(0);
-        entry["rating"] =
-            row["rating"].As<std::optional<double>>().value_or(5.0);
-
-        entry["description"] =
-            row["description"].As<std::optional<std::string>>().value_or("");
-        entry["event_date"] =
-            row["event_date"].As<std::optional<std::string>>().value_or("");
-        entry["duration"] =
-            row["duration"].As<std::optional<std::string>>().value_or("");
-        entry["organizer"] =
-            row["organizer"].As<std::optional<std::string>>().value_or("");
-        entry["audience"] =
-            row["audience"].As<std::optional<std::string>>().value_or("");
-        entry["additional_tags"] =
-            row["additional_tags"].As<std::optional<std::string>>().value_or(
-                "");
-        entry["contact_tg"] =
-            row["contact_tg"].As<std::optional<std::string>>().value_or("");
-        entry["contact_vk"] =
-            row["contact_vk"].As<std::optional<std::string>>().value_or("");
-        entry["contact_phone"] =
-            row["contact_phone"].As<std::optional<std::string>>().value_or("");
-
-        masterclasses_json.PushBack(entry.ExtractValue());
+    userver::formats::json::ValueBuilder meta;
+    meta["returned"] = masterclasses.size();
+    if (seen.has_value()) {
+        std::pmr::vector<std::int64_t> returned_ids(arena.Resource());
+        returned_ids.reserve(masterclasses.size());
+        for (const auto* mc : masterclasses) {
+            returned_ids.push_back(mc->id);
+        }
+        seen->Add(returned_ids);
+        meta["seen_token"] = seen_token;
     }
 
-    userver::formats::json::ValueBuilder response;
-    response["returned"] = result.Size();
-    response["masterclasses"] = masterclasses_json.ExtractValue();
-
     request.SetResponseStatus(userver::server::http::HttpStatus::kOk);
-    return userver::formats::json::ToString(response.ExtractValue());
+    return budget.GetTrace().Respond(utils::RenderMasterclassList(
+        request, masterclasses, meta.ExtractValue()));
 }
 
 }  // namespace masterclasses::handlers
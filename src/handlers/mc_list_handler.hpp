@@ -7,7 +7,14 @@
 #include <userver/server/handlers/http_handler_base.hpp>
 #include <userver/server/http/http_response.hpp>
 #include <userver/server/request/request_context.hpp>
-#include <userver/storages/postgres/cluster.hpp>
+
+#include "components/admission_control.hpp"
+#include "components/allocation_stats.hpp"
+#include "components/favorite_counters.hpp"
+#include "components/hedged_reads.hpp"
+#include "components/masterclass_catalog.hpp"
+#include "components/request_budgets.hpp"
+#include "components/seen_sets.hpp"
 
 namespace masterclasses::handlers {
 
@@ -23,7 +30,13 @@ class McListHandler final : public userver::server::handlers::HttpHandlerBase {
         userver::server::request::RequestContext& context) const override;
 
   private:
-    userver::storages::postgres::ClusterPtr db_cluster_;
+    const components::MasterclassCatalog& catalog_;
+    components::SeenSets& seen_sets_;
+    const components::FavoriteCounters& favorite_counters_;
+    components::AdmissionControl& admission_;
+    components::RequestBudgets& budgets_;
+    components::HedgedReads& hedged_reads_;
+    components::AllocationStats::HandlerStats& allocation_stats_;
 };
 
 }  // namespace masterclasses::handlers
@@ -0,0 +1,98 @@
+#include "handlers/mc_similar_handler.hpp"
+#include "models/masterclass.hpp"
+#include "utils/response_format.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <userver/formats/json/inline.hpp>
+#include <userver/formats/json/serialize.hpp>
+#include <userver/formats/json/value_builder.hpp>
+#include <userver/server/handlers/exceptions.hpp>
+
+namespace masterclasses::handlers {
+
+namespace {
+
+constexpr std::int64_t kDefaultK = 10;
+constexpr std::int64_t kMaxK = 50;
+
+std::int64_t ParseIntArg(const userver::server::http::HttpRequest& request,
+                         const std::string& name) {
+    try {
+        return std::stoll(request.GetArg(name));
+    } catch (const std::exception& ex) {
+        throw userver::server::handlers::ClientError(
+            userver::server::handlers::ExternalBody{
+                "invalid '" + name + "' parameter: " + std::string{ex.what()}});
+    }
+}
+
+}  // namespace
+
+McSimilarHandler::McSimilarHandler(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : HttpHandlerBase(config, context),
+      catalog_(context.FindComponent<components::MasterclassCatalog>()),
+      traces_(context.FindComponent<components::RequestTraces>()) {}
+
+std::string McSimilarHandler::HandleRequestThrow(
+    const userver::server::http::HttpRequest& request,
+    userver::server::request::RequestContext&) const {
+    request.GetHttpResponse().SetContentType(
+        userver::http::content_type::kApplicationJson);
+
+    // Без БД и бюджета, но в трассы запросов попадает.
+    components::RequestTraces::Trace trace(traces_, kName, request);
+
+    if (request.GetArg("id").empty()) {
+        throw userver::server::handlers::ClientError(
+            userver::server::handlers::ExternalBody{
+                "query parameter 'id' is required"});
+    }
+    const auto id = ParseIntArg(request, "id");
+    auto k = kDefaultK;
+    if (!request.GetArg("k").empty()) {
+        k = std::clamp(ParseIntArg(request, "k"), std::int64_t{1}, kMaxK);
+    }
+
+    // Векторы признаков есть только в каталоге, в SQL-фолбэк не уходим.
+    const auto snapshot = catalog_.GetSnapshot();
+    if (!snapshot) {
+        request.SetResponseStatus(
+            userver::server::http::HttpStatus::kServiceUnavailable);
+        return userver::formats::json::ToString(
+            userver::formats::json::MakeObject("status", "error", "message",
+                                               "catalog is not ready"));
+    }
+    const auto row = snapshot->IndexOf(id);
+    if (row < 0) {
+        request.SetResponseStatus(userver::server::http::HttpStatus::kNotFound);
+        return userver::formats::json::ToString(
+            userver::formats::json::MakeObject(
+                "id", id, "status", "not_found", "message",
+                "masterclass with this id does not exist"));
+    }
+
+    const auto neighbors = snapshot->features->Nearest(
+        static_cast<std::size_t>(row), static_cast<std::size_t>(k));
+    std::vector<models::Masterclass> masterclasses;
+    masterclasses.reserve(neighbors.size());
+    for (const auto& neighbor : neighbors) {
+        masterclasses.push_back(*snapshot->rows[neighbor.row]);
+    }
+
+    userver::formats::json::ValueBuilder meta;
+    meta["id"] = id;
+    meta["returned"] = masterclasses.size();
+
+    request.SetResponseStatus(userver::server::http::HttpStatus::kOk);
+    return trace.Respond(utils::RenderMasterclassList(request, masterclasses,
+                                                      meta.ExtractValue()));
+}
+
+}  // namespace masterclasses::handlers
@@ -0,0 +1,318 @@
+#include "handlers/mc_sync_handler.hpp"
+#include "models/masterclass.hpp"
+#include "models/masterclass_csv.hpp"
+#include "sql/queries.hpp"
+#include "utils/csv.hpp"
+#include "utils/filter_args.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <userver/formats/json/serialize.hpp>
+#include <userver/formats/json/value_builder.hpp>
+#include <userver/formats/serialize/common_containers.hpp>
+#include <userver/logging/log.hpp>
+#include <userver/server/handlers/exceptions.hpp>
+#include <userver/server/http/http_method.hpp>
+#include <userver/storages/postgres/component.hpp>
+
+namespace masterclasses::handlers {
+
+namespace {
+
+using ClusterHostType = userver::storages::postgres::ClusterHostType;
+
+struct SourceRow {
+    models::Masterclass masterclass;
+    std::int64_t hash;
+};
+
+/// Строк в одном UNNEST-запросе: один круг до БД на пачку, а не на строку,
+/// при этом параметры запроса остаются в пределах нескольких мегабайт.
+constexpr std::size_t kUpsertBatchSize = 1000;
+
+/// Доля строк из файла, которую синхронизация удаляет без
+/// allow_mass_delete=1. Обрезанный или пустой файл иначе стёр бы каталог.
+constexpr double kMaxDeleteFraction = 0.5;
+
+bool IsTrue(const std::string& arg) { return arg == "1" || arg == "true"; }
+
+/// Колонки пачки для upsert_masterclasses_from_source_batch. Пустая дата
+/// и NaN в координатах превращаются в запросе в NULL.
+struct UpsertBatch {
+    explicit UpsertBatch(std::span<const SourceRow* const> rows) {
+        const auto reserve = [&rows](auto&... columns) {
+            (columns.reserve(rows.size()), ...);
+        };
+        reserve(id, title, location, price, website, image_url, format,
+                company, category, min_age, rating, description, event_date,
+                duration, organizer, contact_tg, contact_vk, contact_phone,
+                audience, additional_tags, latitude, longitude, hash);
+        for (const auto* row : rows) {
+            const auto& mc = row->masterclass;
+            id.push_back(mc.id);
+            title.push_back(mc.title);
+            location.push_back(mc.location);
+            price.push_back(mc.price);
+            website.push_back(mc.website);
+            image_url.push_back(mc.image_url);
+            format.push_back(mc.format);
+            company.push_back(mc.company);
+            category.push_back(mc.category);
+            min_age.push_back(mc.min_age);
+            rating.push_back(mc.rating);
+            description.push_back(mc.description);
+            event_date.push_back(mc.event_date);
+            duration.push_back(mc.duration);
+            organizer.push_back(mc.organizer);
+            contact_tg.push_back(mc.contact_tg);
+            contact_vk.push_back(mc.contact_vk);
+            contact_phone.push_back(mc.contact_phone);
+            audience.push_back(mc.audience);
+            additional_tags.push_back(mc.additional_tags);
+            latitude.push_back(mc.latitude.value_or(kNoCoordinate));
+            longitude.push_back(mc.longitude.value_or(kNoCoordinate));
+            hash.push_back(row->hash);
+        }
+    }
+
+    static constexpr double kNoCoordinate =
+        std::numeric_limits<double>::quiet_NaN();
+
+    std::vector<std::int64_t> id;
+    std::vector<std::string> title;
+    std::vector<std::string> location;
+    std::vector<double> price;
+    std::vector<std::string> website;
+    std::vector<std::string> image_url;
+    std::vector<std::string> format;
+    std::vector<std::string> company;
+    std::vector<std::string> category;
+    std::vector<int> min_age;
+    std::vector<double> rating;
+    std::vector<std::string> description;
+    std::vector<std::string> event_date;
+    std::vector<std::string> duration;
+    std::vector<std::string> organizer;
+    std::vector<std::string> contact_tg;
+    std::vector<std::string> contact_vk;
+    std::vector<std::string> contact_phone;
+    std::vector<std::string> audience;
+    std::vector<std::string> additional_tags;
+    std::vector<double> latitude;
+    std::vector<double> longitude;
+    std::vector<std::int64_t> hash;
+};
+
+}  // namespace
+
+McSyncHandler::McSyncHandler(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : HttpHandlerBase(config, context),
+      db_cluster_(context.FindComponent<userver::components::Postgres>("app-db")
+                      .GetCluster()),
+      catalog_(context.FindComponent<components::MasterclassCatalog>()),
+      admission_(context.FindComponent<components::AdmissionControl>()),
+      budgets_(context.FindComponent<components::RequestBudgets>()),
+      gazetteer_(context.FindComponent<components::Gazetteer>()) {}
+
+std::string McSyncHandler::HandleRequestThrow(
+    const userver::server::http::HttpRequest& request,
+    userver::server::request::RequestContext&) const {
+    request.GetHttpResponse().SetContentType(
+        userver::http::content_type::kApplicationJson);
+
+    const auto budget = budgets_.Start(kName, request);
+    const auto ticket = admission_.Admit(kName);
+    if (!ticket.Admitted()) {
+        return admission_.RenderRejection(request, ticket);
+    }
+
+    if (request.GetMethod() != userver::server::http::HttpMethod::kPost) {
+        throw userver::server::handlers::ClientError(
+            userver::server::handlers::ExternalBody{
+                "mcsync expects POST requests"});
+    }
+    const bool dry_run = IsTrue(request.GetArg("dry_run"));
+    const bool allow_mass_delete = IsTrue(request.GetArg("allow_mass_delete"));
+
+    // Разбор и нормализация - до транзакции, чтобы не держать её на CPU.
+    utils::CsvReader reader(request.RequestBody());
+    std::vector<std::string> fields;
+    if (!reader.Next(fields)) {
+        throw userver::server::handlers::ClientError(
+            userver::server::handlers::ExternalBody{"CSV body is empty"});
+    }
+
+    // Прошедшие строки файла в masterclasses не пишутся (их место - в
+    // архиве), но и удалять их как пропавшие из файла нельзя.
+    const auto upcoming_from = utils::UpcomingFrom();
+    std::vector<SourceRow> rows;
+    std::unordered_set<std::int64_t> present;
+    std::size_t parsed = 0;
+    std::size_t skipped = 0;
+    std::size_t past = 0;
+    while (reader.Next(fields)) {
+        std::optional<models::Masterclass> masterclass;
+        try {
+            masterclass = models::ParseCsvMasterclass(fields);
+        } catch (const std::invalid_argument& e) {
+            throw userver::server::handlers::ClientError(
+                userver::server::handlers::ExternalBody{
+                    std::string{e.what()} + " at line " +
+                    std::to_string(reader.Line())});
+        }
+        if (!masterclass) {
+            ++skipped;
+            continue;
+        }
+        ++parsed;
+        if (!present.insert(masterclass->id).second) {
+            throw userver::server::handlers::ClientError(
+                userver::server::handlers::ExternalBody{
+                    "duplicate id " + std::to_string(masterclass->id) +
+                    " at line " + std::to_string(reader.Line())});
+        }
+        if (!masterclass->event_date.empty() &&
+            masterclass->event_date < upcoming_from) {
+            ++past;
+            continue;
+        }
+        auto point = gazetteer_.Locate(masterclass->location);
+        if (!point) {
+            point = gazetteer_.Locate(masterclass->description);
+        }
+        if (point) {
+            masterclass->latitude = point->latitude;
+            masterclass->longitude = point->longitude;
+        }
+        const auto hash =
+            static_cast<std::int64_t>(models::ContentHash(*masterclass));
+        rows.push_back(SourceRow{std::move(*masterclass), hash});
+    }
+
+    auto transaction = db_cluster_->Begin(
+        "mcsync", ClusterHostType::kMaster,
+        userver::storages::postgres::Transaction::RW, budget.Db());
+    // Две синхронизации сразу иначе удалили бы строки друг друга.
+    transaction.Execute(budget.Db(), sql::kLockMasterclassSync,
+                        std::string{"mcsync"});
+
+    std::unordered_map<std::int64_t, std::optional<std::int64_t>> current;
+    const auto hashes =
+        transaction.Execute(budget.Db(), sql::kSelectMasterclassSourceHashes);
+    for (const auto& row : hashes) {
+        current.emplace(row["id"].As<std::int64_t>(),
+                        row["source_hash"].As<std::optional<std::int64_t>>());
+    }
+
+    // Удаляются только строки, пришедшие из файла (source_hash не NULL):
+    // добавленные через /mcadd синхронизация не трогает.
+    std::size_t from_source = 0;
+    std::vector<std::int64_t> missing;
+    for (const auto& [id, hash] : current) {
+        if (!hash.has_value()) {
+            continue;
+        }
+        ++from_source;
+        if (!present.contains(id)) {
+            missing.push_back(id);
+        }
+    }
+    if (!allow_mass_delete && !missing.empty() &&
+        static_cast<double>(missing.size()) >
+            kMaxDeleteFraction * static_cast<double>(from_source)) {
+        transaction.Rollback();
+        LOG_WARNING() << "mcsync: refusing to delete " << missing.size()
+                      << " of " << from_source << " rows from the source";
+        userver::formats::json::ValueBuilder response;
+        response["status"] = "mass_delete";
+        response["deleted"] = missing.size();
+        response["from_source"] = from_source;
+        request.SetResponseStatus(
+            userver::server::http::HttpStatus::kConflict);
+        return budget.GetTrace().Respond(
+            userver::formats::json::ToString(response.ExtractValue()));
+    }
+
+    std::size_t inserted = 0;
+    std::size_t updated = 0;
+    std::size_t unchanged = 0;
+    std::vector<const SourceRow*> changed;
+    for (const auto& row : rows) {
+        const auto it = current.find(row.masterclass.id);
+        if (it != current.end() && it->second == row.hash) {
+            ++unchanged;
+            continue;
+        }
+        ++(it == current.end() ? inserted : updated);
+        changed.push_back(&row);
+    }
+
+    std::vector<models::Masterclass> upserts;
+    if (!dry_run) {
+        upserts.reserve(changed.size());
+        for (std::size_t begin = 0; begin < changed.size();
+             begin += kUpsertBatchSize) {
+            const UpsertBatch batch{std::span{changed}.subspan(
+                begin, std::min(kUpsertBatchSize, changed.size() - begin))};
+            const auto result = transaction.Execute(
+                budget.Db(), sql::kUpsertMasterclassesFromSourceBatch,
+                batch.id, batch.title, batch.location, batch.price,
+                batch.website, batch.image_url, batch.format, batch.company,
+                batch.category, batch.min_age, batch.rating, batch.description,
+                batch.event_date, batch.duration, batch.organizer,
+                batch.contact_tg, batch.contact_vk, batch.contact_phone,
+                batch.audience, batch.additional_tags, batch.latitude,
+                batch.longitude, batch.hash);
+            for (const auto& row : result) {
+                upserts.push_back(models::ParseMasterclassRow(row));
+            }
+        }
+    }
+
+    std::vector<std::int64_t> erased;
+    if (!dry_run && !missing.empty()) {
+        for (const auto& row :
+             transaction.Execute(budget.Db(),
+                                 sql::kDeleteMasterclassesFromSource,
+                                 missing)) {
+            erased.push_back(row[0].As<std::int64_t>());
+        }
+    }
+
+    if (dry_run) {
+        transaction.Rollback();
+    } else {
+        transaction.Commit();
+        catalog_.Apply(std::move(upserts), std::move(erased));
+    }
+    LOG_INFO() << "mcsync" << (dry_run ? " (dry run)" : "") << ": "
+               << inserted << " inserted, " << updated << " updated, "
+               << missing.size() << " deleted, " << unchanged
+               << " unchanged";
+
+    userver::formats::json::ValueBuilder response;
+    response["status"] = dry_run ? "dry_run" : "ok";
+    response["rows"] = parsed;
+    response["inserted"] = inserted;
+    response["updated"] = updated;
+    response["deleted"] = missing.size();
+    response["unchanged"] = unchanged;
+    response["past"] = past;
+    response["skipped"] = skipped;
+    request.SetResponseStatus(userver::server::http::HttpStatus::kOk);
+    return budget.GetTrace().Respond(
+        userver::formats::json::ToString(response.ExtractValue()));
+}
+
+}  // namespace masterclasses::handlers
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <string_view>
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/server/handlers/http_handler_base.hpp>
+#include <userver/server/http/http_response.hpp>
+#include <userver/server/request/request_context.hpp>
+#include <userver/storages/postgres/cluster.hpp>
+
+#include "components/admission_control.hpp"
+#include "components/gazetteer.hpp"
+#include "components/masterclass_catalog.hpp"
+#include "components/request_budgets.hpp"
+
+namespace masterclasses::handlers {
+
+/// POST /mcsync: тело - data.csv в раскладке scripts/import_data.py.
+/// Строки разбираются и нормализуются здесь же, по хешу содержимого
+/// сравниваются с source_hash в masterclasses, и в одной транзакции
+/// применяются только вставки, изменения и удаления. Записи в БД и
+/// инвалидации каталога - по числу изменений, а не по размеру файла.
+/// Удаление больше половины строк из файла - 409 без allow_mass_delete=1.
+class McSyncHandler final : public userver::server::handlers::HttpHandlerBase {
+  public:
+    static constexpr std::string_view kName = "handler-mcsync";
+
+    McSyncHandler(const userver::components::ComponentConfig& config,
+                  const userver::components::ComponentContext& context);
+
+    std::string HandleRequestThrow(
+        const userver::server::http::HttpRequest& request,
+        userver::server::request::RequestContext& context) const override;
+
+  private:
+    userver::storages::postgres::ClusterPtr db_cluster_;
+    components::MasterclassCatalog& catalog_;
+    components::AdmissionControl& admission_;
+    components::RequestBudgets& budgets_;
+    const components::Gazetteer& gazetteer_;
+};
+
+}  // namespace masterclasses::handlers
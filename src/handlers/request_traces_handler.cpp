@@ -0,0 +1,103 @@
+#include "handlers/request_traces_handler.hpp"
+
+#include <stdexcept>
+#include <string>
+
+#include <userver/formats/json/serialize.hpp>
+#include <userver/formats/json/value_builder.hpp>
+#include <userver/server/handlers/exceptions.hpp>
+
+namespace masterclasses::handlers {
+
+namespace {
+
+double ToMs(std::uint32_t micros) { return micros / 1000.0; }
+
+userver::formats::json::Value RenderSample(
+    const utils::TraceSample& sample) {
+    userver::formats::json::ValueBuilder item;
+    item["timestamp_ms"] = sample.timestamp_ms;
+    item["handler"] = std::string{utils::TraceSample::Text(sample.handler)};
+    item["args"] = std::string{utils::TraceSample::Text(sample.args)};
+    if (sample.failed) {
+        item["failed"] = true;
+    } else {
+        item["status"] = sample.status;
+    }
+    item["slow"] = sample.slow;
+    item["total_ms"] = ToMs(sample.total_micros);
+
+    userver::formats::json::ValueBuilder stages(
+        userver::formats::common::Type::kObject);
+    for (std::uint8_t i = 0; i < sample.stage_count; ++i) {
+        const auto& stage = sample.stages[i];
+        stages[std::string{utils::TraceSample::Text(stage.name)}] =
+            ToMs(stage.micros);
+    }
+    item["stages_ms"] = stages.ExtractValue();
+
+    item["db_round_trips"] = sample.db_round_trips;
+    userver::formats::json::ValueBuilder hosts(
+        userver::formats::common::Type::kArray);
+    if (sample.db_hosts & utils::TraceSample::kDbMaster) {
+        hosts.PushBack("master");
+    }
+    if (sample.db_hosts & utils::TraceSample::kDbReplica) {
+        hosts.PushBack("replica");
+    }
+    if (sample.db_hosts & utils::TraceSample::kDbHedge) {
+        hosts.PushBack("hedge");
+    }
+    item["db_hosts"] = hosts.ExtractValue();
+    item["response_bytes"] = sample.response_bytes;
+    return item.ExtractValue();
+}
+
+}  // namespace
+
+RequestTracesHandler::RequestTracesHandler(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : HttpHandlerBase(config, context, /*is_monitor=*/true),
+      traces_(context.FindComponent<components::RequestTraces>()) {}
+
+std::string RequestTracesHandler::HandleRequestThrow(
+    const userver::server::http::HttpRequest& request,
+    userver::server::request::RequestContext&) const {
+    request.GetHttpResponse().SetContentType(
+        userver::http::content_type::kApplicationJson);
+
+    const auto& handler = request.GetArg("handler");
+    const bool slow_only = request.GetArg("slow") == "1";
+    double min_ms = 0;
+    if (request.HasArg("min_ms")) {
+        try {
+            min_ms = std::stod(request.GetArg("min_ms"));
+        } catch (const std::exception&) {
+            throw userver::server::handlers::ClientError(
+                userver::server::handlers::ExternalBody{
+                    "invalid 'min_ms' parameter"});
+        }
+    }
+
+    userver::formats::json::ValueBuilder samples(
+        userver::formats::common::Type::kArray);
+    for (const auto& sample : traces_.Samples()) {
+        if ((!handler.empty() &&
+             utils::TraceSample::Text(sample.handler) != handler) ||
+            (slow_only && !sample.slow) ||
+            ToMs(sample.total_micros) < min_ms) {
+            continue;
+        }
+        samples.PushBack(RenderSample(sample));
+    }
+
+    userver::formats::json::ValueBuilder response;
+    response["capacity"] = traces_.Capacity();
+    response["recorded"] = traces_.Recorded();
+    response["dropped"] = traces_.Dropped();
+    response["samples"] = samples.ExtractValue();
+    return userver::formats::json::ToString(response.ExtractValue());
+}
+
+}  // namespace masterclasses::handlers
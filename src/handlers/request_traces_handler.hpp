@@ -0,0 +1,34 @@
+#pragma once
+
+#include <string_view>
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/server/handlers/http_handler_base.hpp>
+#include <userver/server/http/http_response.hpp>
+#include <userver/server/request/request_context.hpp>
+
+#include "components/request_traces.hpp"
+
+namespace masterclasses::handlers {
+
+/// GET /service/traces на порту мониторинга: образцы из кольца
+/// request-traces, от новых к старым. Фильтры: handler= (имя компонента
+/// хэндлера), slow=1, min_ms=.
+class RequestTracesHandler final
+    : public userver::server::handlers::HttpHandlerBase {
+  public:
+    static constexpr std::string_view kName = "handler-request-traces";
+
+    RequestTracesHandler(const userver::components::ComponentConfig& config,
+                         const userver::components::ComponentContext& context);
+
+    std::string HandleRequestThrow(
+        const userver::server::http::HttpRequest& request,
+        userver::server::request::RequestContext& context) const override;
+
+  private:
+    const components::RequestTraces& traces_;
+};
+
+}  // namespace masterclasses::handlers
@@ -0,0 +1,102 @@
+#include "handlers/suggest_handler.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <string>
+
+#include <userver/formats/common/type.hpp>
+#include <userver/formats/json/serialize.hpp>
+#include <userver/formats/json/value_builder.hpp>
+#include <userver/server/handlers/exceptions.hpp>
+
+namespace masterclasses::handlers {
+
+namespace {
+
+constexpr std::size_t kDefaultLimit = 10;
+constexpr std::size_t kMaxLimit = 20;
+
+/// Допустимое число опечаток растёт с длиной префикса: на двух-трёх
+/// буквах любая правка превращает подсказки в шум.
+std::uint32_t MaxEdits(std::size_t prefix_chars) {
+    if (prefix_chars < 3) {
+        return 0;
+    }
+    if (prefix_chars < 7) {
+        return 1;
+    }
+    return 2;
+}
+
+std::size_t CountUtf8Chars(const std::string& s) {
+    return static_cast<std::size_t>(
+        std::count_if(s.begin(), s.end(), [](char c) {
+            return (static_cast<unsigned char>(c) & 0xC0) != 0x80;
+        }));
+}
+
+}  // namespace
+
+SuggestHandler::SuggestHandler(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : HttpHandlerBase(config, context),
+      suggest_(context.FindComponent<components::CatalogSuggest>()),
+      traces_(context.FindComponent<components::RequestTraces>()) {}
+
+std::string SuggestHandler::HandleRequestThrow(
+    const userver::server::http::HttpRequest& request,
+    userver::server::request::RequestContext&) const {
+    request.GetHttpResponse().SetContentType(
+        userver::http::content_type::kApplicationJson);
+
+    // Без БД и бюджета, но в трассы запросов попадает.
+    components::RequestTraces::Trace trace(traces_, kName, request);
+
+    const auto& prefix = request.GetArg("prefix");
+    if (prefix.empty()) {
+        throw userver::server::handlers::ClientError(
+            userver::server::handlers::ExternalBody{
+                "query parameter 'prefix' is required"});
+    }
+
+    std::size_t limit = kDefaultLimit;
+    if (request.HasArg("n")) {
+        try {
+            limit = static_cast<std::size_t>(
+                std::clamp(std::stoll(request.GetArg("n")), 1LL,
+                           static_cast<long long>(kMaxLimit)));
+        } catch (const std::exception&) {
+            throw userver::server::handlers::ClientError(
+                userver::server::handlers::ExternalBody{
+                    "invalid 'n' parameter"});
+        }
+    }
+
+    userver::formats::json::ValueBuilder response;
+    response["prefix"] = prefix;
+    response["suggestions"] = userver::formats::json::ValueBuilder{
+        userver::formats::common::Type::kArray};
+
+    // Пока каталог не загружен, подсказок просто нет: ходить в Postgres на
+    // каждое нажатие клавиши мы не хотим.
+    const auto index = suggest_.GetIndex();
+    if (index) {
+        for (const auto& suggestion :
+             index->Lookup(prefix, limit, MaxEdits(CountUtf8Chars(prefix)))) {
+            userver::formats::json::ValueBuilder item;
+            item["text"] = suggestion.text;
+            item["kind"] =
+                std::string{catalog::SuggestIndex::KindName(suggestion.kind)};
+            item["weight"] = suggestion.weight;
+            item["edits"] = suggestion.edits;
+            response["suggestions"].PushBack(std::move(item));
+        }
+    }
+
+    return trace.Respond(
+        userver::formats::json::ToString(response.ExtractValue()));
+}
+
+}  // namespace masterclasses::handlers
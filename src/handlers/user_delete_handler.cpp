@@ -1,21 +1,18 @@
 #include "handlers/user_delete_handler.hpp"
-#include "sql/queries.hpp"
 
 #include <string>
 
 #include <userver/formats/json/value_builder.hpp>
 #include <userver/server/handlers/exceptions.hpp>
 #include <userver/server/http/http_method.hpp>
-#include <userver/storages/postgres/component.hpp>
 
 namespace masterclasses::handlers {
 
 namespace {
 
-using ClusterHostType = userver::storages::postgres::ClusterHostType;
-
-std::string ParseUserId(const userver::server::http::HttpRequest& request) {
-    const auto user_id = request.GetArg("user_id");
+std::string ParseUserId(const userver::server::http::HttpRequest& request,
+                        const components::SessionTokens& sessions) {
+    auto user_id = sessions.Authenticate(request, request.GetArg("user_id"));
     if (user_id.empty()) {
         throw userver::server::handlers::ClientError(
             userver::server::handlers::ExternalBody{
@@ -30,8 +27,10 @@ UserDeleteHandler::UserDeleteHandler(
     const userver::components::ComponentConfig& config,
     const userver::components::ComponentContext& context)
     : HttpHandlerBase(config, context),
-      db_cluster_(context.FindComponent<userver::components::Postgres>("app-db")
-                      .GetCluster()) {}
+      admission_(context.FindComponent<components::AdmissionControl>()),
+      budgets_(context.FindComponent<components::RequestBudgets>()),
+      sessions_(context.FindComponent<components::SessionTokens>()),
+      user_purge_(context.FindComponent<components::UserPurge>()) {}
 
 std::string UserDeleteHandler::HandleRequestThrow(
     const userver::server::http::HttpRequest& request,
@@ -39,29 +38,44 @@ std::string UserDeleteHandler::HandleRequestThrow(
     request.GetHttpResponse().SetContentType(
         userver::http::content_type::kApplicationJson);
 
+    const auto budget = budgets_.Start(kName, request);
+    const auto ticket = admission_.Admit(kName);
+    if (!ticket.Admitted()) {
+        return admission_.RenderRejection(request, ticket);
+    }
+
     if (request.GetMethod() != userver::server::http::HttpMethod::kDelete) {
         throw userver::server::handlers::ClientError(
             userver::server::handlers::ExternalBody{
                 "userdelete expects DELETE requests"});
     }
 
-    const auto user_id = ParseUserId(request);
+    const auto user_id = ParseUserId(request, sessions_);
 
-    const auto result = db_cluster_->Execute(ClusterHostType::kMaster,
-                                             sql::kDeleteUserRequests, user_id);
+    // Данные удаляет user-purge в фоне; здесь - только задача в очереди
+    // и отзыв токенов, чтобы аккаунтом сразу нельзя было пользоваться.
+    const auto job = user_purge_.Enqueue(user_id, budget.Db());
 
     userver::formats::json::ValueBuilder response;
     response["user_id"] = user_id;
 
-    if (result.RowsAffected() == 0) {
+    if (!job.has_value()) {
         request.SetResponseStatus(userver::server::http::HttpStatus::kNotFound);
         response["status"] = "not_found";
     } else {
-        request.SetResponseStatus(userver::server::http::HttpStatus::kOk);
-        response["status"] = "deleted";
+        sessions_.RevokeAll(user_id, budget.Db());
+        const auto status_url =
+            "/userdelete/status?job_id=" + std::to_string(job->id);
+        request.GetHttpResponse().SetHeader(std::string{"Location"},
+                                            status_url);
+        request.SetResponseStatus(userver::server::http::HttpStatus::kAccepted);
+        response["status"] = job->status;
+        response["job_id"] = job->id;
+        response["status_url"] = status_url;
     }
 
-    return userver::formats::json::ToString(response.ExtractValue());
+    return budget.GetTrace().Respond(
+        userver::formats::json::ToString(response.ExtractValue()));
 }
 
 }  // namespace masterclasses::handlers
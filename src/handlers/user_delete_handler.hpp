@@ -7,7 +7,11 @@
 #include <userver/server/handlers/http_handler_base.hpp>
 #include <userver/server/http/http_response.hpp>
 #include <userver/server/request/request_context.hpp>
-#include <userver/storages/postgres/cluster.hpp>
+
+#include "components/admission_control.hpp"
+#include "components/request_budgets.hpp"
+#include "components/session_tokens.hpp"
+#include "components/user_purge.hpp"
 
 namespace masterclasses::handlers {
 
@@ -24,7 +28,10 @@ class UserDeleteHandler final
         userver::server::request::RequestContext& context) const override;
 
   private:
-    userver::storages::postgres::ClusterPtr db_cluster_;
+    components::AdmissionControl& admission_;
+    components::RequestBudgets& budgets_;
+    components::SessionTokens& sessions_;
+    components::UserPurge& user_purge_;
 };
 
 }  // namespace masterclasses::handlers
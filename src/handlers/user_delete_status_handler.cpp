@@ -0,0 +1,95 @@
+#include "handlers/user_delete_status_handler.hpp"
+
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+
+#include <userver/formats/json/value_builder.hpp>
+#include <userver/server/handlers/exceptions.hpp>
+#include <userver/server/http/http_status.hpp>
+
+namespace masterclasses::handlers {
+
+namespace {
+
+std::int64_t ParseJobId(const userver::server::http::HttpRequest& request) {
+    const auto job_id_str = request.GetArg("job_id");
+    if (job_id_str.empty()) {
+        throw userver::server::handlers::ClientError(
+            userver::server::handlers::ExternalBody{
+                "query parameter 'job_id' is required"});
+    }
+
+    try {
+        return std::stoll(job_id_str);
+    } catch (const std::exception& ex) {
+        throw userver::server::handlers::ClientError(
+            userver::server::handlers::ExternalBody{
+                "invalid 'job_id' parameter: " + std::string{ex.what()}});
+    }
+}
+
+std::string ParseUserId(const userver::server::http::HttpRequest& request,
+                        const components::SessionTokens& sessions) {
+    // Токены отозваны ещё при постановке задачи, но статус своего удаления
+    // владелец узнать должен.
+    using RevokedTokens = components::SessionTokens::RevokedTokens;
+    auto user_id = sessions.Authenticate(request, request.GetArg("user_id"),
+                                         RevokedTokens::kAccept);
+    if (user_id.empty()) {
+        throw userver::server::handlers::ClientError(
+            userver::server::handlers::ExternalBody{
+                "query parameter 'user_id' is required"});
+    }
+    return user_id;
+}
+
+}  // namespace
+
+UserDeleteStatusHandler::UserDeleteStatusHandler(
+    const userver::components::ComponentConfig& config,
+    const userver::components::ComponentContext& context)
+    : HttpHandlerBase(config, context),
+      admission_(context.FindComponent<components::AdmissionControl>()),
+      budgets_(context.FindComponent<components::RequestBudgets>()),
+      sessions_(context.FindComponent<components::SessionTokens>()),
+      user_purge_(context.FindComponent<components::UserPurge>()) {}
+
+std::string UserDeleteStatusHandler::HandleRequestThrow(
+    const userver::server::http::HttpRequest& request,
+    userver::server::request::RequestContext&) const {
+    request.GetHttpResponse().SetContentType(
+        userver::http::content_type::kApplicationJson);
+
+    const auto budget = budgets_.Start(kName, request);
+    const auto ticket = admission_.Admit(kName);
+    if (!ticket.Admitted()) {
+        return admission_.RenderRejection(request, ticket);
+    }
+
+    const auto user_id = ParseUserId(request, sessions_);
+    const auto job_id = ParseJobId(request);
+    const auto job = user_purge_.Find(job_id, user_id, budget.Db());
+
+    userver::formats::json::ValueBuilder response;
+    response["job_id"] = job_id;
+
+    if (!job.has_value()) {
+        request.SetResponseStatus(userver::server::http::HttpStatus::kNotFound);
+        response["status"] = "not_found";
+        return userver::formats::json::ToString(response.ExtractValue());
+    }
+
+    response["status"] = job->status;
+    response["favorites_deleted"] = job->favorites_deleted;
+    response["attempts"] = job->attempts;
+    response["created_at"] = job->created_at;
+    if (job->finished_at.has_value()) {
+        response["finished_at"] = *job->finished_at;
+    }
+
+    return budget.GetTrace().Respond(
+        userver::formats::json::ToString(response.ExtractValue()));
+}
+
+}  // namespace masterclasses::handlers
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string_view>
+
+#include <userver/components/component_config.hpp>
+#include <userver/components/component_context.hpp>
+#include <userver/server/handlers/http_handler_base.hpp>
+#include <userver/server/http/http_response.hpp>
+#include <userver/server/request/request_context.hpp>
+
+#include "components/admission_control.hpp"
+#include "components/request_budgets.hpp"
+#include "components/session_tokens.hpp"
+#include "components/user_purge.hpp"
+
+namespace masterclasses::handlers {
+
+/// GET /userdelete/status?job_id= - ход фонового удаления аккаунта,
+/// поставленного через DELETE /userdelete. Только для владельца задачи:
+/// пользователь берётся из токена сессии, как в /userdelete.
+class UserDeleteStatusHandler final
+    : public userver::server::handlers::HttpHandlerBase {
+  public:
+    static constexpr std::string_view kName = "handler-userdelete-status";
+
+    UserDeleteStatusHandler(
+        const userver::components::ComponentConfig& config,
+        const userver::components::ComponentContext& context);
+
+    std::string HandleRequestThrow(
+        const userver::server::http::HttpRequest& request,
+        userver::server::request::RequestContext& context) const override;
+
+  private:
+    components::AdmissionControl& admission_;
+    components::RequestBudgets& budgets_;
+    const components::SessionTokens& sessions_;
+    components::UserPurge& user_purge_;
+};
+
+}  // namespace masterclasses::handlers
@@ -1,7 +1,19 @@
 #include "handlers/user_favorites_handler.hpp"
+#include "models/masterclass.hpp"
 #include "sql/queries.hpp"
+#include "utils/request_arena.hpp"
+#include "utils/response_format.hpp"
 
+#include <cstdint>
+#include <memory_resource>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <userver/engine/future.hpp>
 #include <userver/formats/json/serialize.hpp>
+#include <userver/formats/json/inline.hpp>
 #include <userver/formats/json/value_builder.hpp>
 #include <userver/server/handlers/exceptions.hpp>
 #include <userver/server/http/http_method.hpp>
@@ -13,6 +25,25 @@ namespace {
 
 using ClusterHostType = userver::storages::postgres::ClusterHostType;
 
+/// Ждёт коммита отложенной записи, но не дольше бюджета запроса. false -
+/// не дождались: операция остаётся в очереди и будет записана позже.
+bool WaitForFlush(userver::engine::Future<void> flushed,
+                  const components::RequestBudgets::Budget& budget) {
+    if (flushed.wait_until(budget.Deadline()) !=
+        userver::engine::FutureStatus::kReady) {
+        return false;
+    }
+    flushed.get();
+    return true;
+}
+
+/// 202: операция принята, но ещё не закоммичена.
+std::string RespondPending(const userver::server::http::HttpRequest& request) {
+    request.SetResponseStatus(userver::server::http::HttpStatus::kAccepted);
+    return userver::formats::json::ToString(
+        userver::formats::json::MakeObject("status", "pending"));
+}
+
 }  // namespace
 
 UserFavoritesHandler::UserFavoritesHandler(
@@ -20,7 +51,15 @@ UserFavoritesHandler::UserFavoritesHandler(
     const userver::components::ComponentContext& context)
     : HttpHandlerBase(config, context),
       db_cluster_(context.FindComponent<userver::components::Postgres>("app-db")
-                      .GetCluster()) {}
+                      .GetCluster()),
+      counters_(context.FindComponent<components::FavoriteCounters>()),
+      write_behind_(
+          context.FindComponent<components::FavoritesWriteBehind>()),
+      admission_(context.FindComponent<components::AdmissionControl>()),
+      budgets_(context.FindComponent<components::RequestBudgets>()),
+      sessions_(context.FindComponent<components::SessionTokens>()),
+      allocation_stats_(context.FindComponent<components::AllocationStats>()
+                            .ForHandler(kName)) {}
 
 std::string UserFavoritesHandler::HandleRequestThrow(
     const userver::server::http::HttpRequest& request,
@@ -28,72 +67,51 @@ std::string UserFavoritesHandler::HandleRequestThrow(
     request.GetHttpResponse().SetContentType(
         userver::http::content_type::kApplicationJson);
 
+    utils::RequestArena arena;
+    const components::AllocationStats::Scope allocations(allocation_stats_,
+                                                         arena);
+
+    const auto budget = budgets_.Start(kName, request);
+    const auto ticket = admission_.Admit(kName);
+    if (!ticket.Admitted()) {
+        return admission_.RenderRejection(request, ticket);
+    }
+
     if (request.GetMethod() == userver::server::http::HttpMethod::kGet) {
-        const auto user_id = request.GetArg("user_id");
+        const auto user_id =
+            sessions_.Authenticate(request, request.GetArg("user_id"));
         if (user_id.empty()) {
             throw userver::server::handlers::ClientError(
                 userver::server::handlers::ExternalBody{"missing user_id"});
         }
 
-        const auto fav_result = db_cluster_->Execute(
-            ClusterHostType::kMaster, sql::kSelectFavorites, user_id);
+        const auto fav_result =
+            db_cluster_->Execute(ClusterHostType::kMaster, budget.Db(),
+                                 sql::kSelectFavorites, user_id);
         std::vector<std::int64_t> ids;
         for (const auto& row : fav_result) {
             ids.push_back(row[0].As<std::int64_t>());
         }
-
-        if (ids.empty()) {
-            return userver::formats::json::ToString(
-                userver::formats::json::FromString("{\"masterclasses\": []}"));
+        if (write_behind_.Enabled()) {
+            write_behind_.OverlayPending(user_id, ids);
         }
 
-        const auto mc_result = db_cluster_->Execute(
-            ClusterHostType::kMaster, sql::kSelectMasterclassesByIds, ids);
-
-        userver::formats::json::ValueBuilder masterclasses_json(
-            userver::formats::json::Type::kArray);
-        for (const auto& row : mc_result) {
-            userver::formats::json::ValueBuilder entry;
-            entry["id"] = row["id"].As<std::int64_t>();
-            entry["title"] = row["title"].As<std::string>();
-            entry["location"] = row["location"].As<std::string>();
-            entry["price"] = row["price"].As<double>();
-            entry["website"] = row["website"].As<std::string>();
-            entry["image_url"] = row["image_url"].As<std::string>();
-            entry["format"] = row["format"].As<std::string>();
-            entry["company"] = row["company"].As<std::string>();
-            entry["category"] = row["category"].As<std::string>();
-            entry["min_age"] = row["min_age"].As<int>();
-            entry["rating"] = row["rating"].As<double>();
-
-            entry["description"] =
-                row["description"].As<std::optional<std::string>>().value_or(
-                    "");
-            entry["event_date"] =
-                row["event_date"].As<std::optional<std::string>>().value_or("");
-            entry["duration"] =
-                row["duration"].As<std::optional<std::string>>().value_or("");
-            entry["organizer"] =
-                row["organizer"].As<std::optional<std::string>>().value_or("");
-            entry["audience"] =
-                row["audience"].As<std::optional<std::string>>().value_or("");
-            entry["additional_tags"] = row["additional_tags"]
-                                           .As<std::optional<std::string>>()
-                                           .value_or("");
-            entry["contact_tg"] =
-                row["contact_tg"].As<std::optional<std::string>>().value_or("");
-            entry["contact_vk"] =
-                row["contact_vk"].As<std::optional<std::string>>().value_or("");
-            entry["contact_phone"] =
-                row["contact_phone"].As<std::optional<std::string>>().value_or(
-                    "");
-
-            masterclasses_json.PushBack(entry.ExtractValue());
+        std::vector<models::Masterclass> masterclasses;
+        std::pmr::vector<const models::Masterclass*> page(arena.Resource());
+        if (!ids.empty()) {
+            const auto mc_result =
+                db_cluster_->Execute(ClusterHostType::kMaster, budget.Db(),
+                                     sql::kSelectMasterclassesByIds, ids);
+            masterclasses.reserve(mc_result.Size());
+            page.reserve(mc_result.Size());
+            for (const auto& row : mc_result) {
+                page.push_back(&masterclasses.emplace_back(
+                    models::ParseMasterclassRow(row)));
+            }
         }
 
-        userver::formats::json::ValueBuilder response;
-        response["masterclasses"] = masterclasses_json.ExtractValue();
-        return userver::formats::json::ToString(response.ExtractValue());
+        return budget.GetTrace().Respond(utils::RenderMasterclassList(
+            request, page, userver::formats::json::MakeObject()));
 
     } else if (request.GetMethod() ==
                userver::server::http::HttpMethod::kPost) {
@@ -107,24 +125,40 @@ std::string UserFavoritesHandler::HandleRequestThrow(
                     std::string{"failed to parse JSON: "} + ex.what()});
         }
 
-        if (!payload.HasMember("user_id") ||
-            !payload.HasMember("masterclass_id")) {
+        auto user_id = sessions_.Authenticate(
+            request, payload["user_id"].As<std::string>(""));
+        if (user_id.empty() || !payload.HasMember("masterclass_id")) {
             throw userver::server::handlers::ClientError(
                 userver::server::handlers::ExternalBody{
                     "missing user_id or masterclass_id"});
         }
 
-        std::string user_id = payload["user_id"].As<std::string>();
         std::int64_t mc_id = payload["masterclass_id"].As<std::int64_t>();
 
-        db_cluster_->Execute(ClusterHostType::kMaster, sql::kInsertFavorite,
-                             user_id, mc_id);
+        if (write_behind_.Enabled()) {
+            // Ответ - после коммита пакета, в который попала операция.
+            if (!WaitForFlush(write_behind_.Enqueue(
+                                  std::move(user_id), mc_id,
+                                  components::FavoritesWriteBehind::Op::kAdd),
+                              budget)) {
+                return RespondPending(request);
+            }
+        } else {
+            const auto result =
+                db_cluster_->Execute(ClusterHostType::kMaster, budget.Db(),
+                                     sql::kInsertFavorite, user_id, mc_id);
+            // ON CONFLICT DO NOTHING: повторное добавление счётчик не трогает.
+            if (result.RowsAffected() > 0) {
+                counters_.Add(mc_id, 1);
+            }
+        }
         request.SetResponseStatus(userver::server::http::HttpStatus::kCreated);
         return "{}";
 
     } else if (request.GetMethod() ==
                userver::server::http::HttpMethod::kDelete) {
-        const auto user_id = request.GetArg("user_id");
+        const auto user_id =
+            sessions_.Authenticate(request, request.GetArg("user_id"));
         const auto mc_id_str = request.GetArg("masterclass_id");
         if (user_id.empty() || mc_id_str.empty()) {
             throw userver::server::handlers::ClientError(
@@ -133,8 +167,22 @@ std::string UserFavoritesHandler::HandleRequestThrow(
         }
 
         std::int64_t mc_id = std::stoll(mc_id_str);
-        db_cluster_->Execute(ClusterHostType::kMaster, sql::kDeleteFavorite,
-                             user_id, mc_id);
+        if (write_behind_.Enabled()) {
+            if (!WaitForFlush(
+                    write_behind_.Enqueue(
+                        user_id, mc_id,
+                        components::FavoritesWriteBehind::Op::kRemove),
+                    budget)) {
+                return RespondPending(request);
+            }
+        } else {
+            const auto result =
+                db_cluster_->Execute(ClusterHostType::kMaster, budget.Db(),
+                                     sql::kDeleteFavorite, user_id, mc_id);
+            if (result.RowsAffected() > 0) {
+                counters_.Add(mc_id, -1);
+            }
+        }
         return "{}";
     }
 
@@ -8,6 +8,13 @@
 #include <userver/server/handlers/http_handler_base.hpp>
 #include <userver/storages/postgres/cluster.hpp>
 
+#include "components/admission_control.hpp"
+#include "components/allocation_stats.hpp"
+#include "components/favorite_counters.hpp"
+#include "components/favorites_write_behind.hpp"
+#include "components/request_budgets.hpp"
+#include "components/session_tokens.hpp"
+
 namespace masterclasses::handlers {
 
 class UserFavoritesHandler final
@@ -24,6 +31,12 @@ class UserFavoritesHandler final
 
   private:
     userver::storages::postgres::ClusterPtr db_cluster_;
+    components::FavoriteCounters& counters_;
+    components::FavoritesWriteBehind& write_behind_;
+    components::AdmissionControl& admission_;
+    components::RequestBudgets& budgets_;
+    const components::SessionTokens& sessions_;
+    components::AllocationStats::HandlerStats& allocation_stats_;
 };
 
 }  // namespace masterclasses::handlers
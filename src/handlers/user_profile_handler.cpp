@@ -5,22 +5,17 @@
 #include <userver/formats/json/value_builder.hpp>
 #include <userver/server/handlers/exceptions.hpp>
 #include <userver/server/http/http_method.hpp>
-#include <userver/storages/postgres/component.hpp>
 
 namespace masterclasses::handlers {
 
-namespace {
-
-using ClusterHostType = userver::storages::postgres::ClusterHostType;
-
-}  // namespace
-
 UserProfileHandler::UserProfileHandler(
     const userver::components::ComponentConfig& config,
     const userver::components::ComponentContext& context)
     : HttpHandlerBase(config, context),
-      db_cluster_(context.FindComponent<userver::components::Postgres>("app-db")
-                      .GetCluster()) {}
+      admission_(context.FindComponent<components::AdmissionControl>()),
+      budgets_(context.FindComponent<components::RequestBudgets>()),
+      hedged_reads_(context.FindComponent<components::HedgedReads>()),
+      sessions_(context.FindComponent<components::SessionTokens>()) {}
 
 std::string UserProfileHandler::HandleRequestThrow(
     const userver::server::http::HttpRequest& request,
@@ -28,14 +23,21 @@ std::string UserProfileHandler::HandleRequestThrow(
     request.GetHttpResponse().SetContentType(
         userver::http::content_type::kApplicationJson);
 
-    const auto user_id = request.GetArg("user_id");
+    const auto budget = budgets_.Start(kName, request);
+    const auto ticket = admission_.Admit(kName);
+    if (!ticket.Admitted()) {
+        return admission_.RenderRejection(request, ticket);
+    }
+
+    const auto user_id =
+        sessions_.Authenticate(request, request.GetArg("user_id"));
     if (user_id.empty()) {
         throw userver::server::handlers::ClientError(
             userver::server::handlers::ExternalBody{"missing user_id"});
     }
 
-    const auto result = db_cluster_->Execute(ClusterHostType::kSlave,
-                                             sql::kSelectUserProfile, user_id);
+    const auto result =
+        hedged_reads_.Execute(budget.Db(), sql::kSelectUserProfile, user_id);
 
     if (result.IsEmpty()) {
         throw userver::server::handlers::ResourceNotFound(
@@ -50,7 +52,8 @@ std::string UserProfileHandler::HandleRequestThrow(
     response["telegram_nick"] =
         row["telegram_nick"].As<std::optional<std::string>>().value_or("");
 
-    return userver::formats::json::ToString(response.ExtractValue());
+    return budget.GetTrace().Respond(
+        userver::formats::json::ToString(response.ExtractValue()));
 }
 
 }  // namespace masterclasses::handlers
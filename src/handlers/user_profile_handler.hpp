@@ -6,7 +6,11 @@
 #include <userver/components/component_config.hpp>
 #include <userver/components/component_context.hpp>
 #include <userver/server/handlers/http_handler_base.hpp>
-#include <userver/storages/postgres/cluster.hpp>
+
+#include "components/admission_control.hpp"
+#include "components/hedged_reads.hpp"
+#include "components/request_budgets.hpp"
+#include "components/session_tokens.hpp"
 
 namespace masterclasses::handlers {
 
@@ -23,7 +27,10 @@ class UserProfileHandler final
         userver::server::request::RequestContext& context) const override;
 
   private:
-    userver::storages::postgres::ClusterPtr db_cluster_;
+    components::AdmissionControl& admission_;
+    components::RequestBudgets& budgets_;
+    components::HedgedReads& hedged_reads_;
+    const components::SessionTokens& sessions_;
 };
 
 }  // namespace masterclasses::handlers
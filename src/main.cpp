@@ -1,10 +1,33 @@
+#include "components/admission_control.hpp"
+#include "components/allocation_stats.hpp"
+#include "components/catalog_suggest.hpp"
+#include "components/event_archiver.hpp"
+#include "components/favorite_counters.hpp"
+#include "components/favorites_write_behind.hpp"
+#include "components/gazetteer.hpp"
+#include "components/hedged_reads.hpp"
+#include "components/masterclass_catalog.hpp"
+#include "components/password_hasher.hpp"
+#include "components/request_budgets.hpp"
+#include "components/request_traces.hpp"
+#include "components/seen_sets.hpp"
+#include "components/session_tokens.hpp"
+#include "components/user_purge.hpp"
 #include "handlers/auth_login_handler.hpp"
 #include "handlers/auth_register_handler.hpp"
 #include "handlers/mc_add_handler.hpp"
+#include "handlers/mc_changes_handler.hpp"
 #include "handlers/mc_delete_handler.hpp"
+#include "handlers/mc_export_handler.hpp"
+#include "handlers/mc_get_handler.hpp"
 #include "handlers/mc_list_handler.hpp"
+#include "handlers/mc_similar_handler.hpp"
+#include "handlers/mc_sync_handler.hpp"
 #include "handlers/ping_handler.hpp"
+#include "handlers/request_traces_handler.hpp"
+#include "handlers/suggest_handler.hpp"
 #include "handlers/user_delete_handler.hpp"
+#include "handlers/user_delete_status_handler.hpp"
 #include "handlers/user_favorites_handler.hpp"
 #include "handlers/user_profile_handler.hpp"
 
@@ -15,6 +38,8 @@
 #include <userver/components/fs_cache.hpp>
 #include <userver/components/minimal_server_component_list.hpp>
 #include <userver/server/handlers/http_handler_static.hpp>
+#include <userver/server/handlers/server_monitor.hpp>
+#include <userver/server/handlers/tests_control.hpp>
 #include <userver/storages/postgres/component.hpp>
 #include <userver/storages/secdist/component.hpp>
 #include <userver/storages/secdist/provider_component.hpp>
@@ -32,17 +57,42 @@ int main(int argc, char* argv[]) {
             .Append<userver::components::HttpClient>()
             .Append<userver::clients::dns::Component>()
             .Append<userver::components::Postgres>("app-db")
+            .Append<masterclasses::components::AdmissionControl>()
+            .Append<masterclasses::components::AllocationStats>()
+            .Append<masterclasses::components::RequestTraces>()
+            .Append<masterclasses::components::RequestBudgets>()
+            .Append<masterclasses::components::HedgedReads>()
+            .Append<masterclasses::components::SessionTokens>()
+            .Append<masterclasses::components::PasswordHasher>()
+            .Append<masterclasses::components::MasterclassCatalog>()
+            .Append<masterclasses::components::EventArchiver>()
+            .Append<masterclasses::components::SeenSets>()
+            .Append<masterclasses::components::CatalogSuggest>()
+            .Append<masterclasses::components::FavoriteCounters>()
+            .Append<masterclasses::components::UserPurge>()
+            .Append<masterclasses::components::FavoritesWriteBehind>()
+            .Append<masterclasses::components::Gazetteer>()
             .Append<masterclasses::handlers::PingHandler>()
+            .Append<masterclasses::handlers::RequestTracesHandler>()
             .Append<masterclasses::handlers::McListHandler>()
+            .Append<masterclasses::handlers::McChangesHandler>()
             .Append<masterclasses::handlers::McAddHandler>()
             .Append<masterclasses::handlers::McDeleteHandler>()
+            .Append<masterclasses::handlers::McSimilarHandler>()
+            .Append<masterclasses::handlers::McExportHandler>()
+            .Append<masterclasses::handlers::McGetHandler>()
+            .Append<masterclasses::handlers::McSyncHandler>()
             .Append<masterclasses::handlers::AuthRegisterHandler>()
             .Append<masterclasses::handlers::AuthLoginHandler>()
             .Append<masterclasses::handlers::UserDeleteHandler>()
+            .Append<masterclasses::handlers::UserDeleteStatusHandler>()
             .Append<masterclasses::handlers::UserProfileHandler>()
             .Append<masterclasses::handlers::UserFavoritesHandler>()
+            .Append<masterclasses::handlers::SuggestHandler>()
             .Append<userver::components::FsCache>("fs-cache-component")
-            .Append<userver::server::handlers::HttpHandlerStatic>();
+            .Append<userver::server::handlers::HttpHandlerStatic>()
+            .Append<userver::server::handlers::ServerMonitor>()
+            .Append<userver::server::handlers::TestsControl>();
 
     return userver::utils::DaemonMain(argc, argv, component_list);
 }
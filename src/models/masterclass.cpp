@@ -0,0 +1,59 @@
+#include "models/masterclass.hpp"
+
+#include <optional>
+
+#include <userver/formats/json/value_builder.hpp>
+#include <userver/formats/serialize/common_containers.hpp>
+
+namespace masterclasses::models {
+
+namespace {
+
+std::string OptionalString(const userver::storages::postgres::Row& row,
+                           std::string_view column,
+                           std::string_view default_value = {}) {
+    return row[std::string{column}]
+        .As<std::optional<std::string>>()
+        .value_or(std::string{default_value});
+}
+
+}  // namespace
+
+Masterclass ParseMasterclassRow(const userver::storages::postgres::Row& row) {
+    Masterclass mc;
+    mc.id = row["id"].As<std::int64_t>();
+    mc.title = row["title"].As<std::string>();
+    mc.location = row["location"].As<std::string>();
+    mc.price = row["price"].As<double>();
+    mc.website = row["website"].As<std::string>();
+    mc.image_url = row["image_url"].As<std::string>();
+
+    mc.format = OptionalString(row, "format", "offline");
+    mc.company = OptionalString(row, "company", "single");
+    mc.category = OptionalString(row, "category");
+    mc.min_age = row["min_age"].As<std::optional<int>>().value_or(0);
+    mc.rating = row["rating"].As<std::optional<double>>().value_or(5.0);
+
+    mc.description = OptionalString(row, "description");
+    mc.event_date = OptionalString(row, "event_date");
+    mc.duration = OptionalString(row, "duration");
+    mc.organizer = OptionalString(row, "organizer");
+    mc.audience = OptionalString(row, "audience");
+    mc.additional_tags = OptionalString(row, "additional_tags");
+    mc.contact_tg = OptionalString(row, "contact_tg");
+    mc.contact_vk = OptionalString(row, "contact_vk");
+    mc.contact_phone = OptionalString(row, "contact_phone");
+    mc.latitude = row["latitude"].As<std::optional<double>>();
+    mc.longitude = row["longitude"].As<std::optional<double>>();
+    return mc;
+}
+
+userver::formats::json::Value ToJson(const Masterclass& masterclass) {
+    userver::formats::json::ValueBuilder entry;
+    VisitMasterclassFields([&](std::string_view name, auto field) {
+        entry[std::string{name}] = masterclass.*field;
+    });
+    return entry.ExtractValue();
+}
+
+}  // namespace masterclasses::models
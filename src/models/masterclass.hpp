@@ -0,0 +1,76 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <userver/formats/json/value.hpp>
+#include <userver/storages/postgres/result_set.hpp>
+
+namespace masterclasses::models {
+
+/// Строка таблицы masterclasses в том виде, в котором её отдаёт API.
+struct Masterclass {
+    std::int64_t id{0};
+    std::string title;
+    std::string location;
+    double price{0.0};
+    std::string website;
+    std::string image_url;
+    std::string format;
+    std::string company;
+    std::string category;
+    int min_age{0};
+    double rating{5.0};
+    std::string description;
+    std::string event_date;
+    std::string duration;
+    std::string organizer;
+    std::string audience;
+    std::string additional_tags;
+    std::string contact_tg;
+    std::string contact_vk;
+    std::string contact_phone;
+    /// Координаты места; заполняются при добавлении по газеттиру, если их
+    /// не передали явно.
+    std::optional<double> latitude;
+    std::optional<double> longitude;
+
+    bool operator==(const Masterclass& other) const = default;
+};
+
+/// Обходит поля в порядке выдачи API: visitor(name, &Masterclass::field).
+template <typename Visitor>
+void VisitMasterclassFields(Visitor&& visitor) {
+    visitor(std::string_view{"id"}, &Masterclass::id);
+    visitor(std::string_view{"title"}, &Masterclass::title);
+    visitor(std::string_view{"location"}, &Masterclass::location);
+    visitor(std::string_view{"price"}, &Masterclass::price);
+    visitor(std::string_view{"website"}, &Masterclass::website);
+    visitor(std::string_view{"image_url"}, &Masterclass::image_url);
+    visitor(std::string_view{"format"}, &Masterclass::format);
+    visitor(std::string_view{"company"}, &Masterclass::company);
+    visitor(std::string_view{"category"}, &Masterclass::category);
+    visitor(std::string_view{"min_age"}, &Masterclass::min_age);
+    visitor(std::string_view{"rating"}, &Masterclass::rating);
+    visitor(std::string_view{"description"}, &Masterclass::description);
+    visitor(std::string_view{"event_date"}, &Masterclass::event_date);
+    visitor(std::string_view{"duration"}, &Masterclass::duration);
+    visitor(std::string_view{"organizer"}, &Masterclass::organizer);
+    visitor(std::string_view{"audience"}, &Masterclass::audience);
+    visitor(std::string_view{"additional_tags"},
+            &Masterclass::additional_tags);
+    visitor(std::string_view{"contact_tg"}, &Masterclass::contact_tg);
+    visitor(std::string_view{"contact_vk"}, &Masterclass::contact_vk);
+    visitor(std::string_view{"contact_phone"}, &Masterclass::contact_phone);
+    visitor(std::string_view{"latitude"}, &Masterclass::latitude);
+    visitor(std::string_view{"longitude"}, &Masterclass::longitude);
+}
+
+/// Разбор строки из select_masterclasses_*.sql; NULL заменяется дефолтами API.
+Masterclass ParseMasterclassRow(const userver::storages::postgres::Row& row);
+
+userver::formats::json::Value ToJson(const Masterclass& masterclass);
+
+}  // namespace masterclasses::models
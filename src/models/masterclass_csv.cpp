@@ -0,0 +1,210 @@
+#include "models/masterclass_csv.hpp"
+
+#include <array>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <stdexcept>
+#include <string_view>
+#include <type_traits>
+
+namespace masterclasses::models {
+
+namespace {
+
+constexpr std::size_t kRequiredColumns = 11;
+constexpr std::string_view kPlaceholderImage =
+    "https://via.placeholder.com/150";
+
+std::string_view Trim(std::string_view value) {
+    while (!value.empty() &&
+           std::isspace(static_cast<unsigned char>(value.front()))) {
+        value.remove_prefix(1);
+    }
+    while (!value.empty() &&
+           std::isspace(static_cast<unsigned char>(value.back()))) {
+        value.remove_suffix(1);
+    }
+    return value;
+}
+
+bool IsDigit(char c) { return c >= '0' && c <= '9'; }
+
+/// Первое число после удаления пробелов и неразрывных пробелов:
+/// "от 1 500 ₽" -> 1500.
+double ParsePrice(std::string_view raw) {
+    std::string compact;
+    compact.reserve(raw.size());
+    for (std::size_t i = 0; i < raw.size(); ++i) {
+        if (raw[i] == ' ') {
+            continue;
+        }
+        if (raw.substr(i, 2) == "\xC2\xA0") {
+            ++i;
+            continue;
+        }
+        compact += raw[i];
+    }
+    std::size_t begin = 0;
+    while (begin < compact.size() && !IsDigit(compact[begin])) {
+        ++begin;
+    }
+    std::size_t end = begin;
+    while (end < compact.size() && IsDigit(compact[end])) {
+        ++end;
+    }
+    double price = 0.0;
+    std::from_chars(compact.data() + begin, compact.data() + end, price);
+    return price;
+}
+
+/// "d.m.yyyy" -> "yyyy-mm-dd"; пусто, если формат или дата неверны.
+std::string ParseDate(std::string_view raw) {
+    int parts[3] = {0, 0, 0};
+    std::size_t digits[3] = {0, 0, 0};
+    std::size_t part = 0;
+    for (const char c : raw) {
+        if (c == '.' && part < 2) {
+            ++part;
+        } else if (IsDigit(c) && digits[part] < 4) {
+            parts[part] = parts[part] * 10 + (c - '0');
+            ++digits[part];
+        } else {
+            return {};
+        }
+    }
+    const auto [day, month, year] = parts;
+    if (part != 2 || digits[0] == 0 || digits[0] > 2 || digits[1] == 0 ||
+        digits[1] > 2 || digits[2] != 4 || month < 1 || month > 12 ||
+        day < 1) {
+        return {};
+    }
+    static constexpr int kDaysInMonth[] = {31, 29, 31, 30, 31, 30,
+                                           31, 31, 30, 31, 30, 31};
+    const bool leap = (year % 4 == 0 && year % 100 != 0) || year % 400 == 0;
+    if (day > kDaysInMonth[month - 1] || (month == 2 && day == 29 && !leap)) {
+        return {};
+    }
+    std::string date(10, '0');
+    const auto put = [&date](std::size_t pos, std::size_t len, int value) {
+        for (std::size_t i = pos + len; i-- > pos;) {
+            date[i] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        }
+    };
+    put(0, 4, year);
+    date[4] = '-';
+    put(5, 2, month);
+    date[7] = '-';
+    put(8, 2, day);
+    return date;
+}
+
+std::string FirstImageUrl(std::string_view raw) {
+    const auto image = Trim(raw.substr(0, raw.find(',')));
+    return std::string{image.empty() ? kPlaceholderImage : image};
+}
+
+std::string WebsiteUrl(std::string_view raw) {
+    const auto website = Trim(raw);
+    if (website.empty() || website.starts_with("http://") ||
+        website.starts_with("https://")) {
+        return std::string{website};
+    }
+    return "https://" + std::string{website};
+}
+
+std::optional<std::int64_t> ParseId(std::string_view raw) {
+    raw = Trim(raw);
+    std::int64_t id = 0;
+    const auto [end, error] =
+        std::from_chars(raw.data(), raw.data() + raw.size(), id);
+    if (error != std::errc{} || end != raw.data() + raw.size() || id <= 0) {
+        return std::nullopt;
+    }
+    return id;
+}
+
+class Fnv1a {
+  public:
+    void Add(std::string_view bytes) {
+        for (const char c : bytes) {
+            hash_ = (hash_ ^ static_cast<unsigned char>(c)) * kPrime;
+        }
+        // Разделитель, чтобы ("ab", "c") и ("a", "bc") различались.
+        hash_ = (hash_ ^ 0x1F) * kPrime;
+    }
+
+    template <typename T>
+    void AddValue(const T& value) {
+        const auto bytes = std::bit_cast<std::array<char, sizeof(T)>>(value);
+        Add({bytes.data(), bytes.size()});
+    }
+
+    std::uint64_t Hash() const { return hash_; }
+
+  private:
+    static constexpr std::uint64_t kPrime = 1099511628211ULL;
+    std::uint64_t hash_{14695981039346656037ULL};
+};
+
+}  // namespace
+
+std::optional<Masterclass> ParseCsvMasterclass(
+    const std::vector<std::string>& fields) {
+    if (fields.size() < kRequiredColumns || Trim(fields[1]).empty()) {
+        return std::nullopt;
+    }
+    const auto optional_field = [&fields](std::size_t index) {
+        return index < fields.size() ? fields[index] : std::string{};
+    };
+
+    const auto id = ParseId(fields[0]);
+    if (!id) {
+        throw std::invalid_argument("id must be a positive integer, got '" +
+                                    fields[0] + "'");
+    }
+
+    Masterclass masterclass;
+    masterclass.id = *id;
+    masterclass.title = fields[1];
+    masterclass.description = fields[2];
+    masterclass.price = ParsePrice(fields[3]);
+    masterclass.event_date = ParseDate(fields[4]);
+    masterclass.category = fields[5];
+    masterclass.duration = fields[6];
+    masterclass.audience = fields[7];
+    masterclass.image_url = FirstImageUrl(fields[8]);
+    masterclass.additional_tags = fields[9];
+    masterclass.organizer = fields[10];
+    masterclass.website = WebsiteUrl(optional_field(11));
+    masterclass.contact_tg = optional_field(12);
+    masterclass.contact_vk = optional_field(13);
+    masterclass.contact_phone = optional_field(14);
+    masterclass.location =
+        masterclass.organizer.empty() ? "Moscow" : masterclass.organizer;
+    masterclass.format = "offline";
+    masterclass.company = "single";
+    masterclass.min_age = 0;
+    masterclass.rating = 5.0;
+    return masterclass;
+}
+
+std::uint64_t ContentHash(const Masterclass& masterclass) {
+    Fnv1a hash;
+    VisitMasterclassFields([&](std::string_view, auto field) {
+        const auto& value = masterclass.*field;
+        using T = std::decay_t<decltype(value)>;
+        if constexpr (std::is_same_v<T, std::string>) {
+            hash.Add(value);
+        } else if constexpr (std::is_same_v<T, std::optional<double>>) {
+            hash.AddValue(value.has_value());
+            hash.AddValue(value.value_or(0.0));
+        } else {
+            hash.AddValue(value);
+        }
+    });
+    return hash.Hash();
+}
+
+}  // namespace masterclasses::models
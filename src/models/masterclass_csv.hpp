@@ -0,0 +1,27 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <vector>
+
+#include "models/masterclass.hpp"
+
+namespace masterclasses::models {
+
+/// Запись data.csv в раскладке scripts/import_data.py -> мастер-класс с
+/// теми же нормализациями: цена - первое число без пробелов, дата из
+/// dd.mm.yyyy (иначе без даты), первая ссылка на картинку, https:// к сайту
+/// без схемы, location = organizer или "Moscow". id - первая колонка;
+/// если это не положительное число, бросает std::invalid_argument: id
+/// по номеру строки менялся бы от вставки строки в середину файла.
+/// nullopt для записи без обязательных колонок или без названия.
+/// Координаты не заполняются.
+std::optional<Masterclass> ParseCsvMasterclass(
+    const std::vector<std::string>& fields);
+
+/// Хеш всех полей мастер-класса (FNV-1a 64): по нему синхронизация
+/// отличает изменившиеся строки от неизменных.
+std::uint64_t ContentHash(const Masterclass& masterclass);
+
+}  // namespace masterclasses::models
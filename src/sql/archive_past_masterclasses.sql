@@ -0,0 +1,23 @@
+WITH expired AS (
+    SELECT id FROM masterclasses
+    WHERE event_date < $1::date
+    ORDER BY event_date, id
+    LIMIT $2
+    FOR UPDATE SKIP LOCKED
+), moved AS (
+    DELETE FROM masterclasses
+    USING expired
+    WHERE masterclasses.id = expired.id
+    RETURNING masterclasses.*
+), archived AS (
+    INSERT INTO masterclasses_archive
+      (id, title, location, price, website, image_url, format, company, category, min_age, rating,
+       description, event_date, duration, organizer, contact_tg, contact_vk, contact_phone, audience, additional_tags,
+       latitude, longitude, source_hash, created_at)
+    SELECT id, title, location, price, website, image_url, format, company, category, min_age, rating,
+           description, event_date, duration, organizer, contact_tg, contact_vk, contact_phone, audience, additional_tags,
+           latitude, longitude, source_hash, created_at
+    FROM moved
+    ON CONFLICT (id) DO NOTHING
+)
+SELECT id FROM moved
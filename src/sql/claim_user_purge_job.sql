@@ -0,0 +1,11 @@
+UPDATE user_purge_jobs
+SET status = 'running', attempts = attempts + 1, updated_at = NOW()
+WHERE id = (
+    SELECT id FROM user_purge_jobs
+    WHERE status = 'pending'
+       OR (status = 'running' AND updated_at < NOW() - make_interval(secs => $1))
+    ORDER BY id
+    LIMIT 1
+    FOR UPDATE SKIP LOCKED
+)
+RETURNING id, user_id
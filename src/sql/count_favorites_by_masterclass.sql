@@ -0,0 +1,3 @@
+SELECT masterclass_id, COUNT(*)::BIGINT AS favorites
+FROM user_favorites
+GROUP BY masterclass_id
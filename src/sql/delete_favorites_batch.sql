@@ -0,0 +1,5 @@
+DELETE FROM user_favorites
+WHERE (user_id, masterclass_id) IN (
+    SELECT * FROM UNNEST($1::TEXT[], $2::BIGINT[])
+)
+RETURNING masterclass_id
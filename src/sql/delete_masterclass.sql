@@ -1 +1,10 @@
-DELETE FROM masterclasses WHERE id = $1
+WITH favorites AS (
+    DELETE FROM user_favorites WHERE masterclass_id = $1
+), archived AS (
+    DELETE FROM masterclasses_archive WHERE id = $1 RETURNING id
+), live AS (
+    DELETE FROM masterclasses WHERE id = $1 RETURNING id
+)
+SELECT id FROM live
+UNION ALL
+SELECT id FROM archived
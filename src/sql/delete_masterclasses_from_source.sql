@@ -0,0 +1,8 @@
+WITH removed AS (
+    DELETE FROM masterclasses
+    WHERE id = ANY($1) AND source_hash IS NOT NULL
+    RETURNING id
+), favorites AS (
+    DELETE FROM user_favorites WHERE masterclass_id IN (SELECT id FROM removed)
+)
+SELECT id FROM removed
@@ -0,0 +1,6 @@
+DELETE FROM user_favorites
+WHERE user_id = $1
+  AND masterclass_id IN (
+    SELECT masterclass_id FROM user_favorites WHERE user_id = $1 LIMIT $2
+  )
+RETURNING masterclass_id
@@ -1 +0,0 @@
-DELETE FROM user_requests WHERE user_id = $1
@@ -0,0 +1,14 @@
+WITH active AS (
+    SELECT id, status FROM user_purge_jobs
+    WHERE user_id = $1 AND status IN ('pending', 'running')
+), inserted AS (
+    INSERT INTO user_purge_jobs (user_id)
+    SELECT $1
+    WHERE EXISTS (SELECT 1 FROM users WHERE id = $1)
+      AND NOT EXISTS (SELECT 1 FROM active)
+    ON CONFLICT DO NOTHING
+    RETURNING id, status
+)
+SELECT id, status FROM inserted
+UNION ALL
+SELECT id, status FROM active
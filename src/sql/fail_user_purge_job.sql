@@ -0,0 +1,6 @@
+UPDATE user_purge_jobs
+SET status = CASE WHEN attempts >= $3 THEN 'failed' ELSE 'pending' END,
+    last_error = $2,
+    updated_at = NOW(),
+    finished_at = CASE WHEN attempts >= $3 THEN NOW() END
+WHERE id = $1
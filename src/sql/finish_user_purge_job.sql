@@ -0,0 +1,6 @@
+WITH removed AS (
+    DELETE FROM users WHERE id = $2
+)
+UPDATE user_purge_jobs
+SET status = 'done', updated_at = NOW(), finished_at = NOW(), last_error = NULL
+WHERE id = $1
@@ -1,3 +1,3 @@
 INSERT INTO user_favorites (user_id, masterclass_id)
-VALUES ($1, $2)
+SELECT $1, id FROM masterclasses WHERE id = $2
 ON CONFLICT DO NOTHING
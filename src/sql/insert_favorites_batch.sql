@@ -0,0 +1,7 @@
+INSERT INTO user_favorites (user_id, masterclass_id)
+SELECT batch.user_id, batch.masterclass_id
+FROM UNNEST($1::TEXT[], $2::BIGINT[]) AS batch (user_id, masterclass_id)
+JOIN users ON users.id = batch.user_id
+JOIN masterclasses ON masterclasses.id = batch.masterclass_id
+ON CONFLICT DO NOTHING
+RETURNING masterclass_id
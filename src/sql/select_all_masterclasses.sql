@@ -0,0 +1,5 @@
+SELECT id, title, location, price, website, image_url, format, company, category, min_age, rating,
+       description, event_date::text, duration, organizer, contact_tg, contact_vk, contact_phone, audience, additional_tags,
+       latitude, longitude
+FROM masterclasses
+ORDER BY id ASC
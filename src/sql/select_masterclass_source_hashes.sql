@@ -0,0 +1 @@
+SELECT id, source_hash FROM masterclasses
@@ -1,4 +1,5 @@
 SELECT id, title, location, price, website, image_url, format, company, category, min_age, rating,
-       description, event_date::text, duration, organizer, contact_tg, contact_vk, contact_phone, audience, additional_tags
-FROM masterclasses
+       description, event_date::text, duration, organizer, contact_tg, contact_vk, contact_phone, audience, additional_tags,
+       latitude, longitude
+FROM masterclasses_with_archive
 WHERE id = ANY($1)
@@ -1,5 +1,6 @@
 SELECT id, title, location, price, website, image_url, format, company, category, min_age, rating,
-       description, event_date::text, duration, organizer, contact_tg, contact_vk, contact_phone, audience, additional_tags
+       description, event_date::text, duration, organizer, contact_tg, contact_vk, contact_phone, audience, additional_tags,
+       latitude, longitude
 FROM masterclasses
 WHERE ($1::text IS NULL OR category ~* replace($1, ',', '|'))
   AND ($2::text IS NULL OR audience ~* replace($2, ',', '|'))
@@ -13,4 +14,5 @@ WHERE ($1::text IS NULL OR category ~* replace($1, ',', '|'))
   AND ($10::bigint[] IS NULL OR id <> ALL($10))
   AND ($11::date IS NULL OR (event_date IS NOT NULL AND event_date >= $11::date))
   AND ($12::date IS NULL OR (event_date IS NOT NULL AND event_date <= $12::date))
+  AND (event_date IS NULL OR event_date >= $15::date)
 ORDER BY event_date DESC, id ASC LIMIT $13 OFFSET $14
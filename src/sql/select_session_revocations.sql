@@ -0,0 +1,3 @@
+SELECT user_id, EXTRACT(EPOCH FROM revoked_before)::BIGINT AS revoked_before
+FROM session_revocations
+WHERE revoked_before > NOW() - make_interval(secs => $1)
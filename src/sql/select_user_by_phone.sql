@@ -1,3 +1,7 @@
 SELECT id, password_hash, full_name, telegram_nick
 FROM users
 WHERE regexp_replace(phone, '[^0-9]', '', 'g') = $1
+  AND NOT EXISTS (
+      SELECT 1 FROM user_purge_jobs
+      WHERE user_purge_jobs.user_id = users.id AND status IN ('pending', 'running')
+  )
@@ -0,0 +1,5 @@
+SELECT id, status, favorites_deleted, attempts,
+       EXTRACT(EPOCH FROM created_at)::BIGINT AS created_at,
+       EXTRACT(EPOCH FROM finished_at)::BIGINT AS finished_at
+FROM user_purge_jobs
+WHERE id = $1 AND user_id = $2
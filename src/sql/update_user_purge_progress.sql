@@ -0,0 +1,3 @@
+UPDATE user_purge_jobs
+SET favorites_deleted = favorites_deleted + $2, updated_at = NOW()
+WHERE id = $1
@@ -0,0 +1,31 @@
+WITH batch AS (
+    SELECT * FROM UNNEST(
+        $1::BIGINT[], $2::TEXT[], $3::TEXT[], $4::FLOAT8[], $5::TEXT[], $6::TEXT[], $7::TEXT[], $8::TEXT[],
+        $9::TEXT[], $10::INT[], $11::FLOAT8[], $12::TEXT[], $13::TEXT[], $14::TEXT[], $15::TEXT[], $16::TEXT[],
+        $17::TEXT[], $18::TEXT[], $19::TEXT[], $20::TEXT[], $21::FLOAT8[], $22::FLOAT8[], $23::BIGINT[]
+    ) AS batch (id, title, location, price, website, image_url, format, company, category, min_age, rating,
+                description, event_date, duration, organizer, contact_tg, contact_vk, contact_phone, audience,
+                additional_tags, latitude, longitude, source_hash)
+), unarchived AS (
+    DELETE FROM masterclasses_archive WHERE id IN (SELECT id FROM batch)
+)
+INSERT INTO masterclasses
+  (id, title, location, price, website, image_url, format, company, category, min_age, rating,
+   description, event_date, duration, organizer, contact_tg, contact_vk, contact_phone, audience, additional_tags,
+   latitude, longitude, source_hash)
+SELECT id, title, location, price, website, image_url, format, company, category, min_age, rating,
+       description, NULLIF(event_date, '')::date, duration, organizer, contact_tg, contact_vk, contact_phone,
+       audience, additional_tags, NULLIF(latitude, 'NaN'::float8), NULLIF(longitude, 'NaN'::float8), source_hash
+FROM batch
+ON CONFLICT (id) DO UPDATE SET
+  title = EXCLUDED.title, location = EXCLUDED.location, price = EXCLUDED.price, website = EXCLUDED.website,
+  image_url = EXCLUDED.image_url, format = EXCLUDED.format, company = EXCLUDED.company,
+  category = EXCLUDED.category, min_age = EXCLUDED.min_age, rating = EXCLUDED.rating,
+  description = EXCLUDED.description, event_date = EXCLUDED.event_date, duration = EXCLUDED.duration,
+  organizer = EXCLUDED.organizer, contact_tg = EXCLUDED.contact_tg, contact_vk = EXCLUDED.contact_vk,
+  contact_phone = EXCLUDED.contact_phone, audience = EXCLUDED.audience,
+  additional_tags = EXCLUDED.additional_tags, latitude = EXCLUDED.latitude, longitude = EXCLUDED.longitude,
+  source_hash = EXCLUDED.source_hash
+RETURNING id, title, location, price, website, image_url, format, company, category, min_age, rating,
+          description, event_date::text, duration, organizer, contact_tg, contact_vk, contact_phone, audience, additional_tags,
+          latitude, longitude
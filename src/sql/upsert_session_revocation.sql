@@ -0,0 +1,3 @@
+INSERT INTO session_revocations (user_id, revoked_before)
+VALUES ($1, to_timestamp($2))
+ON CONFLICT (user_id) DO UPDATE SET revoked_before = EXCLUDED.revoked_before
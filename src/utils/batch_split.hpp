@@ -0,0 +1,35 @@
+#pragma once
+
+#include <exception>
+#include <span>
+
+namespace masterclasses::utils {
+
+/// Пишет `batch` одним вызовом write(span). Если тот бросил и
+/// splittable(ex) - true, половины пишутся заново тем же способом, пока
+/// ошибка не останется на одиночных элементах. Часть пакета, которая так и
+/// не записалась, уходит в fail(span, ex) - по вызову на каждую неудачную
+/// часть, внутри catch, так что std::current_exception() в fail - это
+/// ошибка write. Исключения не из std::exception не ловятся.
+template <typename T, typename Write, typename Splittable, typename Fail>
+void WriteOrSplit(std::span<T> batch, Write&& write, Splittable&& splittable,
+                  Fail&& fail) {
+    if (batch.empty()) {
+        return;
+    }
+    try {
+        write(batch);
+        return;
+    } catch (const std::exception& ex) {
+        if (batch.size() == 1 || !splittable(ex)) {
+            fail(batch, ex);
+            return;
+        }
+    }
+    // write должен откатывать пакет целиком: половины пишутся с нуля.
+    const auto half = batch.size() / 2;
+    WriteOrSplit(batch.first(half), write, splittable, fail);
+    WriteOrSplit(batch.subspan(half), write, splittable, fail);
+}
+
+}  // namespace masterclasses::utils
@@ -0,0 +1,68 @@
+#include "utils/csv.hpp"
+
+namespace masterclasses::utils {
+
+namespace {
+
+constexpr std::string_view kUtf8Bom = "\xEF\xBB\xBF";
+
+}  // namespace
+
+CsvReader::CsvReader(std::string_view text) : text_(text) {
+    if (text_.substr(0, kUtf8Bom.size()) == kUtf8Bom) {
+        pos_ = kUtf8Bom.size();
+    }
+}
+
+bool CsvReader::Next(std::vector<std::string>& fields) {
+    fields.clear();
+    std::string field;
+    bool in_quotes = false;
+    bool empty_record = true;
+    record_line_ = line_;
+
+    while (pos_ < text_.size()) {
+        const char c = text_[pos_++];
+        if (in_quotes) {
+            if (c != '"') {
+                line_ += c == '\n' ? 1 : 0;
+                field += c;
+            } else if (pos_ < text_.size() && text_[pos_] == '"') {
+                field += '"';
+                ++pos_;
+            } else {
+                in_quotes = false;
+            }
+            continue;
+        }
+        if (c == '\r' && pos_ < text_.size() && text_[pos_] == '\n') {
+            continue;
+        }
+        if (c == '\n') {
+            ++line_;
+            if (empty_record) {
+                // Пустая строка между записями.
+                record_line_ = line_;
+                continue;
+            }
+            fields.push_back(std::move(field));
+            return true;
+        }
+        empty_record = false;
+        if (c == '"' && field.empty()) {
+            in_quotes = true;
+        } else if (c == ',') {
+            fields.push_back(std::move(field));
+            field.clear();
+        } else {
+            field += c;
+        }
+    }
+    if (empty_record) {
+        return false;
+    }
+    fields.push_back(std::move(field));
+    return true;
+}
+
+}  // namespace masterclasses::utils
@@ -0,0 +1,32 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace masterclasses::utils {
+
+/// Построчное чтение CSV (RFC 4180, как csv.reader в Python): поля через
+/// запятую, поле в кавычках может содержать запятые и переводы строк,
+/// "" внутри кавычек - сама кавычка. Пустые строки пропускаются, BOM в
+/// начале и \r перед \n отбрасываются. Текст не копируется целиком:
+/// поля записи разбираются по одной.
+class CsvReader {
+  public:
+    explicit CsvReader(std::string_view text);
+
+    /// Следующая запись в `fields`; false, когда текст кончился.
+    bool Next(std::vector<std::string>& fields);
+
+    /// Номер строки текста (с 1), с которой началась последняя запись.
+    std::size_t Line() const { return record_line_; }
+
+  private:
+    std::string_view text_;
+    std::size_t pos_{0};
+    std::size_t line_{1};
+    std::size_t record_line_{0};
+};
+
+}  // namespace masterclasses::utils
@@ -0,0 +1,153 @@
+#include "utils/filter_args.hpp"
+#include "catalog/event_date.hpp"
+
+#include <cctype>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <userver/utils/datetime.hpp>
+
+namespace masterclasses::utils {
+
+namespace {
+
+/// Strict YYYY-MM-DD for query params (avoids injection).
+bool IsValidIsoDate(std::string_view s) {
+    if (s.size() != 10) {
+        return false;
+    }
+    if (s[4] != '-' || s[7] != '-') {
+        return false;
+    }
+    for (std::size_t i : {0u, 1u, 2u, 3u, 5u, 6u, 8u, 9u}) {
+        if (!std::isdigit(static_cast<unsigned char>(s[i]))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+constexpr double kMaxRadiusKm = 20000.0;
+
+double ParseCoordinate(const std::string& raw, const char* name,
+                       double limit) {
+    const double value = std::stod(raw);
+    if (!std::isfinite(value) || value < -limit || value > limit) {
+        throw std::invalid_argument(std::string{name} + " is out of range");
+    }
+    return value;
+}
+
+}  // namespace
+
+std::string UpcomingFrom() {
+    const auto now = userver::utils::datetime::Now();
+    return catalog::FormatEventDay(static_cast<std::int32_t>(
+        std::chrono::floor<std::chrono::days>(now).time_since_epoch().count()));
+}
+
+catalog::Filter ParseFilterArgs(
+    const userver::server::http::HttpRequest& request) {
+    const auto& category = request.GetArg("category");
+    const auto& audience = request.GetArg("audience");
+    const auto& tags = request.GetArg("tags");
+    const auto& format = request.GetArg("format");
+    const auto& company = request.GetArg("company");
+
+    catalog::Filter filter;
+    if (request.HasArg("min_age")) {
+        filter.min_age = std::stoi(request.GetArg("min_age"));
+    }
+    if (request.HasArg("max_price")) {
+        filter.max_price = std::stod(request.GetArg("max_price"));
+    }
+    if (request.HasArg("min_price")) {
+        filter.min_price = std::stod(request.GetArg("min_price"));
+    }
+    if (request.HasArg("min_rating")) {
+        filter.min_rating = std::stod(request.GetArg("min_rating"));
+    }
+
+    if (!category.empty()) {
+        if (category == "photo_video" || category == "photography") {
+            filter.category = "photo_video,photography";
+        } else if (category == "tech_digital" || category == "tech_coding") {
+            filter.category = "tech_digital,tech_coding";
+        } else {
+            filter.category = category;
+        }
+    }
+    if (!audience.empty()) {
+        filter.audience = audience;
+    }
+    if (!tags.empty()) {
+        filter.tags = tags;
+    }
+    if (!format.empty()) {
+        filter.format = format;
+    }
+    if (!company.empty()) {
+        filter.company = company;
+    }
+
+    if (request.HasArg("event_date_from")) {
+        const auto& s = request.GetArg("event_date_from");
+        if (IsValidIsoDate(s)) {
+            filter.event_date_from = std::string(s);
+        }
+    }
+    if (request.HasArg("event_date_to")) {
+        const auto& s = request.GetArg("event_date_to");
+        if (IsValidIsoDate(s)) {
+            filter.event_date_to = std::string(s);
+        }
+    }
+
+    const auto& include_past = request.GetArg("include_past");
+    if (include_past != "1" && include_past != "true") {
+        filter.upcoming_from = UpcomingFrom();
+    }
+
+    const auto& q = request.GetArg("q");
+    if (!q.empty()) {
+        filter.text = q;
+    }
+
+    const bool has_lat = request.HasArg("lat");
+    const bool has_lon = request.HasArg("lon");
+    if (has_lat != has_lon) {
+        throw std::invalid_argument("lat and lon must be given together");
+    }
+    if (has_lat) {
+        catalog::GeoFilter near;
+        near.center.latitude =
+            ParseCoordinate(request.GetArg("lat"), "lat", 90.0);
+        near.center.longitude =
+            ParseCoordinate(request.GetArg("lon"), "lon", 180.0);
+        if (request.HasArg("radius_km")) {
+            const double radius = std::stod(request.GetArg("radius_km"));
+            if (!(radius > 0.0 && radius <= kMaxRadiusKm)) {
+                throw std::invalid_argument("radius_km is out of range");
+            }
+            near.radius_km = radius;
+        }
+        filter.near = near;
+    } else if (request.HasArg("radius_km")) {
+        throw std::invalid_argument("radius_km requires lat and lon");
+    }
+
+    // Текстовый и гео-индекс есть только у каталога, а архива в нём нет:
+    // такой поиск молча потерял бы прошедшие мастер-классы.
+    if (!filter.upcoming_from.has_value() &&
+        (filter.text.has_value() || filter.near.has_value())) {
+        throw std::invalid_argument(
+            "include_past cannot be combined with q or lat/lon");
+    }
+    return filter;
+}
+
+}  // namespace masterclasses::utils
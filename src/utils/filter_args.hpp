@@ -0,0 +1,24 @@
+#pragma once
+
+#include <string>
+
+#include <userver/server/http/http_request.hpp>
+
+#include "catalog/filter.hpp"
+
+namespace masterclasses::utils {
+
+/// Фильтры каталога из query-параметров: category, audience, tags, format,
+/// company, min_age, min/max_price, min_rating, event_date_from/to, q и
+/// lat/lon/radius_km. Общая часть /mclist и /mcexport; числа с ошибкой
+/// формата и координаты вне диапазона бросают std::invalid_argument, даты
+/// не в YYYY-MM-DD игнорируются. Без include_past=1 выдаются только
+/// предстоящие (upcoming_from = UpcomingFrom()).
+catalog::Filter ParseFilterArgs(
+    const userver::server::http::HttpRequest& request);
+
+/// Сегодня по UTC, YYYY-MM-DD: с этой даты события считаются
+/// предстоящими, более ранние переносит в архив event-archiver.
+std::string UpcomingFrom();
+
+}  // namespace masterclasses::utils
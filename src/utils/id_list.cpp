@@ -0,0 +1,52 @@
+#include "utils/id_list.hpp"
+
+#include <charconv>
+
+namespace masterclasses::utils {
+
+namespace {
+
+template <typename Ids>
+void AppendIds(std::string_view raw, Ids& ids) {
+    std::size_t start = 0;
+    while (start < raw.size()) {
+        auto end = raw.find(',', start);
+        if (end == std::string_view::npos) {
+            end = raw.size();
+        }
+        auto token = raw.substr(start, end - start);
+        while (!token.empty() && token.front() == ' ')
+            token.remove_prefix(1);
+        while (!token.empty() && token.back() == ' ')
+            token.remove_suffix(1);
+        if (!token.empty() && token.front() == '+') {
+            token.remove_prefix(1);
+        }
+        // Как stoll: берётся числовой префикс токена, переполнение
+        // пропускается; from_chars не копирует токен в std::string.
+        std::int64_t value = 0;
+        const auto [ptr, error] =
+            std::from_chars(token.data(), token.data() + token.size(), value);
+        if (error == std::errc{} && ptr != token.data() && value > 0) {
+            ids.push_back(value);
+        }
+        start = end + 1;
+    }
+}
+
+}  // namespace
+
+std::vector<std::int64_t> ParseIdList(std::string_view raw) {
+    std::vector<std::int64_t> ids;
+    AppendIds(raw, ids);
+    return ids;
+}
+
+std::pmr::vector<std::int64_t> ParseIdList(
+    std::string_view raw, std::pmr::memory_resource* resource) {
+    std::pmr::vector<std::int64_t> ids(resource);
+    AppendIds(raw, ids);
+    return ids;
+}
+
+}  // namespace masterclasses::utils
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <cstdint>
+#include <memory_resource>
+#include <string_view>
+#include <vector>
+
+namespace masterclasses::utils {
+
+/// Список id через запятую ("1, 2,3"): пробелы вокруг токенов
+/// отбрасываются, нечисловые и неположительные токены пропускаются.
+std::vector<std::int64_t> ParseIdList(std::string_view raw);
+
+/// То же в памяти `resource` (арены запроса).
+std::pmr::vector<std::int64_t> ParseIdList(std::string_view raw,
+                                           std::pmr::memory_resource* resource);
+
+}  // namespace masterclasses::utils
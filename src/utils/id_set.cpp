@@ -0,0 +1,115 @@
+#include "utils/id_set.hpp"
+
+#include <algorithm>
+
+namespace masterclasses::utils {
+
+namespace {
+
+std::uint64_t KeyOf(std::int64_t id) {
+    return static_cast<std::uint64_t>(id) >> 16;
+}
+
+std::uint16_t LowOf(std::int64_t id) {
+    return static_cast<std::uint16_t>(static_cast<std::uint64_t>(id) & 0xFFFF);
+}
+
+}  // namespace
+
+const IdSet::Chunk* IdSet::FindChunk(std::uint64_t key) const {
+    auto it = std::lower_bound(
+        chunks_.begin(), chunks_.end(), key,
+        [](const Chunk& chunk, std::uint64_t k) { return chunk.key < k; });
+    if (it == chunks_.end() || it->key != key) {
+        return nullptr;
+    }
+    return &*it;
+}
+
+bool IdSet::Contains(std::int64_t id) const {
+    const auto* chunk = FindChunk(KeyOf(id));
+    if (chunk == nullptr) {
+        return false;
+    }
+    const auto low = LowOf(id);
+    if (const auto* array = std::get_if<ArrayContainer>(&chunk->values)) {
+        return std::binary_search(array->begin(), array->end(), low);
+    }
+    const auto& bitmap = std::get<BitmapContainer>(chunk->values);
+    return (bitmap[low >> 6] >> (low & 63)) & 1;
+}
+
+bool IdSet::Add(std::int64_t id) {
+    const auto key = KeyOf(id);
+    const auto low = LowOf(id);
+    auto it = std::lower_bound(
+        chunks_.begin(), chunks_.end(), key,
+        [](const Chunk& chunk, std::uint64_t k) { return chunk.key < k; });
+    if (it == chunks_.end() || it->key != key) {
+        it = chunks_.insert(it, Chunk{key, ArrayContainer{}});
+    }
+
+    if (auto* array = std::get_if<ArrayContainer>(&it->values)) {
+        auto pos = std::lower_bound(array->begin(), array->end(), low);
+        if (pos != array->end() && *pos == low) {
+            return false;
+        }
+        if (array->size() < kArrayMaxSize) {
+            array->insert(pos, low);
+            ++size_;
+            return true;
+        }
+        BitmapContainer bitmap(kBitmapWords, 0);
+        for (const auto value : *array) {
+            bitmap[value >> 6] |= std::uint64_t{1} << (value & 63);
+        }
+        it->values = std::move(bitmap);
+    }
+
+    auto& bitmap = std::get<BitmapContainer>(it->values);
+    const auto mask = std::uint64_t{1} << (low & 63);
+    if (bitmap[low >> 6] & mask) {
+        return false;
+    }
+    bitmap[low >> 6] |= mask;
+    ++size_;
+    return true;
+}
+
+std::size_t IdSet::MemoryUsageBytes() const {
+    std::size_t bytes = chunks_.capacity() * sizeof(Chunk);
+    for (const auto& chunk : chunks_) {
+        if (const auto* array = std::get_if<ArrayContainer>(&chunk.values)) {
+            bytes += array->capacity() * sizeof(std::uint16_t);
+        } else {
+            bytes += kBitmapWords * sizeof(std::uint64_t);
+        }
+    }
+    return bytes;
+}
+
+std::vector<std::int64_t> IdSet::ToVector() const {
+    std::vector<std::int64_t> ids;
+    ids.reserve(size_);
+    for (const auto& chunk : chunks_) {
+        const auto base = static_cast<std::int64_t>(chunk.key << 16);
+        if (const auto* array = std::get_if<ArrayContainer>(&chunk.values)) {
+            for (const auto low : *array) {
+                ids.push_back(base | low);
+            }
+            continue;
+        }
+        const auto& bitmap = std::get<BitmapContainer>(chunk.values);
+        for (std::size_t word = 0; word < bitmap.size(); ++word) {
+            auto bits = bitmap[word];
+            while (bits != 0) {
+                const auto bit = __builtin_ctzll(bits);
+                ids.push_back(base | static_cast<std::int64_t>(word * 64 + bit));
+                bits &= bits - 1;
+            }
+        }
+    }
+    return ids;
+}
+
+}  // namespace masterclasses::utils
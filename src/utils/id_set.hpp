@@ -0,0 +1,42 @@
+#pragma once
+
+#include <cstdint>
+#include <variant>
+#include <vector>
+
+namespace masterclasses::utils {
+
+/// Компактное множество id в духе roaring bitmap: старшие биты id выбирают
+/// контейнер, младшие 16 бит хранятся либо отсортированным массивом (пока
+/// элементов мало), либо битовой картой на 65536 бит.
+class IdSet {
+  public:
+    bool Contains(std::int64_t id) const;
+    /// true, если id не было в множестве.
+    bool Add(std::int64_t id);
+
+    std::size_t Size() const { return size_; }
+    bool Empty() const { return size_ == 0; }
+    std::size_t MemoryUsageBytes() const;
+
+    std::vector<std::int64_t> ToVector() const;
+
+  private:
+    static constexpr std::size_t kArrayMaxSize = 4096;
+    static constexpr std::size_t kBitmapWords = 65536 / 64;
+
+    using ArrayContainer = std::vector<std::uint16_t>;
+    using BitmapContainer = std::vector<std::uint64_t>;
+
+    struct Chunk {
+        std::uint64_t key{0};
+        std::variant<ArrayContainer, BitmapContainer> values;
+    };
+
+    const Chunk* FindChunk(std::uint64_t key) const;
+
+    std::vector<Chunk> chunks_;  // отсортированы по key
+    std::size_t size_{0};
+};
+
+}  // namespace masterclasses::utils
@@ -0,0 +1,136 @@
+#include "utils/msgpack.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+namespace masterclasses::utils {
+
+void MsgPackWriter::PutByte(std::uint8_t byte) {
+    buffer_.push_back(static_cast<char>(byte));
+}
+
+void MsgPackWriter::PutBigEndian(std::uint64_t value, int bytes) {
+    for (int shift = (bytes - 1) * 8; shift >= 0; shift -= 8) {
+        PutByte(static_cast<std::uint8_t>((value >> shift) & 0xFF));
+    }
+}
+
+void MsgPackWriter::WriteNil() { PutByte(0xC0); }
+
+void MsgPackWriter::WriteBool(bool value) { PutByte(value ? 0xC3 : 0xC2); }
+
+void MsgPackWriter::WriteInt(std::int64_t value) {
+    if (value >= 0) {
+        if (value <= 0x7F) {
+            PutByte(static_cast<std::uint8_t>(value));
+        } else if (value <= 0xFF) {
+            PutByte(0xCC);
+            PutBigEndian(value, 1);
+        } else if (value <= 0xFFFF) {
+            PutByte(0xCD);
+            PutBigEndian(value, 2);
+        } else if (value <= 0xFFFFFFFFLL) {
+            PutByte(0xCE);
+            PutBigEndian(value, 4);
+        } else {
+            PutByte(0xCF);
+            PutBigEndian(value, 8);
+        }
+        return;
+    }
+    if (value >= -32) {
+        PutByte(static_cast<std::uint8_t>(value));
+    } else if (value >= INT8_MIN) {
+        PutByte(0xD0);
+        PutBigEndian(static_cast<std::uint8_t>(value), 1);
+    } else if (value >= INT16_MIN) {
+        PutByte(0xD1);
+        PutBigEndian(static_cast<std::uint16_t>(value), 2);
+    } else if (value >= INT32_MIN) {
+        PutByte(0xD2);
+        PutBigEndian(static_cast<std::uint32_t>(value), 4);
+    } else {
+        PutByte(0xD3);
+        PutBigEndian(static_cast<std::uint64_t>(value), 8);
+    }
+}
+
+void MsgPackWriter::WriteDouble(double value) {
+    std::uint64_t bits = 0;
+    static_assert(sizeof(bits) == sizeof(value));
+    std::memcpy(&bits, &value, sizeof(bits));
+    PutByte(0xCB);
+    PutBigEndian(bits, 8);
+}
+
+void MsgPackWriter::WriteString(std::string_view value) {
+    const auto size = value.size();
+    if (size <= 31) {
+        PutByte(static_cast<std::uint8_t>(0xA0 | size));
+    } else if (size <= 0xFF) {
+        PutByte(0xD9);
+        PutBigEndian(size, 1);
+    } else if (size <= 0xFFFF) {
+        PutByte(0xDA);
+        PutBigEndian(size, 2);
+    } else {
+        PutByte(0xDB);
+        PutBigEndian(size, 4);
+    }
+    buffer_.append(value.data(), value.size());
+}
+
+void MsgPackWriter::WriteArrayHeader(std::size_t size) {
+    if (size <= 15) {
+        PutByte(static_cast<std::uint8_t>(0x90 | size));
+    } else if (size <= 0xFFFF) {
+        PutByte(0xDC);
+        PutBigEndian(size, 2);
+    } else {
+        PutByte(0xDD);
+        PutBigEndian(size, 4);
+    }
+}
+
+void MsgPackWriter::WriteMapHeader(std::size_t size) {
+    if (size <= 15) {
+        PutByte(static_cast<std::uint8_t>(0x80 | size));
+    } else if (size <= 0xFFFF) {
+        PutByte(0xDE);
+        PutBigEndian(size, 2);
+    } else {
+        PutByte(0xDF);
+        PutBigEndian(size, 4);
+    }
+}
+
+void MsgPackWriter::WriteJson(const userver::formats::json::Value& value) {
+    if (value.IsMissing() || value.IsNull()) {
+        WriteNil();
+    } else if (value.IsBool()) {
+        WriteBool(value.As<bool>());
+    } else if (value.IsInt64()) {
+        WriteInt(value.As<std::int64_t>());
+    } else if (value.IsUInt64()) {
+        WriteInt(static_cast<std::int64_t>(value.As<std::uint64_t>()));
+    } else if (value.IsDouble()) {
+        WriteDouble(value.As<double>());
+    } else if (value.IsString()) {
+        WriteString(value.As<std::string>());
+    } else if (value.IsArray()) {
+        WriteArrayHeader(value.GetSize());
+        for (const auto& item : value) {
+            WriteJson(item);
+        }
+    } else if (value.IsObject()) {
+        WriteMapHeader(value.GetSize());
+        for (auto it = value.begin(); it != value.end(); ++it) {
+            WriteString(it.GetName());
+            WriteJson(*it);
+        }
+    } else {
+        throw std::logic_error("unsupported JSON value for MessagePack");
+    }
+}
+
+}  // namespace masterclasses::utils
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <cstdint>
+#include <optional>
+#include <string>
+#include <string_view>
+
+#include <userver/formats/json/value.hpp>
+
+namespace masterclasses::utils {
+
+/// Минимальный потоковый энкодер MessagePack (только то, что нужно API).
+class MsgPackWriter {
+  public:
+    void WriteNil();
+    void WriteBool(bool value);
+    void WriteInt(std::int64_t value);
+    void WriteDouble(double value);
+    void WriteString(std::string_view value);
+    void WriteArrayHeader(std::size_t size);
+    void WriteMapHeader(std::size_t size);
+
+    /// Произвольное JSON-значение (object -> map, array -> array).
+    void WriteJson(const userver::formats::json::Value& value);
+
+    void Write(std::int64_t value) { WriteInt(value); }
+    void Write(int value) { WriteInt(value); }
+    void Write(double value) { WriteDouble(value); }
+    void Write(std::string_view value) { WriteString(value); }
+    void Write(const std::string& value) { WriteString(value); }
+    void Write(const std::optional<double>& value) {
+        if (value.has_value()) {
+            WriteDouble(*value);
+        } else {
+            WriteNil();
+        }
+    }
+
+    std::string Extract() { return std::move(buffer_); }
+
+  private:
+    void PutByte(std::uint8_t byte);
+    void PutBigEndian(std::uint64_t value, int bytes);
+
+    std::string buffer_;
+};
+
+}  // namespace masterclasses::utils
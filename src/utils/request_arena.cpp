@@ -0,0 +1,28 @@
+#include "utils/request_arena.hpp"
+
+namespace masterclasses::utils {
+
+RequestArena::RequestArena()
+    : heap_(std::pmr::new_delete_resource()),
+      arena_(buffer_.data(), buffer_.size(), &heap_),
+      counted_(&arena_) {}
+
+void* RequestArena::CountingResource::do_allocate(std::size_t size,
+                                                  std::size_t alignment) {
+    ++allocations;
+    bytes += size;
+    return upstream_->allocate(size, alignment);
+}
+
+void RequestArena::CountingResource::do_deallocate(void* pointer,
+                                                   std::size_t size,
+                                                   std::size_t alignment) {
+    upstream_->deallocate(pointer, size, alignment);
+}
+
+bool RequestArena::CountingResource::do_is_equal(
+    const std::pmr::memory_resource& other) const noexcept {
+    return this == &other;
+}
+
+}  // namespace masterclasses::utils
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace masterclasses::utils {
+
+/// Монотонная арена одного запроса. Временные структуры хэндлера (id из
+/// аргументов, страница указателей на строки, кандидаты выборки) берутся
+/// из буфера в кадре хэндлера и освобождаются разом вместе с ареной; когда
+/// буфера не хватает, арена добирает блоки из кучи. Счётчики выдач и
+/// блоков из кучи уходят в метрики allocation-stats; остальные аллокации
+/// запроса (строки, JSON, драйвер Postgres) идут мимо арены и в них не
+/// попадают.
+class RequestArena final {
+  public:
+    static constexpr std::size_t kInlineBytes = 8 * 1024;
+
+    RequestArena();
+    RequestArena(const RequestArena&) = delete;
+    RequestArena& operator=(const RequestArena&) = delete;
+
+    std::pmr::memory_resource* Resource() { return &counted_; }
+
+    /// Выдачи из арены и их суммарный размер.
+    std::uint64_t Allocations() const { return counted_.allocations; }
+    std::uint64_t Bytes() const { return counted_.bytes; }
+    /// Блоки, которые арене пришлось взять из кучи сверх буфера.
+    std::uint64_t HeapBlocks() const { return heap_.allocations; }
+    std::uint64_t HeapBytes() const { return heap_.bytes; }
+
+  private:
+    class CountingResource final : public std::pmr::memory_resource {
+      public:
+        explicit CountingResource(std::pmr::memory_resource* upstream)
+            : upstream_(upstream) {}
+
+        std::uint64_t allocations{0};
+        std::uint64_t bytes{0};
+
+      private:
+        void* do_allocate(std::size_t size, std::size_t alignment) override;
+        void do_deallocate(void* pointer, std::size_t size,
+                           std::size_t alignment) override;
+        bool do_is_equal(
+            const std::pmr::memory_resource& other) const noexcept override;
+
+        std::pmr::memory_resource* upstream_;
+    };
+
+    alignas(std::max_align_t) std::array<std::byte, kInlineBytes> buffer_;
+    CountingResource heap_;
+    std::pmr::monotonic_buffer_resource arena_;
+    CountingResource counted_;
+};
+
+}  // namespace masterclasses::utils
@@ -0,0 +1,227 @@
+#include "utils/response_format.hpp"
+
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <string_view>
+#include <type_traits>
+
+#include <userver/formats/json/string_builder.hpp>
+#include <userver/http/common_headers.hpp>
+#include <userver/http/content_type.hpp>
+#include <userver/server/http/http_response.hpp>
+
+#include "utils/msgpack.hpp"
+
+namespace masterclasses::utils {
+
+namespace {
+
+std::string_view Trim(std::string_view s) {
+    while (!s.empty() && (s.front() == ' ' || s.front() == '\t'))
+        s.remove_prefix(1);
+    while (!s.empty() && (s.back() == ' ' || s.back() == '\t'))
+        s.remove_suffix(1);
+    return s;
+}
+
+std::optional<ResponseFormat> FormatForMediaType(std::string_view media) {
+    if (media == kMsgPackContentType || media == "application/msgpack" ||
+        media == "application/vnd.msgpack") {
+        return ResponseFormat::kMsgPack;
+    }
+    if (media == kColumnarJsonContentType) {
+        return ResponseFormat::kColumnarJson;
+    }
+    // JSON и маски сравниваются наравне с остальными: клиент, который
+    // предпочитает JSON, должен его получить.
+    if (media == "application/json" || media == "application/*" ||
+        media == "*/*") {
+        return ResponseFormat::kJson;
+    }
+    return std::nullopt;
+}
+
+/// q-параметр media range; отсутствие q означает 1.
+double QualityOf(std::string_view params) {
+    while (!params.empty()) {
+        auto end = params.find(';');
+        auto param = Trim(params.substr(0, end));
+        if (param.size() > 2 && (param[0] == 'q' || param[0] == 'Q') &&
+            param[1] == '=') {
+            return std::strtod(std::string{param.substr(2)}.c_str(), nullptr);
+        }
+        if (end == std::string_view::npos) {
+            break;
+        }
+        params.remove_prefix(end + 1);
+    }
+    return 1.0;
+}
+
+using Items = std::span<const models::Masterclass* const>;
+
+template <typename T>
+void WriteField(userver::formats::json::StringBuilder& builder,
+                const T& value) {
+    if constexpr (std::is_same_v<T, std::string>) {
+        builder.WriteString(value);
+    } else if constexpr (std::is_same_v<T, std::optional<double>>) {
+        if (value.has_value()) {
+            builder.WriteDouble(*value);
+        } else {
+            builder.WriteNull();
+        }
+    } else if constexpr (std::is_floating_point_v<T>) {
+        builder.WriteDouble(value);
+    } else {
+        builder.WriteInt64(static_cast<std::int64_t>(value));
+    }
+}
+
+/// Поля meta, затем "masterclasses": как у объекта meta с добавленным
+/// ключом, но без построения дерева.
+template <typename WriteMasterclasses>
+std::string RenderJsonObject(const userver::formats::json::Value& meta,
+                             WriteMasterclasses write_masterclasses) {
+    userver::formats::json::StringBuilder builder;
+    {
+        userver::formats::json::StringBuilder::ObjectGuard response(builder);
+        for (auto it = meta.begin(); it != meta.end(); ++it) {
+            builder.Key(it.GetName());
+            builder.WriteValue(*it);
+        }
+        builder.Key("masterclasses");
+        write_masterclasses(builder);
+    }
+    return builder.GetString();
+}
+
+std::string RenderJson(Items items, const userver::formats::json::Value& meta) {
+    return RenderJsonObject(meta, [items](auto& builder) {
+        userver::formats::json::StringBuilder::ArrayGuard array(builder);
+        for (const auto* item : items) {
+            userver::formats::json::StringBuilder::ObjectGuard entry(builder);
+            models::VisitMasterclassFields(
+                [&](std::string_view name, auto field) {
+                    builder.Key(name);
+                    WriteField(builder, item->*field);
+                });
+        }
+    });
+}
+
+std::string RenderColumnarJson(Items items,
+                               const userver::formats::json::Value& meta) {
+    return RenderJsonObject(meta, [items](auto& builder) {
+        userver::formats::json::StringBuilder::ObjectGuard columns(builder);
+        models::VisitMasterclassFields([&](std::string_view name, auto field) {
+            builder.Key(name);
+            userver::formats::json::StringBuilder::ArrayGuard column(builder);
+            for (const auto* item : items) {
+                WriteField(builder, item->*field);
+            }
+        });
+    });
+}
+
+std::string RenderMsgPack(Items items,
+                          const userver::formats::json::Value& meta) {
+    std::size_t column_count = 0;
+    models::VisitMasterclassFields([&](std::string_view, auto) {
+        ++column_count;
+    });
+
+    MsgPackWriter writer;
+    writer.WriteMapHeader(meta.GetSize() + 1);
+    for (auto it = meta.begin(); it != meta.end(); ++it) {
+        writer.WriteString(it.GetName());
+        writer.WriteJson(*it);
+    }
+    writer.WriteString("masterclasses");
+    writer.WriteMapHeader(column_count);
+    models::VisitMasterclassFields([&](std::string_view name, auto field) {
+        writer.WriteString(name);
+        writer.WriteArrayHeader(items.size());
+        for (const auto* item : items) {
+            writer.Write(item->*field);
+        }
+    });
+    return writer.Extract();
+}
+
+}  // namespace
+
+ResponseFormat NegotiateResponseFormat(std::string_view accept) {
+    auto best = ResponseFormat::kJson;
+    double best_quality = 0.0;
+    bool best_is_wildcard = false;
+    while (!accept.empty()) {
+        auto end = accept.find(',');
+        auto range = Trim(accept.substr(0, end));
+        const auto params_pos = range.find(';');
+        const auto media = Trim(range.substr(0, params_pos));
+        const auto format = FormatForMediaType(media);
+        if (format.has_value()) {
+            const double quality =
+                params_pos == std::string_view::npos
+                    ? 1.0
+                    : QualityOf(range.substr(params_pos + 1));
+            // При равных q конкретный тип важнее маски.
+            const bool wildcard = media.find('*') != std::string_view::npos;
+            if (quality > best_quality ||
+                (quality == best_quality && best_is_wildcard && !wildcard)) {
+                best = *format;
+                best_quality = quality;
+                best_is_wildcard = wildcard;
+            }
+        }
+        if (end == std::string_view::npos) {
+            break;
+        }
+        accept.remove_prefix(end + 1);
+    }
+    return best;
+}
+
+ResponseFormat NegotiateResponseFormat(
+    const userver::server::http::HttpRequest& request) {
+    return NegotiateResponseFormat(
+        request.GetHeader(userver::http::headers::kAccept));
+}
+
+std::string RenderMasterclassList(
+    const userver::server::http::HttpRequest& request, Items items,
+    const userver::formats::json::Value& meta) {
+    auto& response = request.GetHttpResponse();
+    response.SetHeader(std::string{"Vary"}, std::string{"Accept"});
+
+    switch (NegotiateResponseFormat(request)) {
+        case ResponseFormat::kColumnarJson:
+            response.SetContentType(
+                userver::http::ContentType{std::string{kColumnarJsonContentType}});
+            return RenderColumnarJson(items, meta);
+        case ResponseFormat::kMsgPack:
+            response.SetContentType(
+                userver::http::ContentType{std::string{kMsgPackContentType}});
+            return RenderMsgPack(items, meta);
+        case ResponseFormat::kJson:
+            break;
+    }
+    response.SetContentType(userver::http::content_type::kApplicationJson);
+    return RenderJson(items, meta);
+}
+
+std::string RenderMasterclassList(
+    const userver::server::http::HttpRequest& request,
+    const std::vector<models::Masterclass>& items,
+    const userver::formats::json::Value& meta) {
+    std::vector<const models::Masterclass*> pointers;
+    pointers.reserve(items.size());
+    for (const auto& item : items) {
+        pointers.push_back(&item);
+    }
+    return RenderMasterclassList(request, pointers, meta);
+}
+
+}  // namespace masterclasses::utils
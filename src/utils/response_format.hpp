@@ -0,0 +1,47 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <userver/formats/json/value.hpp>
+#include <userver/server/http/http_request.hpp>
+
+#include "models/masterclass.hpp"
+
+namespace masterclasses::utils {
+
+/// Формат ответа со списком мастер-классов, выбирается по заголовку Accept.
+enum class ResponseFormat {
+    kJson,          ///< application/json, массив объектов (Flutter-клиент)
+    kColumnarJson,  ///< имена полей один раз, по массиву значений на колонку
+    kMsgPack,       ///< те же колонки в MessagePack
+};
+
+inline constexpr std::string_view kColumnarJsonContentType =
+    "application/vnd.masterclasses.columnar+json";
+inline constexpr std::string_view kMsgPackContentType = "application/x-msgpack";
+
+/// Формат с наибольшим q в Accept; JSON, `application/*` и `*/*`
+/// участвуют наравне с остальными; при равных q конкретный тип важнее
+/// маски, а из конкретных побеждает указанный раньше. Без подходящих
+/// типов - JSON.
+ResponseFormat NegotiateResponseFormat(std::string_view accept);
+ResponseFormat NegotiateResponseFormat(
+    const userver::server::http::HttpRequest& request);
+
+/// Сериализует список в согласованном формате и выставляет Content-Type.
+/// `meta` - объект со скалярными полями верхнего уровня ("returned" и т.п.).
+/// JSON пишется потоком, без промежуточного дерева значений.
+std::string RenderMasterclassList(
+    const userver::server::http::HttpRequest& request,
+    std::span<const models::Masterclass* const> items,
+    const userver::formats::json::Value& meta);
+
+std::string RenderMasterclassList(
+    const userver::server::http::HttpRequest& request,
+    const std::vector<models::Masterclass>& items,
+    const userver::formats::json::Value& meta);
+
+}  // namespace masterclasses::utils
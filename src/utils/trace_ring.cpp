@@ -0,0 +1,79 @@
+#include "utils/trace_ring.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace masterclasses::utils {
+
+namespace {
+
+/// Версия слота с записанным образцом номер `ticket`; 0 - слот пуст.
+std::uint64_t CommittedVersion(std::uint64_t ticket) {
+    return 2 * ticket + 2;
+}
+
+}  // namespace
+
+TraceRing::TraceRing(std::size_t capacity)
+    : capacity_(std::max<std::size_t>(capacity, 1)),
+      slots_(std::make_unique<Slot[]>(capacity_)) {}
+
+bool TraceRing::Push(const TraceSample& sample) {
+    const auto ticket = next_.fetch_add(1, std::memory_order_relaxed);
+    auto& slot = slots_[ticket % capacity_];
+
+    auto version = slot.version.load(std::memory_order_relaxed);
+    // Занятый слот или слот, куда уже записан более новый образец, не
+    // трогаем.
+    if ((version & 1) != 0 || version > CommittedVersion(ticket) ||
+        !slot.version.compare_exchange_strong(
+            version, CommittedVersion(ticket) - 1,
+            std::memory_order_acquire, std::memory_order_relaxed)) {
+        dropped_.fetch_add(1, std::memory_order_relaxed);
+        return false;
+    }
+    std::atomic_thread_fence(std::memory_order_release);
+
+    std::array<std::uint64_t, kWords> words{};
+    // TraceSample тривиально копируем (static_assert в заголовке), а
+    // инициализаторы полей - не повод для -Wclass-memaccess.
+    std::memcpy(words.data(), static_cast<const void*>(&sample),
+                sizeof(sample));
+    for (std::size_t i = 0; i < kWords; ++i) {
+        slot.words[i].store(words[i], std::memory_order_relaxed);
+    }
+    slot.version.store(CommittedVersion(ticket), std::memory_order_release);
+    return true;
+}
+
+std::vector<TraceSample> TraceRing::Snapshot() const {
+    const auto next = next_.load(std::memory_order_acquire);
+    const auto count = std::min<std::uint64_t>(next, capacity_);
+
+    std::vector<TraceSample> samples;
+    samples.reserve(count);
+    std::array<std::uint64_t, kWords> words{};
+    for (std::uint64_t i = 0; i < count; ++i) {
+        const auto ticket = next - 1 - i;
+        const auto& slot = slots_[ticket % capacity_];
+
+        const auto before = slot.version.load(std::memory_order_acquire);
+        if (before != CommittedVersion(ticket)) {
+            // Пишется, отброшен или уже перезаписан более новым.
+            continue;
+        }
+        for (std::size_t w = 0; w < kWords; ++w) {
+            words[w] = slot.words[w].load(std::memory_order_relaxed);
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (slot.version.load(std::memory_order_relaxed) != before) {
+            continue;
+        }
+        auto& sample = samples.emplace_back();
+        std::memcpy(static_cast<void*>(&sample), words.data(),
+                    sizeof(sample));
+    }
+    return samples;
+}
+
+}  // namespace masterclasses::utils
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+namespace masterclasses::utils {
+
+/// Образец одного запроса для кольца трасс. Все поля - фиксированного
+/// размера, чтобы образец копировался словами без аллокаций; строки
+/// обрезаются по размеру поля.
+struct TraceSample {
+    static constexpr std::size_t kMaxStages = 6;
+
+    /// Биты db_hosts.
+    static constexpr std::uint8_t kDbMaster = 1;
+    static constexpr std::uint8_t kDbReplica = 2;
+    static constexpr std::uint8_t kDbHedge = 4;  ///< ответила хедж-реплика
+
+    struct Stage {
+        std::array<char, 16> name{};
+        std::uint32_t micros{0};
+    };
+
+    std::int64_t timestamp_ms{0};  ///< unix-время начала запроса
+    std::uint32_t total_micros{0};
+    std::uint32_t response_bytes{0};
+    std::uint16_t status{0};
+    std::uint16_t db_round_trips{0};
+    std::uint8_t stage_count{0};
+    std::uint8_t db_hosts{0};
+    bool slow{false};
+    bool failed{false};  ///< хэндлер завершился исключением
+    std::array<Stage, kMaxStages> stages{};
+    std::array<char, 40> handler{};
+    std::array<char, 200> args{};
+
+    template <std::size_t N>
+    static void SetText(std::array<char, N>& field, std::string_view text) {
+        const auto size = text.size() < N ? text.size() : N - 1;
+        text.copy(field.data(), size);
+        field[size] = '\0';
+    }
+
+    template <std::size_t N>
+    static std::string_view Text(const std::array<char, N>& field) {
+        std::size_t size = 0;
+        while (size < N && field[size] != '\0') {
+            ++size;
+        }
+        return {field.data(), size};
+    }
+};
+
+static_assert(std::is_trivially_copyable_v<TraceSample>);
+
+/// Кольцо последних образцов фиксированного размера, без блокировок.
+/// Писатель берёт номер из общего счётчика и пишет в слот номер % capacity
+/// под seqlock слота: нечётная версия - запись идёт, чётная - в слоте
+/// образец с этим номером. Если слот в этот момент пишет другой поток
+/// (кольцо обернулось быстрее, чем закончилась запись), образец
+/// отбрасывается, а не ждёт. Читатель копирует слот и проверяет, что
+/// версия не изменилась; данные слота - атомарные слова, так что гонки
+/// читателя с писателем определены.
+class TraceRing final {
+  public:
+    explicit TraceRing(std::size_t capacity);
+    TraceRing(const TraceRing&) = delete;
+    TraceRing& operator=(const TraceRing&) = delete;
+
+    /// false, если образец отброшен.
+    bool Push(const TraceSample& sample);
+
+    /// Целые образцы из кольца, от новых к старым.
+    std::vector<TraceSample> Snapshot() const;
+
+    std::size_t Capacity() const { return capacity_; }
+    std::uint64_t Pushed() const { return next_.load(); }
+    std::uint64_t Dropped() const { return dropped_.load(); }
+
+  private:
+    static constexpr std::size_t kWords =
+        (sizeof(TraceSample) + sizeof(std::uint64_t) - 1) /
+        sizeof(std::uint64_t);
+
+    struct Slot {
+        std::atomic<std::uint64_t> version{0};
+        std::array<std::atomic<std::uint64_t>, kWords> words{};
+    };
+
+    std::size_t capacity_;
+    std::unique_ptr<Slot[]> slots_;
+    std::atomic<std::uint64_t> next_{0};
+    std::atomic<std::uint64_t> dropped_{0};
+};
+
+}  // namespace masterclasses::utils
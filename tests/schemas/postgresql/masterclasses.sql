@@ -0,0 +1 @@
+../../../scripts/db/init.sql
\ No newline at end of file
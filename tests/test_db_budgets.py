@@ -0,0 +1,375 @@
+"""Бюджеты обращений к Postgres: каждый хэндлер вызывается на засеянной
+базе, а pg_stat_statements показывает, какие запросы он выполнил, сколько
+раз, сколько строк вернул и сколько страниц прочитал. Лишний запрос, лишний
+вызов в цикле или потерянный индекс роняют тест с именем запроса.
+
+Задержки не проверяются: они зависят от сборки (Debug, санитайзеры), а не
+от числа запросов."""
+
+from __future__ import annotations
+
+import dataclasses
+import math
+import pathlib
+
+import pytest
+import yaml
+
+from conftest import CATALOG_SIZE, DB_NAME, PASSWORD, QueryStats, _catalog_csv
+
+METRICS_PREFIX = "masterclasses.db-budget"
+UPSERT_BATCH_SIZE = 1000  # kUpsertBatchSize в mc_sync_handler.cpp
+
+# Точечный поиск по индексу среди FILLER_USERS строк - корень, лист и куча,
+# с запасом на TOAST и видимость; полный просмотр users - около сотни.
+MAX_INDEX_LOOKUP_BLOCKS = 16
+
+
+@dataclasses.dataclass(frozen=True)
+class Limit:
+    calls: int
+    rows: int | None = None  # не больше, за все вызовы
+    blocks_per_call: float | None = None
+
+
+@pytest.fixture(scope="session")
+def handler_budgets(service_source_dir) -> dict:
+    config = yaml.safe_load(
+        pathlib.Path(service_source_dir / "configs/static_config.yaml").read_text(
+            encoding="utf-8"
+        )
+    )
+    components = config["components_manager"]["components"]
+    return components["request-budgets"]["handlers"]
+
+
+@pytest.fixture
+def measure(monitor_client, pg_statements, handler_budgets):
+    """Выполняет запрос и сверяет его запросы к БД с ожидаемыми, а счётчики
+    RequestBudgets - с max-db-round-trips из static_config.yaml."""
+
+    async def run(handler: str, call, expected: dict[str, Limit]):
+        pg_statements.reset()
+        async with monitor_client.metrics_diff(
+            prefix=METRICS_PREFIX, diff_gauge=True
+        ) as differ:
+            response = await call()
+        _check_queries(handler, pg_statements.collect(), expected)
+        _check_budget(handler, differ, handler_budgets.get(handler))
+        return response
+
+    return run
+
+
+def _check_queries(
+    handler: str, stats: dict[str, QueryStats], expected: dict[str, Limit]
+) -> None:
+    problems = []
+    for name, stat in sorted(stats.items()):
+        limit = expected.get(name)
+        if limit is None:
+            problems.append(
+                f"{name}: unexpected query, {stat.calls} calls, {stat.rows} rows"
+            )
+            continue
+        if stat.calls != limit.calls:
+            problems.append(f"{name}: {stat.calls} calls, expected {limit.calls}")
+        if limit.rows is not None and stat.rows > limit.rows:
+            problems.append(f"{name}: {stat.rows} rows, budget {limit.rows}")
+        if (
+            limit.blocks_per_call is not None
+            and stat.blocks_per_call > limit.blocks_per_call
+        ):
+            problems.append(
+                f"{name}: {stat.blocks_per_call:.1f} blocks per call, "
+                f"budget {limit.blocks_per_call} (missing index?)"
+            )
+    for name, limit in sorted(expected.items()):
+        if name not in stats and limit.calls:
+            problems.append(f"{name}: not executed, expected {limit.calls} calls")
+    assert not problems, f"{handler}: " + "; ".join(problems)
+
+
+def _check_budget(handler: str, differ, budget: dict | None) -> None:
+    if budget is None:
+        return
+    labels = {"handler": handler}
+    started = differ.value_at("started", labels, default=0)
+    assert started == 1, f"{handler}: started={started}, expected 1"
+    exceeded = differ.value_at("round-trips-exceeded", labels, default=0)
+    assert exceeded == 0, f"{handler}: round-trips-exceeded={exceeded}"
+    max_round_trips = budget.get("max-db-round-trips")
+    if max_round_trips:
+        round_trips = differ.value_at("db-round-trips", labels, default=0)
+        assert round_trips <= max_round_trips, (
+            f"{handler}: {round_trips} db round trips, "
+            f"max-db-round-trips {max_round_trips}"
+        )
+
+
+async def test_ping(service_client, measure):
+    response = await measure(
+        "handler-ping", lambda: service_client.get("/ping"), {}
+    )
+    assert response.status == 200
+
+
+@pytest.mark.parametrize(
+    "params",
+    [
+        {"n": "20"},
+        {"n": "20", "offset": "100", "sort_order": "date_asc"},
+        {"n": "20", "sort_order": "price_desc", "category": "Йога"},
+        {"n": "20", "sort_order": "popular"},
+        {"n": "20", "q": "керамика"},
+    ],
+)
+async def test_mclist_served_from_catalog(service_client, catalog, measure, params):
+    response = await measure(
+        "handler-mclist",
+        lambda: service_client.get("/mclist", params=params),
+        {},
+    )
+    assert response.status == 200, response.text
+
+
+async def test_mc_get_from_catalog(service_client, catalog, measure):
+    response = await measure(
+        "handler-mc-get",
+        lambda: service_client.get("/mc", params={"ids": "1,2,3,4,5"}),
+        {},
+    )
+    assert response.status == 200, response.text
+
+
+async def test_mc_get_misses_in_one_query(service_client, catalog, measure):
+    response = await measure(
+        "handler-mc-get",
+        lambda: service_client.get("/mc", params={"ids": "1,999998,999999"}),
+        {"select-masterclasses-by-ids": Limit(calls=1, rows=2)},
+    )
+    assert response.status == 200, response.text
+
+
+async def test_similar_and_suggest(service_client, catalog, measure):
+    response = await measure(
+        "handler-mc-similar",
+        lambda: service_client.get("/mc/similar", params={"id": "1", "k": "10"}),
+        {},
+    )
+    assert response.status == 200, response.text
+    response = await measure(
+        "handler-suggest",
+        lambda: service_client.get("/suggest", params={"prefix": "Кер", "n": "10"}),
+        {},
+    )
+    assert response.status == 200, response.text
+
+
+async def test_mclist_changes(service_client, catalog, measure):
+    response = await measure(
+        "handler-mclist-changes",
+        lambda: service_client.get("/mclist/changes", params={"since": "0"}),
+        {},
+    )
+    assert response.status == 200, response.text
+
+
+async def test_mcexport(service_client, catalog, measure):
+    response = await measure(
+        "handler-mcexport", lambda: service_client.get("/mcexport"), {}
+    )
+    assert response.status == 200, response.text
+
+    # Архива в каталоге нет: include_past - один курсор по Postgres, сколько
+    # бы пачек он ни отдал.
+    response = await measure(
+        "handler-mcexport",
+        lambda: service_client.get("/mcexport", params={"include_past": "1"}),
+        {"select-all-masterclasses-with-archive": Limit(calls=1, rows=CATALOG_SIZE)},
+    )
+    assert response.status == 200, response.text
+
+
+async def test_mcadd_and_mcdelete(service_client, catalog, measure):
+    response = await measure(
+        "handler-mcadd",
+        lambda: service_client.post(
+            "/mcadd",
+            json={
+                "id": CATALOG_SIZE + 1,
+                "title": "Гончарный круг",
+                "image_url": "https://img.example/new.jpg",
+                "price": 1500,
+            },
+        ),
+        {"insert-masterclass": Limit(calls=1, rows=1)},
+    )
+    assert response.status == 201, response.text
+
+    response = await measure(
+        "handler-mcdelete",
+        lambda: service_client.delete("/mcdelete", params={"id": str(CATALOG_SIZE + 1)}),
+        {"delete-masterclass": Limit(calls=1, rows=1)},
+    )
+    assert response.status == 200, response.text
+
+
+async def test_mcsync_unchanged_file(service_client, catalog, measure):
+    response = await measure(
+        "handler-mcsync",
+        lambda: service_client.post(
+            "/mcsync",
+            data=_catalog_csv(CATALOG_SIZE),
+            headers={"Content-Type": "text/csv"},
+        ),
+        {
+            "lock-masterclass-sync": Limit(calls=1),
+            "select-masterclass-source-hashes": Limit(calls=1, rows=CATALOG_SIZE),
+        },
+    )
+    assert response.status == 200, response.text
+    assert response.json()["unchanged"] == CATALOG_SIZE
+
+
+async def test_mcsync_upserts_in_batches(service_client, pgsql, measure):
+    pgsql[DB_NAME].cursor().execute("DELETE FROM masterclasses")
+    response = await measure(
+        "handler-mcsync",
+        lambda: service_client.post(
+            "/mcsync",
+            data=_catalog_csv(CATALOG_SIZE),
+            headers={"Content-Type": "text/csv"},
+        ),
+        {
+            "lock-masterclass-sync": Limit(calls=1),
+            "select-masterclass-source-hashes": Limit(calls=1, rows=0),
+            "upsert-masterclasses-from-source-batch": Limit(
+                calls=math.ceil(CATALOG_SIZE / UPSERT_BATCH_SIZE),
+                rows=CATALOG_SIZE,
+            ),
+        },
+    )
+    assert response.status == 200, response.text
+    assert response.json()["inserted"] == CATALOG_SIZE
+
+
+async def test_register_uses_phone_index(
+    service_client, filler_users, unique_phone, measure
+):
+    response = await measure(
+        "handler-auth-register",
+        lambda: service_client.post(
+            "/register",
+            json={
+                "phone": unique_phone,
+                "full_name": "Test User",
+                "password": PASSWORD,
+            },
+        ),
+        {
+            "exists-user-by-phone": Limit(
+                calls=1, rows=1, blocks_per_call=MAX_INDEX_LOOKUP_BLOCKS
+            ),
+            "insert-user": Limit(calls=1, rows=1),
+        },
+    )
+    assert response.status == 201, response.text
+
+
+async def test_login_uses_phone_index(service_client, filler_users, user, measure):
+    response = await measure(
+        "handler-auth-login",
+        lambda: service_client.post(
+            "/login", json={"phone": user.phone, "password": PASSWORD}
+        ),
+        {
+            "select-user-by-phone": Limit(
+                calls=1, rows=1, blocks_per_call=MAX_INDEX_LOOKUP_BLOCKS
+            ),
+        },
+    )
+    assert response.status == 200, response.text
+
+
+async def test_profile(service_client, user, measure):
+    response = await measure(
+        "handler-user-profile",
+        lambda: service_client.get(
+            "/user/profile", params={"user_id": user.user_id}, headers=user.headers
+        ),
+        {"select-user-profile": Limit(calls=1, rows=1)},
+    )
+    assert response.status == 200, response.text
+
+
+async def test_favorites(service_client, catalog, user, measure):
+    response = await measure(
+        "handler-user-favorites",
+        lambda: service_client.post(
+            "/user/favorites",
+            json={"user_id": user.user_id, "masterclass_id": 1},
+            headers=user.headers,
+        ),
+        {"insert-favorite": Limit(calls=1, rows=1)},
+    )
+    assert response.status == 201, response.text
+
+    response = await measure(
+        "handler-user-favorites",
+        lambda: service_client.get(
+            "/user/favorites", params={"user_id": user.user_id}, headers=user.headers
+        ),
+        {
+            "select-favorites": Limit(calls=1, rows=1),
+            "select-masterclasses-by-ids": Limit(calls=1, rows=1),
+        },
+    )
+    assert response.status == 200, response.text
+
+    response = await measure(
+        "handler-user-favorites",
+        lambda: service_client.delete(
+            "/user/favorites",
+            params={"user_id": user.user_id, "masterclass_id": "1"},
+            headers=user.headers,
+        ),
+        {"delete-favorite": Limit(calls=1, rows=1)},
+    )
+    assert response.status == 200, response.text
+
+
+async def test_userdelete_then_status_and_login(service_client, user, measure):
+    response = await measure(
+        "handler-userdelete",
+        lambda: service_client.delete(
+            "/userdelete", params={"user_id": user.user_id}, headers=user.headers
+        ),
+        {
+            "enqueue-user-purge": Limit(calls=1, rows=1),
+            "upsert-session-revocation": Limit(calls=1, rows=1),
+        },
+    )
+    assert response.status == 202, response.text
+    job_id = response.json()["job_id"]
+
+    response = await measure(
+        "handler-userdelete-status",
+        lambda: service_client.get(
+            "/userdelete/status",
+            params={"job_id": job_id, "user_id": user.user_id},
+            headers=user.headers,
+        ),
+        {"select-user-purge-job": Limit(calls=1, rows=1)},
+    )
+    assert response.status == 200, response.text
+
+    # Пока задача не завершена, select-user-by-phone не находит пользователя.
+    response = await measure(
+        "handler-auth-login",
+        lambda: service_client.post(
+            "/login", json={"phone": user.phone, "password": PASSWORD}
+        ),
+        {"select-user-by-phone": Limit(calls=1, rows=0)},
+    )
+    assert response.status == 401, response.text
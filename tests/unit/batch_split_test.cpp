@@ -0,0 +1,131 @@
+#include "utils/batch_split.hpp"
+
+#include <algorithm>
+#include <exception>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace masterclasses::utils {
+
+namespace {
+
+class Unavailable : public std::runtime_error {
+  public:
+    Unavailable() : std::runtime_error("unavailable") {}
+};
+
+/// Пишет пакет целиком или ничего, как транзакция: бросает, если в пакете
+/// есть плохой элемент.
+struct FakeStorage {
+    std::vector<int> bad;
+    bool unavailable{false};
+    std::vector<int> written;
+    int writes{0};
+
+    void Write(std::span<const int> batch) {
+        ++writes;
+        if (unavailable) {
+            throw Unavailable{};
+        }
+        for (const auto item : batch) {
+            if (std::find(bad.begin(), bad.end(), item) != bad.end()) {
+                throw std::runtime_error("bad item " + std::to_string(item));
+            }
+        }
+        written.insert(written.end(), batch.begin(), batch.end());
+    }
+};
+
+struct Failures {
+    std::vector<int> items;
+    std::vector<std::string> messages;
+    int calls{0};
+};
+
+Failures Run(FakeStorage& storage, const std::vector<int>& batch) {
+    Failures failures;
+    WriteOrSplit(
+        std::span<const int>(batch),
+        [&](std::span<const int> part) { storage.Write(part); },
+        [](const std::exception& ex) {
+            return dynamic_cast<const Unavailable*>(&ex) == nullptr;
+        },
+        [&](std::span<const int> part, const std::exception& ex) {
+            ++failures.calls;
+            failures.items.insert(failures.items.end(), part.begin(),
+                                  part.end());
+            failures.messages.emplace_back(ex.what());
+            CHECK(std::current_exception() != nullptr);
+        });
+    std::sort(storage.written.begin(), storage.written.end());
+    return failures;
+}
+
+}  // namespace
+
+TEST_CASE("WriteOrSplit writes a good batch in one call", "[batch_split]") {
+    FakeStorage storage;
+    const auto failures = Run(storage, {1, 2, 3, 4});
+    CHECK(storage.writes == 1);
+    CHECK(storage.written == std::vector<int>{1, 2, 3, 4});
+    CHECK(failures.calls == 0);
+}
+
+TEST_CASE("WriteOrSplit isolates a bad item", "[batch_split]") {
+    FakeStorage storage;
+    storage.bad = {6};
+    const auto failures = Run(storage, {1, 2, 3, 4, 5, 6, 7, 8});
+
+    CHECK(storage.written == std::vector<int>{1, 2, 3, 4, 5, 7, 8});
+    CHECK(failures.items == std::vector<int>{6});
+    CHECK(failures.messages == std::vector<std::string>{"bad item 6"});
+    // 8 -> 4 + 4 -> 2 + 2 -> 1 + 1: семь вызовов, а не восемь поодиночке.
+    CHECK(storage.writes == 7);
+}
+
+TEST_CASE("WriteOrSplit isolates several bad items", "[batch_split]") {
+    FakeStorage storage;
+    storage.bad = {1, 8};
+    const auto failures = Run(storage, {1, 2, 3, 4, 5, 6, 7, 8});
+
+    CHECK(storage.written == std::vector<int>{2, 3, 4, 5, 6, 7});
+    CHECK(failures.items == std::vector<int>{1, 8});
+    CHECK(failures.calls == 2);
+}
+
+TEST_CASE("WriteOrSplit does not split on unsplittable errors",
+          "[batch_split]") {
+    FakeStorage storage;
+    storage.unavailable = true;
+    const auto failures = Run(storage, {1, 2, 3, 4, 5, 6, 7, 8});
+
+    CHECK(storage.writes == 1);
+    CHECK(storage.written.empty());
+    CHECK(failures.calls == 1);
+    CHECK(failures.items == std::vector<int>{1, 2, 3, 4, 5, 6, 7, 8});
+    CHECK(failures.messages == std::vector<std::string>{"unavailable"});
+}
+
+TEST_CASE("WriteOrSplit fails a single item without retrying",
+          "[batch_split]") {
+    FakeStorage storage;
+    storage.bad = {5};
+    const auto failures = Run(storage, {5});
+
+    CHECK(storage.writes == 1);
+    CHECK(storage.written.empty());
+    CHECK(failures.items == std::vector<int>{5});
+}
+
+TEST_CASE("WriteOrSplit skips an empty batch", "[batch_split]") {
+    FakeStorage storage;
+    const auto failures = Run(storage, {});
+    CHECK(storage.writes == 0);
+    CHECK(failures.calls == 0);
+}
+
+}  // namespace masterclasses::utils
@@ -0,0 +1,100 @@
+#include "catalog/change_log.hpp"
+
+#include <cstdint>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace masterclasses::catalog {
+
+using Ids = std::vector<std::int64_t>;
+
+TEST_CASE("ChangeLog merges touched ids since a version", "[change_log]") {
+    ChangeLog log(10);
+    log.Record(1, {});
+    log.Record(2, {5, 3});
+    log.Record(3, {3, 7});
+    log.Record(4, {1});
+    REQUIRE(log.Version() == 4);
+
+    auto changes = log.Since(1);
+    CHECK_FALSE(changes.resync);
+    CHECK(changes.version == 4);
+    CHECK(changes.touched == Ids{1, 3, 5, 7});
+
+    changes = log.Since(2);
+    CHECK_FALSE(changes.resync);
+    CHECK(changes.touched == Ids{1, 3, 7});
+
+    changes = log.Since(4);
+    CHECK_FALSE(changes.resync);
+    CHECK(changes.version == 4);
+    CHECK(changes.touched.empty());
+}
+
+TEST_CASE("ChangeLog skips versions without changes", "[change_log]") {
+    ChangeLog log(10);
+    log.Record(1, {});
+    log.Record(2, {4});
+    log.Record(3, {});
+    log.Record(4, {});
+
+    const auto changes = log.Since(3);
+    CHECK_FALSE(changes.resync);
+    CHECK(changes.version == 4);
+    CHECK(changes.touched.empty());
+    CHECK(log.Since(1).touched == Ids{4});
+}
+
+TEST_CASE("ChangeLog asks for a resync when it does not cover since",
+          "[change_log]") {
+    ChangeLog log(2);
+    log.Record(1, {});
+    log.Record(2, {1});
+    log.Record(3, {2});
+    log.Record(4, {3});
+
+    SECTION("client is too far behind") {
+        // Версия 2 вытеснена: журнал помнит только 3 и 4.
+        CHECK(log.Since(1).resync);
+        CHECK(log.Since(0).resync);
+        const auto changes = log.Since(2);
+        CHECK_FALSE(changes.resync);
+        CHECK(changes.touched == Ids{2, 3});
+    }
+
+    SECTION("client is ahead of the log") {
+        const auto changes = log.Since(5);
+        CHECK(changes.resync);
+        CHECK(changes.version == 4);
+        CHECK(changes.touched.empty());
+    }
+}
+
+TEST_CASE("ChangeLog starts over after a rebuild", "[change_log]") {
+    ChangeLog log(10);
+    log.Record(1, {});
+    log.Record(2, {1});
+    log.Record(3, {2});
+
+    // Снимок собран заново: версии пошли с начала.
+    log.Record(1, {});
+    CHECK(log.Version() == 1);
+    CHECK(log.Since(2).resync);
+    CHECK(log.Since(0).resync);
+    CHECK_FALSE(log.Since(1).resync);
+
+    log.Record(2, {9});
+    const auto changes = log.Since(1);
+    CHECK_FALSE(changes.resync);
+    CHECK(changes.touched == Ids{9});
+}
+
+TEST_CASE("ChangeLog of a fresh catalog", "[change_log]") {
+    ChangeLog log(10);
+    CHECK(log.Version() == 0);
+    CHECK_FALSE(log.Since(0).resync);
+    CHECK(log.Since(1).resync);
+}
+
+}  // namespace masterclasses::catalog
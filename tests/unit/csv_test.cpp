@@ -0,0 +1,55 @@
+#include "utils/csv.hpp"
+
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace masterclasses::utils {
+
+using Fields = std::vector<std::string>;
+
+TEST_CASE("CsvReader splits plain records", "[csv]") {
+    CsvReader reader("id,title\n1,Йога\n");
+    Fields fields;
+    REQUIRE(reader.Next(fields));
+    CHECK(fields == Fields{"id", "title"});
+    CHECK(reader.Line() == 1);
+    REQUIRE(reader.Next(fields));
+    CHECK(fields == Fields{"1", "Йога"});
+    CHECK(reader.Line() == 2);
+    CHECK_FALSE(reader.Next(fields));
+}
+
+TEST_CASE("CsvReader handles quotes like csv.reader", "[csv]") {
+    CsvReader reader("1,\"a, b\",\"say \"\"hi\"\"\",\"two\nlines\"\n2,x,,\n");
+    Fields fields;
+    REQUIRE(reader.Next(fields));
+    CHECK(fields == Fields{"1", "a, b", "say \"hi\"", "two\nlines"});
+    REQUIRE(reader.Next(fields));
+    // Запись после поля с переводом строки начинается с третьей строки.
+    CHECK(reader.Line() == 3);
+    CHECK(fields == Fields{"2", "x", "", ""});
+}
+
+TEST_CASE("CsvReader drops BOM, CR and empty lines", "[csv]") {
+    CsvReader reader("\xEF\xBB\xBFid\r\n\r\n\n1\r\n2");
+    Fields fields;
+    REQUIRE(reader.Next(fields));
+    CHECK(fields == Fields{"id"});
+    REQUIRE(reader.Next(fields));
+    CHECK(fields == Fields{"1"});
+    CHECK(reader.Line() == 4);
+    REQUIRE(reader.Next(fields));
+    CHECK(fields == Fields{"2"});
+    CHECK_FALSE(reader.Next(fields));
+}
+
+TEST_CASE("CsvReader on empty text", "[csv]") {
+    CsvReader reader("\n\n");
+    Fields fields;
+    CHECK_FALSE(reader.Next(fields));
+    CHECK(fields.empty());
+}
+
+}  // namespace masterclasses::utils
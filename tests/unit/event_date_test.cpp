@@ -0,0 +1,35 @@
+#include "catalog/event_date.hpp"
+
+#include <cstdint>
+
+#include <catch2/catch.hpp>
+
+namespace masterclasses::catalog {
+
+TEST_CASE("ParseEventDay counts days from the epoch", "[event_date]") {
+    CHECK(ParseEventDay("1970-01-01") == 0);
+    CHECK(ParseEventDay("1969-12-31") == -1);
+    CHECK(ParseEventDay("2000-03-01") == 11017);
+    // Время после даты не мешает: Postgres отдаёт и timestamp.
+    CHECK(ParseEventDay("2024-02-29 10:00:00") == ParseEventDay("2024-02-29"));
+}
+
+TEST_CASE("ParseEventDay rejects non-ISO dates", "[event_date]") {
+    CHECK_FALSE(ParseEventDay(""));
+    CHECK_FALSE(ParseEventDay("2024-1-1"));
+    CHECK_FALSE(ParseEventDay("2024/01/01"));
+    CHECK_FALSE(ParseEventDay("2024-13-01"));
+    CHECK_FALSE(ParseEventDay("2024-01-00"));
+    CHECK_FALSE(ParseEventDay("01.02.2024"));
+    CHECK_FALSE(ParseEventDay("20x4-01-01"));
+}
+
+TEST_CASE("FormatEventDay inverts ParseEventDay", "[event_date]") {
+    CHECK(FormatEventDay(0) == "1970-01-01");
+    CHECK(FormatEventDay(11017) == "2000-03-01");
+    for (std::int32_t day = -1000; day < 30000; day += 17) {
+        CHECK(ParseEventDay(FormatEventDay(day)) == day);
+    }
+}
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,51 @@
+#include "utils/id_set.hpp"
+
+#include <cstdint>
+#include <set>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace masterclasses::utils {
+
+TEST_CASE("IdSet basic operations", "[id_set]") {
+    IdSet set;
+    CHECK(set.Empty());
+    CHECK(set.Add(5));
+    CHECK_FALSE(set.Add(5));
+    CHECK(set.Add(1));
+    CHECK(set.Add(std::int64_t{1} << 40));
+    CHECK(set.Contains(5));
+    CHECK_FALSE(set.Contains(6));
+    CHECK(set.Contains(std::int64_t{1} << 40));
+    CHECK(set.Size() == 3);
+    CHECK(set.ToVector() ==
+          std::vector<std::int64_t>{1, 5, std::int64_t{1} << 40});
+}
+
+TEST_CASE("IdSet switches a dense chunk to a bitmap", "[id_set]") {
+    IdSet set;
+    std::set<std::int64_t> expected;
+    // Больше kArrayMaxSize значений в одном 16-битном чанке и немного в
+    // соседнем: массив должен превратиться в битовую карту без потерь.
+    for (std::int64_t id = 0; id < 10000; id += 2) {
+        set.Add(id);
+        expected.insert(id);
+    }
+    for (std::int64_t id = 70000; id < 70010; ++id) {
+        set.Add(id);
+        expected.insert(id);
+    }
+    CHECK(set.Size() == expected.size());
+    CHECK(set.ToVector() ==
+          std::vector<std::int64_t>(expected.begin(), expected.end()));
+    CHECK(set.Contains(9998));
+    CHECK_FALSE(set.Contains(9999));
+    CHECK_FALSE(set.Add(4));
+    // Плотный чанк - битовая карта на 8 КБ, массив на 5000 значений занял
+    // бы больше 10 КБ.
+    CHECK(set.MemoryUsageBytes() >= 8192);
+    CHECK(set.MemoryUsageBytes() < 10000);
+}
+
+}  // namespace masterclasses::utils
@@ -0,0 +1,107 @@
+#include "models/masterclass_csv.hpp"
+
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace masterclasses::models {
+
+namespace {
+
+std::vector<std::string> Row() {
+    return {"42",
+            "Гончарный круг",
+            "Лепим чашку",
+            "от 1 500 ₽",
+            "5.3.2030",
+            "Керамика",
+            "2 часа",
+            "Взрослые",
+            "https://img/1.jpg, https://img/2.jpg",
+            "глина",
+            "Студия Глина",
+            "example.com",
+            "@studio"};
+}
+
+}  // namespace
+
+TEST_CASE("ParseCsvMasterclass normalizes like import_data.py",
+          "[masterclass_csv]") {
+    const auto masterclass = ParseCsvMasterclass(Row());
+    REQUIRE(masterclass);
+    CHECK(masterclass->id == 42);
+    CHECK(masterclass->title == "Гончарный круг");
+    CHECK(masterclass->price == 1500.0);
+    CHECK(masterclass->event_date == "2030-03-05");
+    CHECK(masterclass->image_url == "https://img/1.jpg");
+    CHECK(masterclass->website == "https://example.com");
+    CHECK(masterclass->contact_tg == "@studio");
+    CHECK(masterclass->contact_vk.empty());
+    CHECK(masterclass->location == "Студия Глина");
+    CHECK(masterclass->format == "offline");
+    CHECK(masterclass->rating == 5.0);
+    CHECK_FALSE(masterclass->latitude.has_value());
+}
+
+TEST_CASE("ParseCsvMasterclass defaults", "[masterclass_csv]") {
+    auto row = Row();
+    row[3] = "бесплатно";
+    row[4] = "29.2.2031";
+    row[8] = "";
+    row[10] = "";
+    row.resize(11);
+    const auto masterclass = ParseCsvMasterclass(row);
+    REQUIRE(masterclass);
+    CHECK(masterclass->price == 0.0);
+    CHECK(masterclass->event_date.empty());
+    CHECK(masterclass->image_url == "https://via.placeholder.com/150");
+    CHECK(masterclass->website.empty());
+    CHECK(masterclass->location == "Moscow");
+}
+
+TEST_CASE("ParseCsvMasterclass skips incomplete rows", "[masterclass_csv]") {
+    auto row = Row();
+    row.resize(10);
+    CHECK_FALSE(ParseCsvMasterclass(row));
+
+    row = Row();
+    row[1] = "  ";
+    CHECK_FALSE(ParseCsvMasterclass(row));
+}
+
+TEST_CASE("ParseCsvMasterclass requires a positive id", "[masterclass_csv]") {
+    auto row = Row();
+    for (const auto* id : {"", "0", "-3", "12a", "abc"}) {
+        row[0] = id;
+        CHECK_THROWS_AS(ParseCsvMasterclass(row), std::invalid_argument);
+    }
+    row[0] = " 7 ";
+    CHECK(ParseCsvMasterclass(row)->id == 7);
+}
+
+TEST_CASE("ContentHash tracks every field", "[masterclass_csv]") {
+    const auto base = *ParseCsvMasterclass(Row());
+    CHECK(ContentHash(base) == ContentHash(base));
+
+    auto changed = base;
+    changed.contact_phone = "+7";
+    CHECK(ContentHash(changed) != ContentHash(base));
+
+    changed = base;
+    changed.latitude = 0.0;
+    CHECK(ContentHash(changed) != ContentHash(base));
+
+    // Граница между соседними строковыми полями учитывается.
+    auto left = base;
+    auto right = base;
+    left.contact_tg = "ab";
+    left.contact_vk = "c";
+    right.contact_tg = "a";
+    right.contact_vk = "bc";
+    CHECK(ContentHash(left) != ContentHash(right));
+}
+
+}  // namespace masterclasses::models
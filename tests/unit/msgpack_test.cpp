@@ -0,0 +1,89 @@
+#include "utils/msgpack.hpp"
+
+#include <cstdint>
+#include <limits>
+#include <optional>
+#include <string>
+
+#include <catch2/catch.hpp>
+
+#include <userver/formats/json/serialize.hpp>
+
+namespace masterclasses::utils {
+
+namespace {
+
+template <typename Fill>
+std::string Encode(Fill fill) {
+    MsgPackWriter writer;
+    fill(writer);
+    return writer.Extract();
+}
+
+std::string Bytes(std::initializer_list<unsigned> bytes) {
+    std::string result;
+    for (const auto byte : bytes) {
+        result.push_back(static_cast<char>(byte));
+    }
+    return result;
+}
+
+}  // namespace
+
+TEST_CASE("MsgPackWriter picks the shortest integer form", "[msgpack]") {
+    const auto encode = [](std::int64_t value) {
+        return Encode([value](MsgPackWriter& w) { w.WriteInt(value); });
+    };
+    CHECK(encode(0) == Bytes({0x00}));
+    CHECK(encode(127) == Bytes({0x7F}));
+    CHECK(encode(200) == Bytes({0xCC, 0xC8}));
+    CHECK(encode(0x1234) == Bytes({0xCD, 0x12, 0x34}));
+    CHECK(encode(0x12345678) == Bytes({0xCE, 0x12, 0x34, 0x56, 0x78}));
+    CHECK(encode(std::int64_t{1} << 32) ==
+          Bytes({0xCF, 0, 0, 0, 1, 0, 0, 0, 0}));
+    CHECK(encode(-1) == Bytes({0xFF}));
+    CHECK(encode(-32) == Bytes({0xE0}));
+    CHECK(encode(-33) == Bytes({0xD0, 0xDF}));
+    CHECK(encode(-300) == Bytes({0xD1, 0xFE, 0xD4}));
+    CHECK(encode(-70000) == Bytes({0xD2, 0xFF, 0xFE, 0xEE, 0x90}));
+    CHECK(encode(std::numeric_limits<std::int64_t>::min()) ==
+          Bytes({0xD3, 0x80, 0, 0, 0, 0, 0, 0, 0}));
+}
+
+TEST_CASE("MsgPackWriter scalars and headers", "[msgpack]") {
+    CHECK(Encode([](MsgPackWriter& w) { w.WriteNil(); }) == Bytes({0xC0}));
+    CHECK(Encode([](MsgPackWriter& w) { w.WriteBool(true); }) ==
+          Bytes({0xC3}));
+    CHECK(Encode([](MsgPackWriter& w) { w.WriteDouble(1.0); }) ==
+          Bytes({0xCB, 0x3F, 0xF0, 0, 0, 0, 0, 0, 0}));
+    CHECK(Encode([](MsgPackWriter& w) {
+              w.Write(std::optional<double>{});
+          }) == Bytes({0xC0}));
+    CHECK(Encode([](MsgPackWriter& w) { w.WriteArrayHeader(3); }) ==
+          Bytes({0x93}));
+    CHECK(Encode([](MsgPackWriter& w) { w.WriteArrayHeader(16); }) ==
+          Bytes({0xDC, 0x00, 0x10}));
+    CHECK(Encode([](MsgPackWriter& w) { w.WriteMapHeader(2); }) ==
+          Bytes({0x82}));
+}
+
+TEST_CASE("MsgPackWriter strings", "[msgpack]") {
+    CHECK(Encode([](MsgPackWriter& w) { w.WriteString("ab"); }) ==
+          Bytes({0xA2}) + "ab");
+    const std::string medium(40, 'x');
+    CHECK(Encode([&](MsgPackWriter& w) { w.WriteString(medium); }) ==
+          Bytes({0xD9, 40}) + medium);
+    const std::string large(300, 'y');
+    CHECK(Encode([&](MsgPackWriter& w) { w.WriteString(large); }) ==
+          Bytes({0xDA, 0x01, 0x2C}) + large);
+}
+
+TEST_CASE("MsgPackWriter JSON values", "[msgpack]") {
+    const auto json =
+        userver::formats::json::FromString(R"({"a":[1,null,true,"b"]})");
+    CHECK(Encode([&](MsgPackWriter& w) { w.WriteJson(json); }) ==
+          Bytes({0x81, 0xA1}) + "a" + Bytes({0x94, 0x01, 0xC0, 0xC3, 0xA1}) +
+              "b");
+}
+
+}  // namespace masterclasses::utils
@@ -0,0 +1,107 @@
+#include "catalog/snapshot_file.hpp"
+
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <unistd.h>
+
+#include <catch2/catch.hpp>
+
+namespace masterclasses::catalog {
+
+namespace {
+
+class TempFile {
+  public:
+    explicit TempFile(const std::string& name)
+        : path_(std::filesystem::temp_directory_path() /
+                (name + "-" + std::to_string(::getpid()))) {}
+    ~TempFile() { std::filesystem::remove(path_); }
+
+    std::string Path() const { return path_.string(); }
+
+    std::string Read() const {
+        std::ifstream in(path_, std::ios::binary);
+        return {std::istreambuf_iterator<char>(in), {}};
+    }
+
+    void Write(const std::string& bytes) const {
+        std::ofstream(path_, std::ios::binary | std::ios::trunc) << bytes;
+    }
+
+  private:
+    std::filesystem::path path_;
+};
+
+CatalogSnapshot MakeSnapshot() {
+    CatalogSnapshot snapshot;
+    for (std::int64_t id = 1; id <= 3; ++id) {
+        models::Masterclass masterclass;
+        masterclass.id = id;
+        masterclass.title = "Мастер-класс " + std::to_string(id);
+        masterclass.price = 500.0 * id;
+        masterclass.min_age = static_cast<int>(id);
+        masterclass.event_date =
+            id == 2 ? "" : "2030-01-0" + std::to_string(id);
+        if (id == 2) {
+            masterclass.latitude = 55.75;
+            masterclass.longitude = 37.61;
+        }
+        snapshot.rows.push_back(
+            std::make_shared<const models::Masterclass>(masterclass));
+    }
+    return snapshot;
+}
+
+}  // namespace
+
+TEST_CASE("Snapshot file round trip", "[snapshot_file]") {
+    const TempFile file("snapshot-round-trip");
+    const auto snapshot = MakeSnapshot();
+    WriteSnapshotFile(snapshot, file.Path());
+
+    const auto rows = ReadSnapshotFile(file.Path());
+    REQUIRE(rows.size() == snapshot.rows.size());
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        CHECK(*rows[i] == *snapshot.rows[i]);
+    }
+}
+
+TEST_CASE("Snapshot file of an empty catalog", "[snapshot_file]") {
+    const TempFile file("snapshot-empty");
+    WriteSnapshotFile(CatalogSnapshot{}, file.Path());
+    CHECK(ReadSnapshotFile(file.Path()).empty());
+}
+
+TEST_CASE("Snapshot file rejects damaged files", "[snapshot_file]") {
+    const TempFile file("snapshot-damaged");
+    WriteSnapshotFile(MakeSnapshot(), file.Path());
+    const auto bytes = file.Read();
+    REQUIRE(bytes.size() > 64);
+
+    SECTION("flipped byte in the body") {
+        auto damaged = bytes;
+        damaged[damaged.size() - 3] ^= 0x5A;
+        file.Write(damaged);
+        CHECK_THROWS_AS(ReadSnapshotFile(file.Path()), std::runtime_error);
+    }
+    SECTION("truncated") {
+        file.Write(bytes.substr(0, bytes.size() / 2));
+        CHECK_THROWS_AS(ReadSnapshotFile(file.Path()), std::runtime_error);
+    }
+    SECTION("not a snapshot") {
+        file.Write(std::string(bytes.size(), 'x'));
+        CHECK_THROWS_AS(ReadSnapshotFile(file.Path()), std::runtime_error);
+    }
+    SECTION("missing") {
+        std::filesystem::remove(file.Path());
+        CHECK_THROWS_AS(ReadSnapshotFile(file.Path()), std::runtime_error);
+    }
+}
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,168 @@
+#include "catalog/snapshot.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace masterclasses::catalog {
+
+namespace {
+
+const std::vector<std::string> kTitles = {
+    "Йога в парке", "Керамика для начинающих", "Гончарный круг",
+    "Акварель", "Йога и медитация", "Керамика: роспись"};
+const std::vector<std::string> kCategories = {"Йога", "Керамика",
+                                              "Живопись"};
+
+MasterclassPtr Row(std::int64_t id, std::string title, double price,
+                   std::string category = "Йога",
+                   std::string event_date = "2030-01-01") {
+    models::Masterclass masterclass;
+    masterclass.id = id;
+    masterclass.title = std::move(title);
+    masterclass.price = price;
+    masterclass.category = std::move(category);
+    masterclass.event_date = std::move(event_date);
+    return std::make_shared<const models::Masterclass>(masterclass);
+}
+
+MasterclassPtr RandomRow(std::int64_t id, std::mt19937& random) {
+    const auto day = random() % 6;
+    return Row(id, kTitles[random() % kTitles.size()],
+               static_cast<double>(random() % 5) * 100.0,
+               kCategories[random() % kCategories.size()],
+               day == 0 ? "" : "2030-01-0" + std::to_string(day));
+}
+
+std::vector<std::int64_t> SearchIds(const CatalogSnapshot& snapshot,
+                                    std::string_view query) {
+    std::vector<std::int64_t> ids;
+    for (const auto& hit : snapshot.text_index->Search(query)) {
+        ids.push_back(hit.id);
+    }
+    return ids;
+}
+
+/// Снимок после Apply должен быть неотличим от построенного с нуля.
+void RequireSameAsBuilt(const CatalogSnapshot& applied,
+                        const CatalogSnapshot& built) {
+    REQUIRE(applied.ids == built.ids);
+    REQUIRE(applied.rows.size() == built.rows.size());
+    for (std::size_t i = 0; i < built.rows.size(); ++i) {
+        CHECK(*applied.rows[i] == *built.rows[i]);
+    }
+
+    for (const auto& query : {"йога", "керамика", "круг", "акварель"}) {
+        CHECK(SearchIds(applied, query) == SearchIds(built, query));
+    }
+    CHECK(applied.text_index->DocumentCount() ==
+          built.text_index->DocumentCount());
+
+    for (std::size_t key = 0; key < kSortKeyCount; ++key) {
+        CHECK(applied.permutations->Get(key) == built.permutations->Get(key));
+    }
+
+    REQUIRE(applied.columns->Size() == built.columns->Size());
+    REQUIRE(applied.features->Size() == built.features->Size());
+    constexpr auto kCategory = ColumnStore::Column::kCategory;
+    for (std::size_t row = 0; row < built.rows.size(); ++row) {
+        CHECK(applied.columns->Dictionary(kCategory).Get(
+                  applied.columns->CodeAt(kCategory, row)) ==
+              built.columns->Dictionary(kCategory).Get(
+                  built.columns->CodeAt(kCategory, row)));
+        CHECK(applied.columns->PriceAt(row) == built.columns->PriceAt(row));
+        CHECK(applied.columns->DayAt(row) == built.columns->DayAt(row));
+    }
+}
+
+}  // namespace
+
+TEST_CASE("CatalogSnapshot::Diff finds changed, added and erased rows",
+          "[snapshot]") {
+    const auto snapshot = CatalogSnapshot::Build({Row(3, "Акварель", 300),
+                                                  Row(1, "Йога", 100),
+                                                  Row(2, "Керамика", 200)});
+    REQUIRE(snapshot->ids == std::vector<std::int64_t>{1, 2, 3});
+
+    const std::vector<MasterclassPtr> fresh = {Row(1, "Йога", 100),
+                                               Row(2, "Керамика", 250),
+                                               Row(4, "Гончарный круг", 400)};
+    std::vector<MasterclassPtr> upserts;
+    std::vector<std::int64_t> erased;
+    snapshot->Diff(fresh, upserts, erased);
+
+    REQUIRE(upserts.size() == 2);
+    CHECK(upserts[0]->id == 2);
+    CHECK(upserts[0]->price == 250);
+    CHECK(upserts[1]->id == 4);
+    CHECK(erased == std::vector<std::int64_t>{3});
+
+    upserts.clear();
+    erased.clear();
+    snapshot->Diff(snapshot->rows, upserts, erased);
+    CHECK(upserts.empty());
+    CHECK(erased.empty());
+}
+
+TEST_CASE("CatalogSnapshot::Apply matches a snapshot built from scratch",
+          "[snapshot]") {
+    std::mt19937 random(11);
+    std::vector<MasterclassPtr> rows;
+    for (std::int64_t id = 1; id <= 40; ++id) {
+        rows.push_back(RandomRow(id, random));
+    }
+    auto snapshot = CatalogSnapshot::Build(rows);
+    const auto first_version = snapshot->version;
+
+    // Каждый раунд применяется к результату предыдущего: ошибка в
+    // перестановках или кодах столбцов накапливается и всплывает.
+    for (int round = 1; round <= 30; ++round) {
+        std::vector<MasterclassPtr> fresh;
+        for (const auto& row : snapshot->rows) {
+            const auto roll = random() % 10;
+            if (roll == 0) {
+                continue;  // удалена
+            }
+            fresh.push_back(roll == 1 ? RandomRow(row->id, random) : row);
+        }
+        for (int added = 0; added < 2; ++added) {
+            fresh.push_back(RandomRow(40 + round * 2 + added, random));
+        }
+
+        std::vector<MasterclassPtr> upserts;
+        std::vector<std::int64_t> erased;
+        snapshot->Diff(fresh, upserts, erased);
+        snapshot = snapshot->Apply(std::move(upserts), std::move(erased));
+
+        INFO("round " << round);
+        CHECK(snapshot->version == first_version + round);
+        RequireSameAsBuilt(*snapshot, *CatalogSnapshot::Build(fresh));
+    }
+}
+
+TEST_CASE("CatalogSnapshot::Apply leaves the source snapshot intact",
+          "[snapshot]") {
+    const auto before = CatalogSnapshot::Build(
+        {Row(1, "Йога в парке", 100), Row(2, "Керамика", 200, "Керамика")});
+    const auto after =
+        before->Apply({Row(1, "Акварель", 150, "Живопись")}, {2});
+
+    CHECK(SearchIds(*before, "йога") == std::vector<std::int64_t>{1});
+    CHECK(SearchIds(*before, "керамика") == std::vector<std::int64_t>{2});
+    CHECK(before->FindById(1)->title == "Йога в парке");
+    CHECK(before->columns->PriceAt(0) == 100);
+
+    CHECK(SearchIds(*after, "йога").empty());
+    CHECK(SearchIds(*after, "акварель") == std::vector<std::int64_t>{1});
+    CHECK(after->FindById(2) == nullptr);
+    CHECK(after->IndexOf(1) == 0);
+    CHECK(after->columns->PriceAt(0) == 150);
+}
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,96 @@
+#include "catalog/sort_keys.hpp"
+
+#include <cstdint>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace masterclasses::catalog {
+
+namespace {
+
+using MasterclassPtr = SortPermutations::MasterclassPtr;
+
+MasterclassPtr RandomRow(std::int64_t id, std::mt19937& random) {
+    models::Masterclass masterclass;
+    masterclass.id = id;
+    // Мало различных значений, чтобы было много равных ключей.
+    masterclass.price = static_cast<double>(random() % 5) * 100.0;
+    masterclass.rating = 1.0 + static_cast<double>(random() % 5);
+    const auto day = random() % 6;
+    masterclass.event_date =
+        day == 0 ? "" : "2030-01-0" + std::to_string(day);
+    return std::make_shared<const models::Masterclass>(masterclass);
+}
+
+}  // namespace
+
+TEST_CASE("SortPermutations::Build sorts by every key", "[sort_keys]") {
+    std::mt19937 random(7);
+    std::vector<MasterclassPtr> rows;
+    for (std::int64_t id = 1; id <= 50; ++id) {
+        rows.push_back(RandomRow(id, random));
+    }
+    const auto permutations = SortPermutations::Build(rows);
+    for (std::size_t key = 0; key < kSortKeyCount; ++key) {
+        const auto& order = permutations.Get(key);
+        REQUIRE(order.size() == rows.size());
+        for (std::size_t i = 1; i < order.size(); ++i) {
+            INFO(kSortKeys[key].name << " at " << i);
+            CHECK(kSortKeys[key].less(*rows[order[i - 1]], *rows[order[i]]));
+        }
+    }
+}
+
+TEST_CASE("SortPermutations::Merge matches a full rebuild", "[sort_keys]") {
+    std::mt19937 random(GENERATE(1, 2, 3, 4));
+    std::vector<MasterclassPtr> rows;
+    for (std::int64_t id = 1; id <= 200; ++id) {
+        rows.push_back(RandomRow(id * 2, random));
+    }
+    const auto before = SortPermutations::Build(rows);
+
+    // Новая версия: часть строк удалена, часть заменена, нечётные id -
+    // новые строки между старыми. rows остаются отсортированы по id.
+    std::vector<MasterclassPtr> fresh;
+    std::vector<std::int64_t> remap(rows.size(), -1);
+    std::vector<std::uint32_t> added;
+    for (std::size_t i = 0; i < rows.size(); ++i) {
+        const auto id = rows[i]->id;
+        if (random() % 7 == 0) {
+            fresh.push_back(RandomRow(id - 1, random));
+            added.push_back(static_cast<std::uint32_t>(fresh.size() - 1));
+        }
+        switch (random() % 6) {
+            case 0:
+                continue;
+            case 1:
+                fresh.push_back(RandomRow(id, random));
+                added.push_back(static_cast<std::uint32_t>(fresh.size() - 1));
+                continue;
+            default:
+                remap[i] = static_cast<std::int64_t>(fresh.size());
+                fresh.push_back(rows[i]);
+        }
+    }
+
+    const auto merged = before.Merge(fresh, remap, added);
+    const auto rebuilt = SortPermutations::Build(fresh);
+    for (std::size_t key = 0; key < kSortKeyCount; ++key) {
+        INFO(kSortKeys[key].name);
+        CHECK(merged.Get(key) == rebuilt.Get(key));
+    }
+}
+
+TEST_CASE("ParseSortOrder", "[sort_keys]") {
+    CHECK(ParseSortOrder("price_desc") == SortOrder::kPriceDesc);
+    CHECK(ParseSortOrder("popular") == SortOrder::kPopular);
+    CHECK_FALSE(ParseSortOrder("cheapest"));
+    CHECK(FindSortKey(SortOrder::kDateAsc) == std::size_t{0});
+    CHECK_FALSE(FindSortKey(SortOrder::kId));
+}
+
+}  // namespace masterclasses::catalog
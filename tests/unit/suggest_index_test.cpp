@@ -0,0 +1,88 @@
+#include "catalog/suggest_index.hpp"
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace masterclasses::catalog {
+
+namespace {
+
+MasterclassPtr Row(std::int64_t id, std::string title, std::string organizer,
+                   std::string category, std::string tags = {}) {
+    models::Masterclass masterclass;
+    masterclass.id = id;
+    masterclass.title = std::move(title);
+    masterclass.organizer = std::move(organizer);
+    masterclass.category = std::move(category);
+    masterclass.additional_tags = std::move(tags);
+    return std::make_shared<const models::Masterclass>(std::move(masterclass));
+}
+
+std::shared_ptr<const CatalogSnapshot> Catalog() {
+    return CatalogSnapshot::Build({
+        Row(1, "Гончарный круг", "Студия Глина", "Керамика", "глина, лепка"),
+        Row(2, "Гончарное дело", "Студия Глина", "Керамика"),
+        Row(3, "Йога в парке", "Йога-клуб", "Спорт"),
+    });
+}
+
+std::vector<std::string> Texts(
+    const std::vector<SuggestIndex::Suggestion>& suggestions) {
+    std::vector<std::string> texts;
+    for (const auto& suggestion : suggestions) {
+        texts.push_back(suggestion.text);
+    }
+    return texts;
+}
+
+}  // namespace
+
+TEST_CASE("SuggestIndex finds values by prefix", "[suggest_index]") {
+    const auto index = SuggestIndex::Build(*Catalog(), nullptr);
+
+    const auto organizers = index.Lookup("студ", 5, 0);
+    REQUIRE(organizers.size() == 1);
+    CHECK(organizers[0].text == "Студия Глина");
+    CHECK(organizers[0].kind == SuggestIndex::Kind::kOrganizer);
+    CHECK(organizers[0].weight == 2);
+
+    const auto words = index.Lookup("КРУ", 5, 0);
+    REQUIRE(words.size() == 1);
+    CHECK(words[0].text == "круг");
+    CHECK(words[0].kind == SuggestIndex::Kind::kWord);
+
+    CHECK(index.Lookup("лепк", 5, 0)[0].kind == SuggestIndex::Kind::kTag);
+    CHECK(index.Lookup("гонч", 1, 0).size() == 1);
+    CHECK(index.Lookup("гонч", 5, 0).size() == 2);
+    CHECK(index.Lookup("", 5, 0).empty());
+    CHECK(index.Lookup("xyz", 5, 0).empty());
+}
+
+TEST_CASE("SuggestIndex tolerates typos", "[suggest_index]") {
+    const auto index = SuggestIndex::Build(*Catalog(), nullptr);
+    CHECK(index.Lookup("гончр", 5, 0).empty());
+
+    const auto fuzzy = index.Lookup("гончр", 5, 1);
+    REQUIRE(fuzzy.size() == 2);
+    CHECK(fuzzy[0].edits == 1);
+}
+
+TEST_CASE("SuggestIndex weighs values by popularity", "[suggest_index]") {
+    const auto catalog = Catalog();
+    PopularityRanking ranking;
+    ranking.scores[1] = 3.6;
+    const auto index = SuggestIndex::Build(*catalog, &ranking);
+    const auto titles = index.Lookup("гонч", 5, 0);
+    CHECK(Texts(titles) ==
+          std::vector<std::string>{"Гончарный круг", "Гончарное дело"});
+    REQUIRE(titles.size() == 2);
+    CHECK(titles[0].weight == 5);
+    CHECK(titles[1].weight == 1);
+    // Организатор собирает вес обеих строк.
+    CHECK(index.Lookup("студ", 5, 0)[0].weight == 6);
+}
+
+}  // namespace masterclasses::catalog
@@ -0,0 +1,37 @@
+#include "catalog/text_normalizer.hpp"
+
+#include <string>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace masterclasses::catalog {
+
+using Terms = std::vector<std::string>;
+
+TEST_CASE("NormalizeText folds case, drops stop words and stems",
+          "[text_normalizer]") {
+    CHECK(NormalizeText("Йога для начинающих в ПАРКЕ") ==
+          Terms{"йог", "начинающ", "парк"});
+    CHECK(NormalizeText("Ёлочные игрушки") == Terms{"елочн", "игрушк"});
+    CHECK(NormalizeText("Yoga and the Pottery, 2024!") ==
+          Terms{"yoga", "pottery", "2024"});
+}
+
+TEST_CASE("NormalizeText keeps short stems whole", "[text_normalizer]") {
+    // Срезанное окончание оставило бы меньше трёх букв.
+    CHECK(NormalizeText("сок мыло") == Terms{"сок", "мыл"});
+    CHECK(NormalizeText("я у") == Terms{});
+}
+
+TEST_CASE("NormalizeText survives broken UTF-8", "[text_normalizer]") {
+    CHECK(NormalizeText("abc\xD0") == Terms{"abc"});
+    CHECK(NormalizeText("\xFF\xFEglass") == Terms{"glass"});
+}
+
+TEST_CASE("NormalizePhrase collapses separators", "[text_normalizer]") {
+    CHECK(NormalizePhrase("  Ёжик, в ТУМАНЕ!") == u"ежик в тумане");
+    CHECK(NormalizePhrase("--") == u"");
+}
+
+}  // namespace masterclasses::catalog
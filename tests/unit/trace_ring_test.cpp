@@ -0,0 +1,80 @@
+#include "utils/trace_ring.hpp"
+
+#include <atomic>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <catch2/catch.hpp>
+
+namespace masterclasses::utils {
+
+namespace {
+
+TraceSample Sample(std::uint32_t n) {
+    TraceSample sample;
+    sample.timestamp_ms = n;
+    sample.total_micros = n;
+    sample.response_bytes = n;
+    TraceSample::SetText(sample.handler, "handler-" + std::to_string(n));
+    return sample;
+}
+
+}  // namespace
+
+TEST_CASE("TraceSample text fields are truncated", "[trace_ring]") {
+    TraceSample::Stage stage;
+    TraceSample::SetText(stage.name, "abcdefghijklmnopqrstuvwxyz");
+    CHECK(TraceSample::Text(stage.name) == "abcdefghijklmno");
+    TraceSample::SetText(stage.name, "db");
+    CHECK(TraceSample::Text(stage.name) == "db");
+}
+
+TEST_CASE("TraceRing keeps the newest samples", "[trace_ring]") {
+    TraceRing ring(4);
+    CHECK(ring.Snapshot().empty());
+    for (std::uint32_t n = 0; n < 6; ++n) {
+        CHECK(ring.Push(Sample(n)));
+    }
+    CHECK(ring.Pushed() == 6);
+    CHECK(ring.Dropped() == 0);
+
+    const auto samples = ring.Snapshot();
+    REQUIRE(samples.size() == 4);
+    for (std::uint32_t i = 0; i < 4; ++i) {
+        CHECK(samples[i].total_micros == 5 - i);
+        CHECK(TraceSample::Text(samples[i].handler) ==
+              "handler-" + std::to_string(5 - i));
+    }
+}
+
+TEST_CASE("TraceRing readers never see torn samples", "[trace_ring]") {
+    TraceRing ring(8);
+    std::atomic<bool> stop{false};
+    std::vector<std::thread> writers;
+    for (std::uint32_t w = 0; w < 4; ++w) {
+        writers.emplace_back([&ring, &stop, w] {
+            for (std::uint32_t n = w; !stop.load(); n += 4) {
+                ring.Push(Sample(n));
+            }
+        });
+    }
+
+    std::size_t seen = 0;
+    for (int round = 0; round < 2000; ++round) {
+        for (const auto& sample : ring.Snapshot()) {
+            ++seen;
+            REQUIRE(sample.total_micros == sample.response_bytes);
+            REQUIRE(TraceSample::Text(sample.handler) ==
+                    "handler-" + std::to_string(sample.total_micros));
+        }
+    }
+    stop = true;
+    for (auto& writer : writers) {
+        writer.join();
+    }
+    CHECK(seen > 0);
+    CHECK(ring.Pushed() >= ring.Dropped());
+}
+
+}  // namespace masterclasses::utils